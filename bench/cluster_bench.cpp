@@ -0,0 +1,256 @@
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "cluster_coordinator.h"
+#include "cluster_worker.h"
+#include "offline_judge.h"
+#include "pipeline.h"
+
+#include "compilation_result.h"
+#include "execution_result.h"
+#include "submission_result.h"
+
+namespace {
+
+struct Options {
+    std::string           mode = "local";
+    std::filesystem::path solutions_dir = "bench/solutions";
+    std::filesystem::path work_dir = "bench_work";
+    std::filesystem::path output_file;
+    std::string           label;
+    std::string           host = "127.0.0.1";
+    std::string           bind = "127.0.0.1";
+    std::string           secret;
+    uint16_t              port = 0;
+    std::string           solution = "instant_exit";
+    size_t                workers = 2;
+    size_t                slots = 1;
+    size_t                submissions = 20;
+    size_t                tests = 10;
+    int                   kill_after_ms = -1;
+    int                   time_limit_sec = 1;
+    int                   memory_limit_mb = 512;
+};
+
+double ElapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::vector<oj::PipelineTestCase> PrepareTests(const Options& options, const std::filesystem::path& program) {
+    std::filesystem::path input_file = options.work_dir / (options.solution + ".in");
+    std::filesystem::path answer_file = options.work_dir / (options.solution + ".ans");
+    std::ofstream(input_file, std::ios::trunc).flush();
+
+    std::shared_ptr<oj::ExecutionResult> reference = oj::OfflineJudge::GetInstance().ExecuteWithFile(program, options.time_limit_sec, 0, options.memory_limit_mb, input_file);
+    std::ofstream answer(answer_file, std::ios::binary | std::ios::trunc);
+    answer << reference->output();
+    if (!answer.flush()) {
+        throw std::runtime_error("ERROR::ClusterBench: Failed to write a file " + answer_file.string() + ".");
+    }
+
+    return std::vector<oj::PipelineTestCase>(options.tests, {input_file, answer_file});
+}
+
+pid_t StartWorker(const Options& options, uint16_t port, size_t index) {
+    std::vector<std::string> args = {
+        "cluster_bench",
+        "--mode", "worker",
+        "--host", options.host,
+        "--port", std::to_string(port),
+        "--slots", std::to_string(options.slots),
+        "--work", (options.work_dir / ("worker_" + std::to_string(index))).string()
+    };
+    std::vector<char*> argv;
+    for (std::string& arg : args) {
+        argv.push_back(arg.data());
+    }
+    argv.push_back(nullptr);
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        throw std::runtime_error("ERROR::ClusterBench: Failed to fork a worker.");
+    }
+    if (pid == 0) {
+        execv("/proc/self/exe", argv.data());
+        _exit(EXIT_FAILURE);
+    }
+    return pid;
+}
+
+void RunWorker(const Options& options) {
+    oj::ClusterWorker worker(options.work_dir / "binaries", options.secret, options.slots);
+    worker.Run(options.host, options.port);
+}
+
+void RunCoordinator(const Options& options) {
+    oj::ClusterCoordinator coordinator(options.port, options.bind, options.secret);
+    std::cerr << "cluster_bench: listening on port " << coordinator.port() << std::endl;
+
+    std::vector<pid_t> workers;
+    if (options.mode == "local") {
+        for (size_t i = 0; i < options.workers; ++i) {
+            workers.push_back(StartWorker(options, coordinator.port(), i));
+        }
+    }
+    while (coordinator.workers() < options.workers) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    std::filesystem::path source = options.solutions_dir / (options.solution + ".cpp");
+    std::filesystem::path program = options.work_dir / options.solution;
+    std::filesystem::remove(program);
+    std::shared_ptr<oj::CompilationResult> compilation = oj::OfflineJudge::GetInstance().Compile(source, program, "g++", "-O2 -std=c++17");
+    if (!compilation->is_success()) {
+        throw std::runtime_error("ERROR::ClusterBench: Failed to compile " + source.string() + ".");
+    }
+    std::vector<oj::PipelineTestCase> tests = PrepareTests(options, program);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::future<std::shared_ptr<oj::SubmissionResult>>> results;
+    for (size_t i = 0; i < options.submissions; ++i) {
+        oj::PipelineSubmission submission;
+        submission.source = source;
+        submission.target = program;
+        submission.compiler = "g++";
+        submission.compile_options = "-O2 -std=c++17";
+        submission.time_limit_sec = options.time_limit_sec;
+        submission.time_limit_usec = 0;
+        submission.memory_limit_mb = options.memory_limit_mb;
+        submission.test_cases = tests;
+        results.push_back(coordinator.Submit(std::move(submission)));
+    }
+
+    if (options.kill_after_ms >= 0 && !workers.empty()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(options.kill_after_ms));
+        kill(workers.front(), SIGKILL);
+    }
+
+    size_t accepted = 0;
+    size_t failed = 0;
+    for (std::future<std::shared_ptr<oj::SubmissionResult>>& result : results) {
+        try {
+            accepted += result.get()->is_success() ? 1 : 0;
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            ++failed;
+        }
+    }
+    double elapsed_sec = ElapsedMs(start) / 1000.0;
+    size_t rescheduled = coordinator.rescheduled();
+    coordinator.Close();
+
+    for (pid_t worker : workers) {
+        kill(worker, SIGTERM);
+        waitpid(worker, nullptr, 0);
+    }
+
+    std::ostringstream report;
+    report << std::fixed << std::setprecision(3)
+           << "{\"label\":\"" << options.label << "\","
+           << "\"solution\":\"" << options.solution << "\","
+           << "\"workers\":" << options.workers << ","
+           << "\"slots\":" << options.slots << ","
+           << "\"submissions\":" << options.submissions << ","
+           << "\"tests\":" << options.tests << ","
+           << "\"accepted\":" << accepted << ","
+           << "\"failed\":" << failed << ","
+           << "\"rescheduled\":" << rescheduled << ","
+           << "\"elapsed_sec\":" << elapsed_sec << ","
+           << "\"tests_per_sec\":" << (elapsed_sec > 0.0 ? options.submissions * options.tests / elapsed_sec : 0.0) << "}\n";
+
+    if (options.output_file.empty()) {
+        std::cout << report.str();
+    } else {
+        std::ofstream out(options.output_file, std::ios::app);
+        if (!out.is_open()) {
+            throw std::runtime_error("ERROR::ClusterBench: Failed to open a file " + options.output_file.string() + ".");
+        }
+        out << report.str();
+    }
+}
+
+Options ParseOptions(int argc, char* argv[]) {
+    Options options;
+    if (const char* secret = getenv("OJ_CLUSTER_SECRET")) {
+        options.secret = secret;
+    }
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 == argc) {
+            throw std::invalid_argument("ERROR::ClusterBench: Missing a value for " + arg + ".");
+        }
+        std::string value = argv[++i];
+        if (arg == "--mode") {
+            if (value != "local" && value != "coordinator" && value != "worker") {
+                throw std::invalid_argument("ERROR::ClusterBench: Unknown mode " + value + ".");
+            }
+            options.mode = value;
+        } else if (arg == "--solutions") {
+            options.solutions_dir = value;
+        } else if (arg == "--work") {
+            options.work_dir = value;
+        } else if (arg == "--output") {
+            options.output_file = value;
+        } else if (arg == "--label") {
+            options.label = value;
+        } else if (arg == "--host") {
+            options.host = value;
+        } else if (arg == "--bind") {
+            options.bind = value;
+        } else if (arg == "--port") {
+            options.port = static_cast<uint16_t>(std::stoul(value));
+        } else if (arg == "--solution") {
+            options.solution = value;
+        } else if (arg == "--workers") {
+            options.workers = std::stoul(value);
+        } else if (arg == "--slots") {
+            options.slots = std::stoul(value);
+        } else if (arg == "--submissions") {
+            options.submissions = std::stoul(value);
+        } else if (arg == "--tests") {
+            options.tests = std::stoul(value);
+        } else if (arg == "--kill-after") {
+            options.kill_after_ms = std::stoi(value);
+        } else if (arg == "--time-limit") {
+            options.time_limit_sec = std::stoi(value);
+        } else if (arg == "--memory-limit") {
+            options.memory_limit_mb = std::stoi(value);
+        } else {
+            throw std::invalid_argument("ERROR::ClusterBench: Unknown option " + arg + ".");
+        }
+    }
+    return options;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        Options options = ParseOptions(argc, argv);
+        std::filesystem::create_directories(options.work_dir);
+        if (options.mode == "worker") {
+            RunWorker(options);
+        } else {
+            RunCoordinator(options);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
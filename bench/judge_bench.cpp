@@ -0,0 +1,288 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "offline_judge.h"
+
+#include "compilation_result.h"
+#include "execution_result.h"
+#include "judge_result.h"
+
+namespace {
+
+struct Solution {
+    std::string name;
+    std::string input;
+};
+
+struct SolutionReport {
+    std::string         name;
+    std::string         verdict;
+    double              compile_ms;
+    double              elapsed_sec;
+    size_t              submissions;
+    std::vector<double> execute_ms;
+    std::vector<double> judge_ms;
+    std::vector<double> total_ms;
+    std::vector<double> startup_us;
+};
+
+struct Options {
+    std::filesystem::path solutions_dir = "bench/solutions";
+    std::filesystem::path work_dir = "bench_work";
+    std::filesystem::path output_file;
+    std::string           label;
+    std::string           only;
+    std::string           profile = "default";
+    size_t                submissions = 20;
+    size_t                jobs = 1;
+    int                   time_limit_sec = 1;
+    int                   memory_limit_mb = 512;
+};
+
+double ElapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+double Percentile(std::vector<double> samples, double percentile) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    std::sort(samples.begin(), samples.end());
+    size_t index = static_cast<size_t>(percentile * (samples.size() - 1) + 0.5);
+    return samples[std::min(index, samples.size() - 1)];
+}
+
+long ReadStatusField(const char* field) {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, strlen(field), field) == 0) {
+            return std::strtol(line.c_str() + strlen(field), nullptr, 10);
+        }
+    }
+    return -1;
+}
+
+std::string StdinHeavyInput() {
+    std::string input;
+    input.reserve(64 * 1024 * 1024);
+    unsigned value = 12345;
+    while (input.size() < 64 * 1024 * 1024) {
+        value = value * 1103515245 + 12345;
+        input += std::to_string(value % 1000000000);
+        input += '\n';
+    }
+    return input;
+}
+
+std::vector<Solution> Corpus() {
+    return {
+        {"instant_exit", ""},
+        {"cpu_spin", ""},
+        {"memory_hog", ""},
+        {"large_output", ""},
+        {"stdin_heavy", StdinHeavyInput()},
+        {"segfault", ""},
+        {"fork_bomb", ""},
+        {"sleep", ""}
+    };
+}
+
+void WriteLatency(std::ostream& os, const char* name, const std::vector<double>& samples) {
+    os << "\"" << name << "\":{"
+       << "\"p50\":" << Percentile(samples, 0.50) << ","
+       << "\"p90\":" << Percentile(samples, 0.90) << ","
+       << "\"p99\":" << Percentile(samples, 0.99) << ","
+       << "\"max\":" << Percentile(samples, 1.00) << "}";
+}
+
+void WriteReport(std::ostream& os, const Options& options, const std::vector<SolutionReport>& reports, double elapsed_sec) {
+    size_t submissions = 0;
+    for (const SolutionReport& report : reports) {
+        submissions += report.submissions;
+    }
+
+    os << std::fixed << std::setprecision(3);
+    os << "{\"label\":\"" << options.label << "\","
+       << "\"jobs\":" << options.jobs << ","
+       << "\"profile\":\"" << options.profile << "\","
+       << "\"submissions\":" << submissions << ","
+       << "\"elapsed_sec\":" << elapsed_sec << ","
+       << "\"submissions_per_sec\":" << (elapsed_sec > 0.0 ? submissions / elapsed_sec : 0.0) << ","
+       << "\"judge_peak_rss_kb\":" << ReadStatusField("VmHWM:") << ","
+       << "\"judge_rss_kb\":" << ReadStatusField("VmRSS:") << ","
+       << "\"solutions\":[";
+    for (size_t i = 0; i < reports.size(); ++i) {
+        const SolutionReport& report = reports[i];
+        os << (i != 0 ? "," : "") << "{"
+           << "\"name\":\"" << report.name << "\","
+           << "\"verdict\":\"" << report.verdict << "\","
+           << "\"submissions\":" << report.submissions << ","
+           << "\"submissions_per_sec\":" << (report.elapsed_sec > 0.0 ? report.submissions / report.elapsed_sec : 0.0) << ","
+           << "\"compile_ms\":" << report.compile_ms << ",";
+        WriteLatency(os, "execute_ms", report.execute_ms);
+        os << ",";
+        WriteLatency(os, "judge_ms", report.judge_ms);
+        os << ",";
+        WriteLatency(os, "total_ms", report.total_ms);
+        os << ",";
+        WriteLatency(os, "startup_us", report.startup_us);
+        os << "}";
+    }
+    os << "]}\n";
+}
+
+oj::CompileProfile ParseProfile(const std::string& profile) {
+    if (profile == "default") {
+        return oj::CompileProfile::DEFAULT;
+    } else if (profile == "fast_startup") {
+        return oj::CompileProfile::FAST_STARTUP;
+    } else if (profile == "debug") {
+        return oj::CompileProfile::DEBUG;
+    }
+    throw std::invalid_argument("ERROR::JudgeBench: Unknown profile " + profile + ".");
+}
+
+SolutionReport RunSolution(const Options& options, const Solution& solution) {
+    oj::OfflineJudge& judge = oj::OfflineJudge::GetInstance();
+
+    SolutionReport report;
+    report.name = solution.name;
+    report.submissions = options.submissions;
+
+    std::filesystem::path source = options.solutions_dir / (solution.name + ".cpp");
+    std::filesystem::path program = options.work_dir / solution.name;
+    std::filesystem::remove(program);
+
+    auto compile_start = std::chrono::steady_clock::now();
+    std::shared_ptr<oj::CompilationResult> compilation = judge.CompileWithProfile(ParseProfile(options.profile), source, program, "g++", "-O2 -std=c++17");
+    report.compile_ms = ElapsedMs(compile_start);
+    if (!compilation->is_success()) {
+        throw std::runtime_error("ERROR::JudgeBench: Failed to compile " + source.string() + ".");
+    }
+
+    std::shared_ptr<oj::ExecutionResult> reference = judge.Execute(program, options.time_limit_sec, 0, options.memory_limit_mb, solution.input);
+    std::string answer = reference->output();
+    report.verdict = reference->is_success() ? "success" : "failure";
+
+    std::mutex mutex;
+    size_t next = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (size_t worker = 0; worker < std::max<size_t>(options.jobs, 1); ++worker) {
+        workers.emplace_back([&]() {
+            while (true) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (next == options.submissions) {
+                        return;
+                    }
+                    ++next;
+                }
+
+                auto execute_start = std::chrono::steady_clock::now();
+                std::shared_ptr<oj::ExecutionResult> execution = judge.Execute(program, options.time_limit_sec, 0, options.memory_limit_mb, solution.input);
+                double execute_ms = ElapsedMs(execute_start);
+
+                auto judge_start = std::chrono::steady_clock::now();
+                if (execution->is_success()) {
+                    judge.Judge(execution->output(), answer);
+                }
+                double judge_ms = ElapsedMs(judge_start);
+
+                std::lock_guard<std::mutex> lock(mutex);
+                report.execute_ms.push_back(execute_ms);
+                report.judge_ms.push_back(judge_ms);
+                report.total_ms.push_back(execute_ms + judge_ms);
+                report.startup_us.push_back(execution->startup_time_usec());
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    report.elapsed_sec = ElapsedMs(start) / 1000.0;
+    return report;
+}
+
+Options ParseOptions(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 == argc) {
+            throw std::invalid_argument("ERROR::JudgeBench: Missing a value for " + arg + ".");
+        }
+        std::string value = argv[++i];
+        if (arg == "--solutions") {
+            options.solutions_dir = value;
+        } else if (arg == "--work") {
+            options.work_dir = value;
+        } else if (arg == "--output") {
+            options.output_file = value;
+        } else if (arg == "--label") {
+            options.label = value;
+        } else if (arg == "--only") {
+            options.only = value;
+        } else if (arg == "--profile") {
+            ParseProfile(value);
+            options.profile = value;
+        } else if (arg == "--submissions") {
+            options.submissions = std::stoul(value);
+        } else if (arg == "--jobs") {
+            options.jobs = std::stoul(value);
+        } else if (arg == "--time-limit") {
+            options.time_limit_sec = std::stoi(value);
+        } else if (arg == "--memory-limit") {
+            options.memory_limit_mb = std::stoi(value);
+        } else {
+            throw std::invalid_argument("ERROR::JudgeBench: Unknown option " + arg + ".");
+        }
+    }
+    return options;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        Options options = ParseOptions(argc, argv);
+        std::filesystem::create_directories(options.work_dir);
+
+        std::vector<SolutionReport> reports;
+        auto start = std::chrono::steady_clock::now();
+        for (const Solution& solution : Corpus()) {
+            if (!options.only.empty() && solution.name != options.only) {
+                continue;
+            }
+            std::cerr << "judge_bench: " << solution.name << std::endl;
+            reports.push_back(RunSolution(options, solution));
+        }
+        double elapsed_sec = ElapsedMs(start) / 1000.0;
+
+        if (options.output_file.empty()) {
+            WriteReport(std::cout, options, reports, elapsed_sec);
+        } else {
+            std::ofstream out(options.output_file, std::ios::app);
+            if (!out.is_open()) {
+                throw std::runtime_error("ERROR::JudgeBench: Failed to open a file " + options.output_file.string() + ".");
+            }
+            WriteReport(out, options, reports, elapsed_sec);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,13 @@
+#include <cstdint>
+#include <cstdio>
+
+int main() {
+    uint64_t x = 88172645463325252ULL;
+    for (int i = 0; i < 400000000; ++i) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+    }
+    printf("%llu\n", static_cast<unsigned long long>(x));
+    return 0;
+}
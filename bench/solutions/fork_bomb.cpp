@@ -0,0 +1,15 @@
+#include <chrono>
+
+#include <unistd.h>
+
+int main() {
+    for (int depth = 0; depth < 10; ++depth) {
+        if (fork() < 0) {
+            break;
+        }
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (std::chrono::steady_clock::now() < deadline) {}
+    return 0;
+}
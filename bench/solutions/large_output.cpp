@@ -0,0 +1,13 @@
+#include <cstdio>
+#include <cstring>
+
+int main() {
+    static char line[101];
+    memset(line, 'x', 100);
+    line[100] = '\n';
+
+    for (int i = 0; i < 1024 * 1024; ++i) {
+        fwrite(line, 1, sizeof(line), stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,19 @@
+#include <cstdio>
+#include <cstdlib>
+
+int main() {
+    const size_t size = 256UL * 1024 * 1024;
+    char* block = static_cast<char*>(malloc(size));
+    if (block == nullptr) {
+        return 1;
+    }
+
+    unsigned long sum = 0;
+    for (size_t i = 0; i < size; i += 4096) {
+        block[i] = static_cast<char>(i);
+        sum += block[i];
+    }
+    printf("%lu\n", sum);
+    free(block);
+    return 0;
+}
@@ -0,0 +1,5 @@
+int main() {
+    volatile int* pointer = nullptr;
+    *pointer = 1;
+    return 0;
+}
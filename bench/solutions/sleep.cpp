@@ -0,0 +1,6 @@
+#include <unistd.h>
+
+int main() {
+    sleep(10);
+    return 0;
+}
@@ -0,0 +1,20 @@
+#include <cstdio>
+
+int main() {
+    static char buffer[1 << 16];
+    unsigned long long sum = 0;
+    unsigned long long value = 0;
+    size_t bytes;
+    while ((bytes = fread(buffer, 1, sizeof(buffer), stdin)) > 0) {
+        for (size_t i = 0; i < bytes; ++i) {
+            if (buffer[i] >= '0' && buffer[i] <= '9') {
+                value = value * 10 + (buffer[i] - '0');
+            } else {
+                sum += value;
+                value = 0;
+            }
+        }
+    }
+    printf("%llu\n", sum + value);
+    return 0;
+}
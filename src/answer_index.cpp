@@ -0,0 +1,280 @@
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "answer_index.h"
+#include "hash.h"
+
+namespace oj {
+
+namespace {
+
+constexpr char     MAGIC[8] = {'O', 'J', 'A', 'N', 'S', 'I', 'D', 'X'};
+constexpr uint32_t VERSION = 1;
+
+bool NextToken(std::string_view data, size_t& pos, std::string_view& token) {
+    while (pos < data.size() && AnswerIndex::IsSpace(data[pos])) {
+        ++pos;
+    }
+    if (pos == data.size()) {
+        return false;
+    }
+    size_t begin = pos;
+    while (pos < data.size() && !AnswerIndex::IsSpace(data[pos])) {
+        ++pos;
+    }
+    token = data.substr(begin, pos - begin);
+    return true;
+}
+
+bool IsClose(std::string_view lhs, std::string_view rhs, double epsilon) {
+    double lhs_value;
+    double rhs_value;
+    if (std::from_chars(lhs.data(), lhs.data() + lhs.size(), lhs_value).ec != std::errc() ||
+        std::from_chars(rhs.data(), rhs.data() + rhs.size(), rhs_value).ec != std::errc()) {
+        return false;
+    }
+    return std::fabs(lhs_value - rhs_value) <= epsilon * std::max(1.0, std::fabs(rhs_value));
+}
+
+}
+
+std::filesystem::path AnswerIndex::GetSidecar(const std::filesystem::path& answer_file) {
+    return answer_file.string() + ".idx";
+}
+
+void AnswerIndex::Build(const std::filesystem::path& answer_file) {
+    MappedFile answer(answer_file);
+    std::string index = Serialize(answer_file, answer.view());
+
+    std::filesystem::path sidecar = GetSidecar(answer_file);
+    std::filesystem::path staging = sidecar.string() + "." + std::to_string(getpid()) + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    {
+        std::ofstream out(staging, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            throw std::runtime_error("ERROR::AnswerIndex: Failed to open a file " + staging.string() + ".");
+        }
+        out.write(index.data(), index.size());
+        if (!out.flush()) {
+            out.close();
+            std::error_code error;
+            std::filesystem::remove(staging, error);
+            throw std::runtime_error("ERROR::AnswerIndex: Failed to write a file " + staging.string() + ".");
+        }
+    }
+    std::filesystem::rename(staging, sidecar);
+}
+
+std::string AnswerIndex::Serialize(const std::filesystem::path& answer_file, std::string_view data) {
+    Header header = {};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.answer_size = data.size();
+    header.answer_mtime = GetModificationTime(answer_file);
+
+    OutputHasher hasher;
+    hasher.Update(data);
+    header.raw_hash = hasher.raw_digest();
+    header.normalized_hash = hasher.normalized_digest();
+
+    std::vector<Token> tokens;
+    size_t pos = 0;
+    std::string_view token;
+    while (NextToken(data, pos, token)) {
+        tokens.push_back({static_cast<uint64_t>(token.data() - data.data()), static_cast<uint32_t>(token.size()), Classify(token)});
+    }
+    header.token_count = tokens.size();
+
+    std::vector<uint64_t> lines;
+    for (size_t begin = 0; begin < data.size();) {
+        lines.push_back(begin);
+        size_t end = data.find('\n', begin);
+        begin = end == std::string_view::npos ? data.size() : end + 1;
+    }
+    header.line_count = lines.size();
+    lines.push_back(data.size());
+
+    std::string index;
+    index.reserve(sizeof(header) + tokens.size() * sizeof(Token) + lines.size() * sizeof(uint64_t));
+    index.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    index.append(reinterpret_cast<const char*>(tokens.data()), tokens.size() * sizeof(Token));
+    index.append(reinterpret_cast<const char*>(lines.data()), lines.size() * sizeof(uint64_t));
+    return index;
+}
+
+uint32_t AnswerIndex::Classify(std::string_view token) {
+    size_t pos = 0;
+    if (pos < token.size() && (token[pos] == '+' || token[pos] == '-')) {
+        ++pos;
+    }
+    size_t digits = 0;
+    for (; pos < token.size() && isdigit(static_cast<unsigned char>(token[pos])); ++pos, ++digits) {}
+    if (pos == token.size()) {
+        return digits != 0 ? NUMERIC | INTEGER : 0;
+    }
+    if (token[pos] == '.') {
+        for (++pos; pos < token.size() && isdigit(static_cast<unsigned char>(token[pos])); ++pos, ++digits) {}
+    }
+    if (digits == 0) {
+        return 0;
+    }
+    if (pos < token.size() && (token[pos] == 'e' || token[pos] == 'E')) {
+        ++pos;
+        if (pos < token.size() && (token[pos] == '+' || token[pos] == '-')) {
+            ++pos;
+        }
+        size_t exponent_digits = 0;
+        for (; pos < token.size() && isdigit(static_cast<unsigned char>(token[pos])); ++pos, ++exponent_digits) {}
+        if (exponent_digits == 0) {
+            return 0;
+        }
+    }
+    return pos == token.size() ? NUMERIC : 0;
+}
+
+bool AnswerIndex::IsSpace(char c) {
+    return OutputHasher::IsSpace(c);
+}
+
+bool AnswerIndex::IsTokenEqual(std::string_view lhs, std::string_view rhs) {
+    size_t lhs_pos = 0;
+    size_t rhs_pos = 0;
+    std::string_view lhs_token;
+    std::string_view rhs_token;
+    while (true) {
+        bool has_lhs = NextToken(lhs, lhs_pos, lhs_token);
+        bool has_rhs = NextToken(rhs, rhs_pos, rhs_token);
+        if (!has_lhs || !has_rhs) {
+            return has_lhs == has_rhs;
+        }
+        if (lhs_token != rhs_token) {
+            return false;
+        }
+    }
+}
+
+AnswerIndex::AnswerIndex(const std::filesystem::path& answer_file) : header_(nullptr), tokens_(nullptr), lines_(nullptr) {
+    if (Open(answer_file)) {
+        return;
+    }
+
+    try {
+        Build(answer_file);
+        if (Open(answer_file)) {
+            return;
+        }
+    } catch (const std::runtime_error&) {}
+
+    sidecar_.Close();
+    answer_.Open(answer_file);
+    index_ = Serialize(answer_file, answer_.view());
+    Attach(index_.data());
+}
+
+bool AnswerIndex::IsEqual(std::string_view user_answer) const {
+    std::string_view answer = answer_.view();
+    return user_answer.size() == answer.size() && memcmp(user_answer.data(), answer.data(), answer.size()) == 0;
+}
+
+std::optional<TokenJudgeData> AnswerIndex::CompareTokens(std::string_view user_answer, double epsilon) const {
+    size_t pos = 0;
+    size_t index = 0;
+    std::string_view user_token;
+    while (NextToken(user_answer, pos, user_token)) {
+        if (index == header_->token_count) {
+            return TokenJudgeData{index, std::string(user_token), std::string()};
+        }
+        std::string_view correct_token = token(index);
+        if (user_token != correct_token && !(epsilon > 0.0 && (tokens_[index].flags & NUMERIC) && IsClose(user_token, correct_token, epsilon))) {
+            return TokenJudgeData{index, std::string(user_token), std::string(correct_token)};
+        }
+        ++index;
+    }
+    if (index != header_->token_count) {
+        return TokenJudgeData{index, std::string(), std::string(token(index))};
+    }
+    return std::nullopt;
+}
+
+std::string_view AnswerIndex::answer() const {
+    return answer_.view();
+}
+
+size_t AnswerIndex::token_count() const {
+    return header_->token_count;
+}
+
+std::string_view AnswerIndex::token(size_t index) const {
+    return answer_.view().substr(tokens_[index].begin, tokens_[index].size);
+}
+
+uint32_t AnswerIndex::token_flags(size_t index) const {
+    return tokens_[index].flags;
+}
+
+size_t AnswerIndex::line_count() const {
+    return header_->line_count;
+}
+
+std::string_view AnswerIndex::line(size_t index) const {
+    std::string_view line = answer_.view().substr(lines_[index], lines_[index + 1] - lines_[index]);
+    if (!line.empty() && line.back() == '\n') {
+        line.remove_suffix(1);
+    }
+    return line;
+}
+
+uint64_t AnswerIndex::raw_hash() const {
+    return header_->raw_hash;
+}
+
+uint64_t AnswerIndex::normalized_hash() const {
+    return header_->normalized_hash;
+}
+
+int64_t AnswerIndex::GetModificationTime(const std::filesystem::path& file) {
+    return std::filesystem::last_write_time(file).time_since_epoch().count();
+}
+
+bool AnswerIndex::Open(const std::filesystem::path& answer_file) {
+    std::filesystem::path sidecar = GetSidecar(answer_file);
+    if (!std::filesystem::exists(sidecar)) {
+        return false;
+    }
+
+    sidecar_.Open(sidecar);
+    if (sidecar_.size() < sizeof(Header)) {
+        return false;
+    }
+    header_ = reinterpret_cast<const Header*>(sidecar_.data());
+    size_t expected_size = sizeof(Header) + header_->token_count * sizeof(Token) + (header_->line_count + 1) * sizeof(uint64_t);
+    if (memcmp(header_->magic, MAGIC, sizeof(MAGIC)) != 0 || header_->version != VERSION || sidecar_.size() != expected_size) {
+        return false;
+    }
+
+    answer_.Open(answer_file);
+    if (answer_.size() != header_->answer_size || GetModificationTime(answer_file) != header_->answer_mtime) {
+        return false;
+    }
+
+    Attach(sidecar_.data());
+    return true;
+}
+
+void AnswerIndex::Attach(const char* index) {
+    header_ = reinterpret_cast<const Header*>(index);
+    tokens_ = reinterpret_cast<const Token*>(index + sizeof(Header));
+    lines_ = reinterpret_cast<const uint64_t*>(index + sizeof(Header) + header_->token_count * sizeof(Token));
+}
+
+}
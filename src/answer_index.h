@@ -0,0 +1,82 @@
+#ifndef ANSWER_INDEX_H
+#define ANSWER_INDEX_H
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "mapped_file.h"
+
+#include "judge_result.h"
+
+namespace oj {
+
+class AnswerIndex {
+public:
+    static constexpr uint32_t NUMERIC = 1;
+    static constexpr uint32_t INTEGER = 2;
+
+    static std::filesystem::path GetSidecar(const std::filesystem::path& answer_file);
+    static void                  Build(const std::filesystem::path& answer_file);
+    static uint32_t              Classify(std::string_view token);
+    static bool                  IsSpace(char c);
+    static bool                  IsTokenEqual(std::string_view lhs, std::string_view rhs);
+
+    ~AnswerIndex() = default;
+    explicit AnswerIndex(const std::filesystem::path& answer_file);
+    AnswerIndex(const AnswerIndex& other) = delete;
+    AnswerIndex(AnswerIndex&& other) = delete;
+
+    AnswerIndex& operator=(const AnswerIndex& other) = delete;
+    AnswerIndex& operator=(AnswerIndex&& other) = delete;
+
+    bool                          IsEqual(std::string_view user_answer) const;
+    std::optional<TokenJudgeData> CompareTokens(std::string_view user_answer, double epsilon = 0.0) const;
+
+    std::string_view              answer() const;
+    size_t                        token_count() const;
+    std::string_view              token(size_t index) const;
+    uint32_t                      token_flags(size_t index) const;
+    size_t                        line_count() const;
+    std::string_view              line(size_t index) const;
+    uint64_t                      raw_hash() const;
+    uint64_t                      normalized_hash() const;
+
+private:
+    struct Header {
+        char     magic[8];
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t answer_size;
+        int64_t  answer_mtime;
+        uint64_t raw_hash;
+        uint64_t normalized_hash;
+        uint64_t token_count;
+        uint64_t line_count;
+    };
+
+    struct Token {
+        uint64_t begin;
+        uint32_t size;
+        uint32_t flags;
+    };
+
+    static int64_t     GetModificationTime(const std::filesystem::path& file);
+    static std::string Serialize(const std::filesystem::path& answer_file, std::string_view data);
+
+    bool               Open(const std::filesystem::path& answer_file);
+    void               Attach(const char* index);
+
+    MappedFile      answer_;
+    MappedFile      sidecar_;
+    std::string     index_;
+    const Header*   header_;
+    const Token*    tokens_;
+    const uint64_t* lines_;
+};
+
+}
+
+#endif
@@ -0,0 +1,266 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "benchmark.h"
+#include "offline_judge.h"
+
+#include "execution_result.h"
+
+namespace oj {
+
+static std::string ReadInputFile(const std::filesystem::path& file) {
+    std::ifstream in(file);
+    if (!in.is_open()) {
+        throw std::runtime_error("ERROR::Benchmark: Failed to open a file " + file.string() + ".");
+    }
+
+    std::ostringstream sstream;
+    sstream << in.rdbuf();
+    return sstream.str();
+}
+
+static void DropPageCache(const std::filesystem::path& file) {
+    int fd = open(file.string().c_str(), O_RDONLY);
+    if (fd == -1) {
+        return;
+    }
+
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+
+SampleStatistics Benchmark::ComputeStatistics(std::vector<double> samples) {
+    if (samples.empty()) {
+        throw std::invalid_argument("ERROR::Benchmark: Can't compute statistics of an empty sample.");
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    size_t n = samples.size();
+    double mean = std::accumulate(samples.begin(), samples.end(), 0.0) / n;
+    double variance = 0.0;
+    for (double sample : samples) {
+        variance += (sample - mean) * (sample - mean);
+    }
+    variance = n > 1 ? variance / (n - 1) : 0.0;
+
+    SampleStatistics statistics;
+    statistics.min = samples.front();
+    statistics.median = n % 2 == 1 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2.0;
+    statistics.p95 = samples[static_cast<size_t>(std::ceil(0.95 * n)) - 1];
+    statistics.mean = mean;
+    statistics.stddev = std::sqrt(variance);
+    return statistics;
+}
+
+double Benchmark::MannWhitneyPValue(const std::vector<double>& lhs, const std::vector<double>& rhs) {
+    if (lhs.empty() || rhs.empty()) {
+        throw std::invalid_argument("ERROR::Benchmark: Can't compare empty samples.");
+    }
+
+    std::vector<std::pair<double, bool>> pooled;
+    pooled.reserve(lhs.size() + rhs.size());
+    for (double sample : lhs) {
+        pooled.emplace_back(sample, true);
+    }
+    for (double sample : rhs) {
+        pooled.emplace_back(sample, false);
+    }
+    std::sort(pooled.begin(), pooled.end());
+
+    double lhs_rank_sum = 0.0;
+    double tie_correction = 0.0;
+    for (size_t i = 0; i < pooled.size();) {
+        size_t j = i;
+        while (j < pooled.size() && pooled[j].first == pooled[i].first) {
+            ++j;
+        }
+
+        double rank = (i + 1 + j) / 2.0;
+        for (size_t k = i; k < j; ++k) {
+            if (pooled[k].second) {
+                lhs_rank_sum += rank;
+            }
+        }
+
+        double ties = static_cast<double>(j - i);
+        tie_correction += ties * ties * ties - ties;
+        i = j;
+    }
+
+    double n1 = static_cast<double>(lhs.size());
+    double n2 = static_cast<double>(rhs.size());
+    double n = n1 + n2;
+    double u = lhs_rank_sum - n1 * (n1 + 1) / 2.0;
+    double mu = n1 * n2 / 2.0;
+    double sigma = std::sqrt(n1 * n2 / 12.0 * ((n + 1) - tie_correction / (n * (n - 1))));
+    if (sigma == 0.0) {
+        return 1.0;
+    }
+
+    double z = (std::fabs(u - mu) - 0.5) / sigma;
+    return std::erfc(std::max(z, 0.0) / std::sqrt(2.0));
+}
+
+Benchmark::Benchmark (
+    int           runs,
+    int           warmup_runs,
+    bool          flush_caches,
+    double        significance_level,
+    OfflineJudge& judge
+) : judge_(judge),
+    runs_(runs),
+    warmup_runs_(warmup_runs),
+    flush_caches_(flush_caches),
+    significance_level_(significance_level) {
+    if (runs_ <= 0 || warmup_runs_ < 0) {
+        throw std::invalid_argument("ERROR::Benchmark: Invalid number of runs.");
+    }
+}
+
+BenchmarkReport Benchmark::Run (
+    const std::filesystem::path& program,
+    const std::filesystem::path& input_file,
+    int                          time_limit_sec,
+    int                          time_limit_usec,
+    int                          memory_limit_mb
+) const {
+    std::string input = ReadInputFile(input_file);
+
+    BenchmarkReport report;
+    report.program = program;
+    report.input_file = input_file;
+    for (int i = 0; i < warmup_runs_ + runs_; ++i) {
+        Sample(program, input_file, input, time_limit_sec, time_limit_usec, memory_limit_mb, i < warmup_runs_ ? nullptr : &report);
+    }
+    Summarize(report);
+    return report;
+}
+
+std::vector<BenchmarkComparison> Benchmark::Compare (
+    const std::filesystem::path&              baseline,
+    const std::filesystem::path&              candidate,
+    const std::vector<std::filesystem::path>& input_files,
+    int                                       time_limit_sec,
+    int                                       time_limit_usec,
+    int                                       memory_limit_mb
+) const {
+    std::vector<BenchmarkComparison> comparisons;
+    comparisons.reserve(input_files.size());
+    for (const std::filesystem::path& input_file : input_files) {
+        std::string input = ReadInputFile(input_file);
+
+        BenchmarkComparison comparison;
+        comparison.baseline.program = baseline;
+        comparison.baseline.input_file = input_file;
+        comparison.candidate.program = candidate;
+        comparison.candidate.input_file = input_file;
+        for (int i = 0; i < warmup_runs_ + runs_; ++i) {
+            BenchmarkReport* baseline_report = i < warmup_runs_ ? nullptr : &comparison.baseline;
+            BenchmarkReport* candidate_report = i < warmup_runs_ ? nullptr : &comparison.candidate;
+            if (i % 2 == 0) {
+                Sample(baseline, input_file, input, time_limit_sec, time_limit_usec, memory_limit_mb, baseline_report);
+                Sample(candidate, input_file, input, time_limit_sec, time_limit_usec, memory_limit_mb, candidate_report);
+            } else {
+                Sample(candidate, input_file, input, time_limit_sec, time_limit_usec, memory_limit_mb, candidate_report);
+                Sample(baseline, input_file, input, time_limit_sec, time_limit_usec, memory_limit_mb, baseline_report);
+            }
+        }
+        Summarize(comparison.baseline);
+        Summarize(comparison.candidate);
+
+        comparison.cpu_time_p_value = MannWhitneyPValue(comparison.baseline.cpu_time_ms, comparison.candidate.cpu_time_ms);
+        comparison.wall_time_p_value = MannWhitneyPValue(comparison.baseline.wall_time_ms, comparison.candidate.wall_time_ms);
+        comparison.is_significant = std::min(comparison.cpu_time_p_value, comparison.wall_time_p_value) < significance_level_ / 2.0;
+        comparisons.push_back(std::move(comparison));
+    }
+    return comparisons;
+}
+
+void Benchmark::Print(std::ostream& os, const BenchmarkReport& report) const {
+    auto print = [&os](const char* name, const SampleStatistics& statistics) {
+        os << "  " << std::left << std::setw(10) << name << std::right << std::fixed << std::setprecision(3)
+           << " min " << std::setw(12) << statistics.min
+           << " median " << std::setw(12) << statistics.median
+           << " p95 " << std::setw(12) << statistics.p95
+           << " stddev " << std::setw(12) << statistics.stddev << '\n';
+    };
+
+    os << report.program.string() << " < " << report.input_file.string() << " (" << report.cpu_time_ms.size() << " runs)\n";
+    print("cpu(ms)", report.cpu_time);
+    print("wall(ms)", report.wall_time);
+    print("rss(kb)", report.peak_rss);
+}
+
+void Benchmark::Print(std::ostream& os, const BenchmarkComparison& comparison) const {
+    Print(os, comparison.baseline);
+    Print(os, comparison.candidate);
+
+    os << "  cpu speedup ";
+    if (comparison.candidate.cpu_time.median > 0.0) {
+        os << 'x' << std::fixed << std::setprecision(3) << comparison.baseline.cpu_time.median / comparison.candidate.cpu_time.median;
+    } else {
+        os << "n/a";
+    }
+    os << " (p = " << std::setprecision(4) << comparison.cpu_time_p_value << ", wall p = " << comparison.wall_time_p_value << ")"
+       << (comparison.is_significant ? " significant" : " not significant") << '\n';
+}
+
+void Benchmark::FlushCaches(const std::filesystem::path& program, const std::filesystem::path& input_file) const {
+    static constexpr size_t SCRATCH_SIZE = 64 * 1024 * 1024;
+    thread_local std::vector<char> scratch(SCRATCH_SIZE);
+
+    DropPageCache(program);
+    DropPageCache(input_file);
+
+    for (size_t i = 0; i < scratch.size(); i += 64) {
+        scratch[i] = static_cast<char>(scratch[i] + 1);
+    }
+}
+
+
+void Benchmark::Sample (
+    const std::filesystem::path& program,
+    const std::filesystem::path& input_file,
+    const std::string&           input,
+    int                          time_limit_sec,
+    int                          time_limit_usec,
+    int                          memory_limit_mb,
+    BenchmarkReport*             report
+) const {
+    if (flush_caches_) {
+        FlushCaches(program, input_file);
+    }
+
+    std::shared_ptr<ExecutionResult> result = judge_.Execute(
+        program, time_limit_sec, time_limit_usec, memory_limit_mb, input, std::filesystem::path(), false);
+
+    if (!result->is_success()) {
+        throw std::runtime_error("ERROR::Benchmark: " + program.string() + " failed on " + input_file.string() + ".");
+    }
+
+    if (report == nullptr) {
+        return;
+    }
+
+    report->cpu_time_ms.push_back(result->elapsed_time_sec() * 1000.0 + result->elapsed_time_usec() / 1000.0);
+    report->wall_time_ms.push_back(result->wall_time_usec() / 1000.0);
+    report->peak_rss_kb.push_back(result->memory_usage());
+}
+
+void Benchmark::Summarize(BenchmarkReport& report) const {
+    report.cpu_time = ComputeStatistics(report.cpu_time_ms);
+    report.wall_time = ComputeStatistics(report.wall_time_ms);
+    report.peak_rss = ComputeStatistics(report.peak_rss_kb);
+}
+
+}
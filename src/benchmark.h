@@ -0,0 +1,100 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "offline_judge.h"
+
+namespace oj {
+
+struct SampleStatistics {
+    double min;
+    double median;
+    double p95;
+    double mean;
+    double stddev;
+};
+
+struct BenchmarkReport {
+    std::filesystem::path program;
+    std::filesystem::path input_file;
+    std::vector<double>   cpu_time_ms;
+    std::vector<double>   wall_time_ms;
+    std::vector<double>   peak_rss_kb;
+    SampleStatistics      cpu_time;
+    SampleStatistics      wall_time;
+    SampleStatistics      peak_rss;
+};
+
+struct BenchmarkComparison {
+    BenchmarkReport baseline;
+    BenchmarkReport candidate;
+    double          cpu_time_p_value;
+    double          wall_time_p_value;
+    bool            is_significant;
+};
+
+class Benchmark {
+public:
+    static SampleStatistics ComputeStatistics(std::vector<double> samples);
+    static double           MannWhitneyPValue(const std::vector<double>& lhs, const std::vector<double>& rhs);
+
+    ~Benchmark() = default;
+    Benchmark (
+        int           runs = 20,
+        int           warmup_runs = 2,
+        bool          flush_caches = false,
+        double        significance_level = 0.05,
+        OfflineJudge& judge = OfflineJudge::GetInstance()
+    );
+    Benchmark(const Benchmark& other) = delete;
+    Benchmark(Benchmark&& other) = delete;
+
+    Benchmark& operator=(const Benchmark& other) = delete;
+    Benchmark& operator=(Benchmark&& other) = delete;
+
+    BenchmarkReport                  Run (
+        const std::filesystem::path& program,
+        const std::filesystem::path& input_file,
+        int                          time_limit_sec,
+        int                          time_limit_usec,
+        int                          memory_limit_mb
+    ) const;
+    std::vector<BenchmarkComparison> Compare (
+        const std::filesystem::path&              baseline,
+        const std::filesystem::path&              candidate,
+        const std::vector<std::filesystem::path>& input_files,
+        int                                       time_limit_sec,
+        int                                       time_limit_usec,
+        int                                       memory_limit_mb
+    ) const;
+
+    void                             Print(std::ostream& os, const BenchmarkReport& report) const;
+    void                             Print(std::ostream& os, const BenchmarkComparison& comparison) const;
+
+private:
+    void FlushCaches(const std::filesystem::path& program, const std::filesystem::path& input_file) const;
+    void Sample (
+        const std::filesystem::path& program,
+        const std::filesystem::path& input_file,
+        const std::string&           input,
+        int                          time_limit_sec,
+        int                          time_limit_usec,
+        int                          memory_limit_mb,
+        BenchmarkReport*             report
+    ) const;
+    void Summarize(BenchmarkReport& report) const;
+
+    OfflineJudge& judge_;
+    int           runs_;
+    int           warmup_runs_;
+    bool          flush_caches_;
+    double        significance_level_;
+};
+
+}
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+
+namespace oj {
+
+template <typename T>
+class BoundedQueue {
+public:
+    ~BoundedQueue() = default;
+    explicit BoundedQueue(size_t capacity) : capacity_(capacity != 0 ? capacity : 1), is_closed_(false) {}
+    BoundedQueue(const BoundedQueue& other) = delete;
+    BoundedQueue(BoundedQueue&& other) = delete;
+
+    BoundedQueue& operator=(const BoundedQueue& other) = delete;
+    BoundedQueue& operator=(BoundedQueue&& other) = delete;
+
+    void Push(T item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this]() { return items_.size() < capacity_ || is_closed_; });
+        if (is_closed_) {
+            throw std::runtime_error("ERROR::BoundedQueue: Failed to push into a closed queue.");
+        }
+        items_.push_back(std::move(item));
+        not_empty_.notify_one();
+    }
+
+    std::optional<T> Pop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this]() { return !items_.empty() || is_closed_; });
+        if (items_.empty()) {
+            return std::nullopt;
+        }
+        T item = std::move(items_.front());
+        items_.pop_front();
+        not_full_.notify_one();
+        return item;
+    }
+
+    void Close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        is_closed_ = true;
+        not_full_.notify_all();
+        not_empty_.notify_all();
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return items_.size();
+    }
+
+    size_t capacity() const {
+        return capacity_;
+    }
+
+private:
+    size_t                  capacity_;
+    bool                    is_closed_;
+    mutable std::mutex      mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+    std::deque<T>           items_;
+};
+
+}
+
+#endif
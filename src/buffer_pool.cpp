@@ -0,0 +1,148 @@
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+#include <utility>
+
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "buffer_pool.h"
+
+namespace oj {
+
+Buffer::~Buffer() {
+    Release();
+}
+
+Buffer::Buffer() : pool_(nullptr), data_(nullptr), size_(0) {}
+
+Buffer::Buffer(BufferPool* pool, char* data, size_t size) : pool_(pool), data_(data), size_(size) {}
+
+Buffer::Buffer(Buffer&& other) noexcept
+    : pool_(std::exchange(other.pool_, nullptr)),
+      data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)) {}
+
+Buffer& Buffer::operator=(Buffer&& other) noexcept {
+    if (this != &other) {
+        Release();
+        pool_ = std::exchange(other.pool_, nullptr);
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+}
+
+void Buffer::Release() {
+    if (pool_ != nullptr && data_ != nullptr) {
+        pool_->Release(data_, size_);
+    }
+    pool_ = nullptr;
+    data_ = nullptr;
+    size_ = 0;
+}
+
+char* Buffer::data() const {
+    return data_;
+}
+
+size_t Buffer::size() const {
+    return size_;
+}
+
+BufferPool::~BufferPool() {
+    for (size_t size_class = 0; size_class < SIZE_CLASS_COUNT; ++size_class) {
+        for (char* data : free_lists_[size_class]) {
+            Unmap(data, SIZE_CLASSES[size_class]);
+        }
+    }
+}
+
+BufferPool::BufferPool(bool use_huge_pages) : use_huge_pages_(use_huge_pages), mappings_(0) {
+    for (size_t size_class = 0; size_class < SIZE_CLASS_COUNT; ++size_class) {
+        free_lists_[size_class].reserve(MAX_CACHED[size_class]);
+    }
+}
+
+Buffer BufferPool::Acquire(size_t min_size) {
+    size_t size_class = GetSizeClass(min_size);
+    if (size_class == SIZE_CLASS_COUNT) {
+        size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t size = (min_size + page_size - 1) / page_size * page_size;
+        return Buffer(this, Map(size), size);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<char*>& free_list = free_lists_[size_class];
+        if (!free_list.empty()) {
+            char* data = free_list.back();
+            free_list.pop_back();
+            return Buffer(this, data, SIZE_CLASSES[size_class]);
+        }
+    }
+
+    return Buffer(this, Map(SIZE_CLASSES[size_class]), SIZE_CLASSES[size_class]);
+}
+
+Buffer BufferPool::Grow(Buffer& buffer, size_t used_size) {
+    Buffer grown = Acquire(buffer.size() * 2);
+    memcpy(grown.data(), buffer.data(), used_size);
+    buffer.Release();
+    return grown;
+}
+
+size_t BufferPool::mappings() const {
+    return mappings_.load();
+}
+
+size_t BufferPool::GetSizeClass(size_t size) {
+    size_t size_class = 0;
+    while (size_class < SIZE_CLASS_COUNT && SIZE_CLASSES[size_class] < size) {
+        ++size_class;
+    }
+    return size_class;
+}
+
+char* BufferPool::Map(size_t size) {
+    void* data = MAP_FAILED;
+    if (use_huge_pages_ && size >= (2UL << 20)) {
+        data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    }
+    if (data == MAP_FAILED) {
+        data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (data == MAP_FAILED) {
+            throw std::system_error(errno, std::generic_category(), "ERROR::BufferPool: Failed to map a buffer.");
+        }
+        if (use_huge_pages_ && size >= (2UL << 20)) {
+            madvise(data, size, MADV_HUGEPAGE);
+        }
+    }
+
+    ++mappings_;
+    return static_cast<char*>(data);
+}
+
+void BufferPool::Unmap(char* data, size_t size) {
+    munmap(data, size);
+}
+
+void BufferPool::Release(char* data, size_t size) {
+    size_t size_class = GetSizeClass(size);
+    if (size_class != SIZE_CLASS_COUNT && SIZE_CLASSES[size_class] == size) {
+        if (size > SIZE_CLASSES[0]) {
+            madvise(data, size, MADV_FREE);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<char*>& free_list = free_lists_[size_class];
+        if (free_list.size() < MAX_CACHED[size_class]) {
+            free_list.push_back(data);
+            return;
+        }
+    }
+
+    Unmap(data, size);
+}
+
+}
@@ -0,0 +1,79 @@
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace oj {
+
+class BufferPool;
+
+class Buffer {
+public:
+    ~Buffer();
+    Buffer();
+    Buffer(const Buffer& other) = delete;
+    Buffer(Buffer&& other) noexcept;
+
+    Buffer& operator=(const Buffer& other) = delete;
+    Buffer& operator=(Buffer&& other) noexcept;
+
+    void   Release();
+
+    char*  data() const;
+    size_t size() const;
+
+private:
+    friend class BufferPool;
+
+    Buffer(BufferPool* pool, char* data, size_t size);
+
+    BufferPool* pool_;
+    char*       data_;
+    size_t      size_;
+};
+
+class BufferPool {
+public:
+    static constexpr size_t                               SIZE_CLASS_COUNT = 4;
+    static constexpr std::array<size_t, SIZE_CLASS_COUNT> SIZE_CLASSES = {64UL << 10, 1UL << 20, 16UL << 20, 128UL << 20};
+    static constexpr std::array<size_t, SIZE_CLASS_COUNT> MAX_CACHED = {64, 16, 4, 2};
+
+    static BufferPool& GetInstance() {
+        static BufferPool instance;
+        return instance;
+    }
+
+    ~BufferPool();
+    explicit BufferPool(bool use_huge_pages = false);
+    BufferPool(const BufferPool& other) = delete;
+    BufferPool(BufferPool&& other) = delete;
+
+    BufferPool& operator=(const BufferPool& other) = delete;
+    BufferPool& operator=(BufferPool&& other) = delete;
+
+    Buffer Acquire(size_t min_size);
+    Buffer Grow(Buffer& buffer, size_t used_size);
+
+    size_t mappings() const;
+
+private:
+    friend class Buffer;
+
+    static size_t GetSizeClass(size_t size);
+
+    char*         Map(size_t size);
+    void          Unmap(char* data, size_t size);
+    void          Release(char* data, size_t size);
+
+    bool                                             use_huge_pages_;
+    std::mutex                                       mutex_;
+    std::array<std::vector<char*>, SIZE_CLASS_COUNT> free_lists_;
+    std::atomic<size_t>                              mappings_;
+};
+
+}
+
+#endif
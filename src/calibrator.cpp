@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include "calibrator.h"
+#include "offline_judge.h"
+
+#include "execution_result.h"
+
+namespace oj {
+
+static long long GetModificationTime(const std::filesystem::path& file) {
+    return static_cast<long long>(std::filesystem::last_write_time(file).time_since_epoch().count());
+}
+
+Calibration::Calibration (
+    const std::string&               problem,
+    const std::string&               host,
+    const std::vector<TestBaseline>& baselines,
+    double                           multiplier,
+    long long                        minimum_limit_usec
+) : problem_(problem),
+    host_(host),
+    baselines_(baselines),
+    multiplier_(multiplier),
+    minimum_limit_usec_(minimum_limit_usec) {}
+
+long long Calibration::EffectiveLimitUsec(size_t test) const {
+    if (test >= baselines_.size()) {
+        throw std::out_of_range("ERROR::Calibration: Test index is out of range.");
+    }
+
+    long long limit = static_cast<long long>(std::ceil(baselines_[test].baseline_usec * multiplier_));
+    return std::max(limit, minimum_limit_usec_);
+}
+
+long long Calibration::EffectiveLimitUsec() const {
+    long long limit = minimum_limit_usec_;
+    for (size_t i = 0; i < baselines_.size(); ++i) {
+        limit = std::max(limit, EffectiveLimitUsec(i));
+    }
+    return limit;
+}
+
+int Calibration::time_limit_sec(size_t test) const {
+    return static_cast<int>(EffectiveLimitUsec(test) / 1000000);
+}
+
+int Calibration::time_limit_usec(size_t test) const {
+    return static_cast<int>(EffectiveLimitUsec(test) % 1000000);
+}
+
+std::string Calibration::problem() const {
+    return problem_;
+}
+
+std::string Calibration::host() const {
+    return host_;
+}
+
+const std::vector<TestBaseline>& Calibration::baselines() const {
+    return baselines_;
+}
+
+std::string Calibrator::HostFingerprint() {
+    std::string model;
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    for (std::string line; std::getline(cpuinfo, line);) {
+        if (line.rfind("model name", 0) == 0) {
+            model = line.substr(line.find(':') + 1);
+            break;
+        }
+    }
+
+    std::string memory;
+    std::ifstream meminfo("/proc/meminfo");
+    for (std::string line; std::getline(meminfo, line);) {
+        if (line.rfind("MemTotal", 0) == 0) {
+            memory = line.substr(line.find(':') + 1);
+            break;
+        }
+    }
+
+    std::ostringstream os;
+    os << model << " |" << std::thread::hardware_concurrency() << " cpus|" << memory;
+
+    std::string fingerprint = os.str();
+    std::replace(fingerprint.begin(), fingerprint.end(), '\t', ' ');
+    return fingerprint;
+}
+
+Calibrator::Calibrator (
+    const std::filesystem::path& cache_dir,
+    int                          runs,
+    double                       multiplier,
+    long long                    minimum_limit_usec,
+    int                          calibration_time_limit_sec,
+    OfflineJudge&                judge
+) : judge_(judge),
+    cache_dir_(cache_dir),
+    runs_(runs),
+    multiplier_(multiplier),
+    minimum_limit_usec_(minimum_limit_usec),
+    calibration_time_limit_sec_(calibration_time_limit_sec) {
+    if (runs_ <= 0) {
+        throw std::invalid_argument("ERROR::Calibrator: Number of runs must be positive.");
+    }
+
+    std::filesystem::create_directories(cache_dir_);
+}
+
+std::shared_ptr<Calibration> Calibrator::GetCalibration (
+    const std::string&                        problem,
+    const std::filesystem::path&              reference,
+    const std::vector<std::filesystem::path>& input_files,
+    int                                       memory_limit_mb
+) const {
+    std::shared_ptr<Calibration> calibration = LoadCache(problem, reference, input_files);
+    if (calibration != nullptr) {
+        return calibration;
+    }
+
+    return Calibrate(problem, reference, input_files, memory_limit_mb);
+}
+
+std::shared_ptr<Calibration> Calibrator::Calibrate (
+    const std::string&                        problem,
+    const std::filesystem::path&              reference,
+    const std::vector<std::filesystem::path>& input_files,
+    int                                       memory_limit_mb
+) const {
+    std::vector<TestBaseline> baselines;
+    baselines.reserve(input_files.size());
+    for (const std::filesystem::path& input_file : input_files) {
+        baselines.push_back({input_file, MeasureBaseline(reference, input_file, memory_limit_mb)});
+    }
+
+    std::shared_ptr<Calibration> calibration = std::make_shared<Calibration>(
+        problem, HostFingerprint(), baselines, multiplier_, minimum_limit_usec_);
+    StoreCache(*calibration, reference);
+    return calibration;
+}
+
+std::filesystem::path Calibrator::GetCacheFile(const std::string& problem) const {
+    return cache_dir_ / (problem + ".calibration");
+}
+
+std::shared_ptr<Calibration> Calibrator::LoadCache (
+    const std::string&                        problem,
+    const std::filesystem::path&              reference,
+    const std::vector<std::filesystem::path>& input_files
+) const {
+    std::ifstream in(GetCacheFile(problem));
+    if (!in.is_open()) {
+        return nullptr;
+    }
+
+    std::string line;
+    if (!std::getline(in, line) || line != "host\t" + HostFingerprint()) {
+        return nullptr;
+    }
+
+    std::ostringstream expected_reference;
+    expected_reference << "reference\t" << GetModificationTime(reference) << '\t' << reference.string();
+    if (!std::getline(in, line) || line != expected_reference.str()) {
+        return nullptr;
+    }
+
+    std::vector<TestBaseline> baselines;
+    for (const std::filesystem::path& input_file : input_files) {
+        if (!std::getline(in, line)) {
+            return nullptr;
+        }
+
+        std::istringstream record(line);
+        std::string tag;
+        long long baseline_usec;
+        long long modification_time;
+        std::string path;
+        record >> tag >> baseline_usec >> modification_time;
+        record.ignore(1);
+        std::getline(record, path);
+        if (!record || tag != "test" || path != input_file.string() || modification_time != GetModificationTime(input_file)) {
+            return nullptr;
+        }
+
+        baselines.push_back({input_file, baseline_usec});
+    }
+
+    if (std::getline(in, line)) {
+        return nullptr;
+    }
+
+    return std::make_shared<Calibration>(problem, HostFingerprint(), baselines, multiplier_, minimum_limit_usec_);
+}
+
+void Calibrator::StoreCache(const Calibration& calibration, const std::filesystem::path& reference) const {
+    std::filesystem::path file = GetCacheFile(calibration.problem());
+    std::filesystem::path temporary = file;
+    temporary += ".tmp";
+
+    std::ofstream out(temporary, std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("ERROR::Calibrator: Failed to open a file " + temporary.string() + ".");
+    }
+
+    out << "host\t" << calibration.host() << '\n';
+    out << "reference\t" << GetModificationTime(reference) << '\t' << reference.string() << '\n';
+    for (const TestBaseline& baseline : calibration.baselines()) {
+        out << "test\t" << baseline.baseline_usec << '\t' << GetModificationTime(baseline.input_file) << '\t' << baseline.input_file.string() << '\n';
+    }
+    out.close();
+
+    std::filesystem::rename(temporary, file);
+}
+
+long long Calibrator::MeasureBaseline (
+    const std::filesystem::path& reference,
+    const std::filesystem::path& input_file,
+    int                          memory_limit_mb
+) const {
+    std::vector<long long> samples;
+    samples.reserve(runs_);
+    for (int i = 0; i < runs_; ++i) {
+        std::shared_ptr<ExecutionResult> result = judge_.ExecuteWithFile(
+            reference, calibration_time_limit_sec_, 0, memory_limit_mb, input_file, std::filesystem::path(), false);
+        if (!result->is_success()) {
+            throw std::runtime_error("ERROR::Calibrator: Reference solution " + reference.string() + " failed on " + input_file.string() + ".");
+        }
+
+        samples.push_back(static_cast<long long>(result->elapsed_time_sec()) * 1000000 + result->elapsed_time_usec());
+    }
+
+    std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+    return samples[samples.size() / 2];
+}
+
+}
@@ -0,0 +1,107 @@
+#ifndef CALIBRATOR_H
+#define CALIBRATOR_H
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "offline_judge.h"
+
+namespace oj {
+
+struct TestBaseline {
+    std::filesystem::path input_file;
+    long long             baseline_usec;
+};
+
+class Calibration {
+public:
+    ~Calibration() = default;
+    Calibration (
+        const std::string&               problem,
+        const std::string&               host,
+        const std::vector<TestBaseline>& baselines,
+        double                           multiplier,
+        long long                        minimum_limit_usec
+    );
+    Calibration(const Calibration& other) = default;
+    Calibration(Calibration&& other) noexcept = default;
+
+    Calibration& operator=(const Calibration& other) = default;
+    Calibration& operator=(Calibration&& other) noexcept = default;
+
+    long long                        EffectiveLimitUsec(size_t test) const;
+    long long                        EffectiveLimitUsec() const;
+    int                              time_limit_sec(size_t test) const;
+    int                              time_limit_usec(size_t test) const;
+
+    std::string                      problem() const;
+    std::string                      host() const;
+    const std::vector<TestBaseline>& baselines() const;
+
+private:
+    std::string               problem_;
+    std::string               host_;
+    std::vector<TestBaseline> baselines_;
+    double                    multiplier_;
+    long long                 minimum_limit_usec_;
+};
+
+class Calibrator {
+public:
+    static std::string HostFingerprint();
+
+    ~Calibrator() = default;
+    Calibrator (
+        const std::filesystem::path& cache_dir,
+        int                          runs = 5,
+        double                       multiplier = 3.0,
+        long long                    minimum_limit_usec = 100000,
+        int                          calibration_time_limit_sec = 30,
+        OfflineJudge&                judge = OfflineJudge::GetInstance()
+    );
+    Calibrator(const Calibrator& other) = delete;
+    Calibrator(Calibrator&& other) = delete;
+
+    Calibrator& operator=(const Calibrator& other) = delete;
+    Calibrator& operator=(Calibrator&& other) = delete;
+
+    std::shared_ptr<Calibration> GetCalibration (
+        const std::string&                        problem,
+        const std::filesystem::path&              reference,
+        const std::vector<std::filesystem::path>& input_files,
+        int                                       memory_limit_mb
+    ) const;
+    std::shared_ptr<Calibration> Calibrate (
+        const std::string&                        problem,
+        const std::filesystem::path&              reference,
+        const std::vector<std::filesystem::path>& input_files,
+        int                                       memory_limit_mb
+    ) const;
+
+private:
+    std::filesystem::path        GetCacheFile(const std::string& problem) const;
+    std::shared_ptr<Calibration> LoadCache (
+        const std::string&                        problem,
+        const std::filesystem::path&              reference,
+        const std::vector<std::filesystem::path>& input_files
+    ) const;
+    void                         StoreCache(const Calibration& calibration, const std::filesystem::path& reference) const;
+    long long                    MeasureBaseline (
+        const std::filesystem::path& reference,
+        const std::filesystem::path& input_file,
+        int                          memory_limit_mb
+    ) const;
+
+    OfflineJudge&         judge_;
+    std::filesystem::path cache_dir_;
+    int                   runs_;
+    double                multiplier_;
+    long long             minimum_limit_usec_;
+    int                   calibration_time_limit_sec_;
+};
+
+}
+
+#endif
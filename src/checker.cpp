@@ -0,0 +1,245 @@
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+
+#include "checker.h"
+#include "checker_protocol.h"
+
+namespace oj {
+
+static FileDescriptor OpenReadOnly(const std::filesystem::path& file) {
+    int fd = open(file.string().c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        throw std::system_error(errno, std::generic_category(), "ERROR::Checker: Failed to open file " + file.string() + ".");
+    }
+    return FileDescriptor(fd, true);
+}
+
+static FileDescriptor CreateMemoryFile(const std::string& content) {
+    int fd = memfd_create("oj-user-answer", MFD_CLOEXEC);
+    if (fd == -1) {
+        throw std::system_error(errno, std::generic_category(), "ERROR::Checker: Failed to create a memory file.");
+    }
+    FileDescriptor file(fd, true);
+
+    size_t total_bytes = 0;
+    while (total_bytes < content.size()) {
+        ssize_t bytes = write(fd, content.data() + total_bytes, content.size() - total_bytes);
+        if (bytes == -1) {
+            throw std::system_error(errno, std::generic_category(), "ERROR::Checker: Failed to write to a memory file.");
+        }
+        total_bytes += bytes;
+    }
+
+    if (lseek(fd, 0, SEEK_SET) == -1) {
+        throw std::system_error(errno, std::generic_category(), "ERROR::Checker: Failed to rewind a memory file.");
+    }
+    return file;
+}
+
+Checker::~Checker() {
+    Stop();
+}
+
+Checker::Checker (
+    const std::filesystem::path&    program,
+    const std::vector<std::string>& args,
+    int                             time_limit_ms
+) : program_(program), args_(args), time_limit_ms_(time_limit_ms), socket_(-1) {}
+
+CheckerVerdict Checker::Run (
+    const std::filesystem::path& input_file,
+    const std::string&           user_answer,
+    const std::filesystem::path& answer_file
+) {
+    FileDescriptor input = OpenReadOnly(input_file);
+    FileDescriptor output = CreateMemoryFile(user_answer);
+    FileDescriptor answer = OpenReadOnly(answer_file);
+    const int fds[CHECKER_REQUEST_FDS] = {input.fd(), output.fd(), answer.fd()};
+
+    CheckerVerdict verdict;
+    if (is_running() && TryRun(fds, verdict)) {
+        return verdict;
+    }
+
+    Stop();
+    Start();
+    if (!TryRun(fds, verdict)) {
+        Stop();
+        throw std::runtime_error("ERROR::Checker: Checker " + program_.string() + " stopped responding.");
+    }
+    return verdict;
+}
+
+std::shared_ptr<JudgeResult> Checker::Check (
+    const std::filesystem::path& input_file,
+    const std::string&           user_answer,
+    const std::filesystem::path& answer_file
+) {
+    CheckerVerdict verdict = Run(input_file, user_answer, answer_file);
+
+    std::string correct_answer_data;
+    std::vector<TokenJudgeData> token_data;
+    std::vector<LineJudgeData> line_data;
+    std::shared_ptr<JudgeResult> result = CreateJudgeResult(CreateExitStatus(verdict.status), user_answer, correct_answer_data, token_data, line_data);
+    result->set_message(verdict.message);
+    return result;
+}
+
+void Checker::Stop() {
+    socket_.Close();
+    buffer_.clear();
+
+    if (process_ != nullptr) {
+        process_->Kill();
+        process_->Wait();
+        process_.reset();
+    }
+}
+
+bool Checker::is_running() const {
+    return process_ != nullptr && socket_.is_opened();
+}
+
+std::filesystem::path Checker::program() const {
+    return program_;
+}
+
+void Checker::Start() {
+    if (!std::filesystem::exists(program_)) {
+        throw std::runtime_error("ERROR::Checker: " + program_.string() + " doesn't exist.");
+    }
+
+    int sockets[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets) == -1) {
+        throw std::system_error(errno, std::generic_category(), "ERROR::Checker: Failed to open a socket pair.");
+    }
+    FileDescriptor parent_end(sockets[0], true);
+    FileDescriptor child_end(sockets[1], true);
+
+    std::vector<std::string> args;
+    args.reserve(args_.size() + 1);
+    args.push_back(program_.string());
+    args.insert(args.end(), args_.begin(), args_.end());
+
+    process_ = Process::CreateProcess(program_, args, child_end, child_end);
+    socket_ = std::move(parent_end);
+}
+
+bool Checker::TryRun(const int (&fds)[3], CheckerVerdict& verdict) {
+    if (!SendCheckerRequest(socket_.fd(), fds)) {
+        return false;
+    }
+
+    std::string line;
+    if (!ReadLine(line, std::chrono::steady_clock::now() + std::chrono::milliseconds(time_limit_ms_))) {
+        return false;
+    }
+
+    size_t space = line.find(' ');
+    std::string code = line.substr(0, space);
+    verdict.message = space == std::string::npos ? std::string() : line.substr(space + 1);
+    if (code == "AC") {
+        verdict.status = ExitStatus::JUDGE_SUCCESS;
+    } else if (code == "WA") {
+        verdict.status = ExitStatus::JUDGE_WRONG_ANSWER;
+    } else if (code == "PE") {
+        verdict.status = ExitStatus::JUDGE_INVALID_OUTPUT_FORMAT;
+    } else {
+        throw std::runtime_error("ERROR::Checker: Checker " + program_.string() + " returned an unknown verdict \"" + code + "\".");
+    }
+    return true;
+}
+
+bool Checker::ReadLine(std::string& line, std::chrono::steady_clock::time_point deadline) {
+    size_t newline;
+    while ((newline = buffer_.find('\n')) == std::string::npos) {
+        long long remaining_ms = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+        if (remaining_ms <= 0) {
+            Stop();
+            throw std::runtime_error("ERROR::Checker: Checker " + program_.string() + " didn't respond within " + std::to_string(time_limit_ms_) + " ms.");
+        }
+
+        pollfd fd = {socket_.fd(), POLLIN, 0};
+        int ready = poll(&fd, 1, static_cast<int>(remaining_ms));
+        if (ready == -1 && errno != EINTR) {
+            return false;
+        }
+        if (ready <= 0) {
+            continue;
+        }
+
+        char buf[256];
+        ssize_t bytes = read(socket_.fd(), buf, sizeof(buf));
+        if (bytes == -1 && errno == EINTR) {
+            continue;
+        }
+        if (bytes <= 0) {
+            return false;
+        }
+        buffer_.append(buf, bytes);
+    }
+
+    line = buffer_.substr(0, newline);
+    buffer_.erase(0, newline + 1);
+    return true;
+}
+
+CheckerPool::CheckerPool(size_t max_idle_checkers, int time_limit_ms)
+    : max_idle_checkers_(max_idle_checkers), time_limit_ms_(time_limit_ms) {}
+
+std::shared_ptr<JudgeResult> CheckerPool::Check (
+    const std::string&           problem,
+    const std::filesystem::path& program,
+    const std::filesystem::path& input_file,
+    const std::string&           user_answer,
+    const std::filesystem::path& answer_file
+) {
+    std::unique_ptr<Checker> checker = Acquire(problem, program);
+    std::shared_ptr<JudgeResult> result = checker->Check(input_file, user_answer, answer_file);
+    Release(problem, std::move(checker));
+    return result;
+}
+
+void CheckerPool::Clear() {
+    std::unordered_map<std::string, std::vector<std::unique_ptr<Checker>>> idle_checkers;
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_checkers.swap(idle_checkers_);
+}
+
+std::unique_ptr<Checker> CheckerPool::Acquire(const std::string& problem, const std::filesystem::path& program) {
+    std::vector<std::unique_ptr<Checker>> stale_checkers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<std::unique_ptr<Checker>>& checkers = idle_checkers_[problem];
+        while (!checkers.empty()) {
+            std::unique_ptr<Checker> checker = std::move(checkers.back());
+            checkers.pop_back();
+            if (checker->program() == program) {
+                return checker;
+            }
+            stale_checkers.push_back(std::move(checker));
+        }
+    }
+
+    return std::make_unique<Checker>(program, std::vector<std::string>(), time_limit_ms_);
+}
+
+void CheckerPool::Release(const std::string& problem, std::unique_ptr<Checker> checker) {
+    if (!checker->is_running()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::unique_ptr<Checker>>& checkers = idle_checkers_[problem];
+    if (checkers.size() < max_idle_checkers_) {
+        checkers.push_back(std::move(checker));
+    }
+}
+
+}
@@ -0,0 +1,98 @@
+#ifndef CHECKER_H
+#define CHECKER_H
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "exit_status.h"
+#include "file_descriptor.h"
+#include "process.h"
+
+#include "judge_result.h"
+
+namespace oj {
+
+struct CheckerVerdict {
+    ExitStatus  status;
+    std::string message;
+};
+
+class Checker {
+public:
+    ~Checker();
+    Checker (
+        const std::filesystem::path&    program,
+        const std::vector<std::string>& args = std::vector<std::string>(),
+        int                             time_limit_ms = 10000
+    );
+    Checker(const Checker& other) = delete;
+    Checker(Checker&& other) = delete;
+
+    Checker& operator=(const Checker& other) = delete;
+    Checker& operator=(Checker&& other) = delete;
+
+    CheckerVerdict               Run (
+        const std::filesystem::path& input_file,
+        const std::string&           user_answer,
+        const std::filesystem::path& answer_file
+    );
+    std::shared_ptr<JudgeResult> Check (
+        const std::filesystem::path& input_file,
+        const std::string&           user_answer,
+        const std::filesystem::path& answer_file
+    );
+    void                         Stop();
+
+    bool                         is_running() const;
+    std::filesystem::path        program() const;
+
+private:
+    void Start();
+    bool TryRun(const int (&fds)[3], CheckerVerdict& verdict);
+    bool ReadLine(std::string& line, std::chrono::steady_clock::time_point deadline);
+
+    std::filesystem::path    program_;
+    std::vector<std::string> args_;
+    int                      time_limit_ms_;
+    std::unique_ptr<Process> process_;
+    FileDescriptor           socket_;
+    std::string              buffer_;
+};
+
+class CheckerPool {
+public:
+    ~CheckerPool() = default;
+    explicit CheckerPool(size_t max_idle_checkers = 8, int time_limit_ms = 10000);
+    CheckerPool(const CheckerPool& other) = delete;
+    CheckerPool(CheckerPool&& other) = delete;
+
+    CheckerPool& operator=(const CheckerPool& other) = delete;
+    CheckerPool& operator=(CheckerPool&& other) = delete;
+
+    std::shared_ptr<JudgeResult> Check (
+        const std::string&           problem,
+        const std::filesystem::path& program,
+        const std::filesystem::path& input_file,
+        const std::string&           user_answer,
+        const std::filesystem::path& answer_file
+    );
+    void                         Clear();
+
+private:
+    std::unique_ptr<Checker> Acquire(const std::string& problem, const std::filesystem::path& program);
+    void                     Release(const std::string& problem, std::unique_ptr<Checker> checker);
+
+    size_t                                                                 max_idle_checkers_;
+    int                                                                    time_limit_ms_;
+    std::mutex                                                             mutex_;
+    std::unordered_map<std::string, std::vector<std::unique_ptr<Checker>>> idle_checkers_;
+};
+
+}
+
+#endif
@@ -0,0 +1,83 @@
+#include <stdexcept>
+
+#include <dlfcn.h>
+
+#include "checker_plugin.h"
+#include "mapped_file.h"
+
+namespace oj {
+
+CheckerPlugin::~CheckerPlugin() {
+    if (handle_ != nullptr) {
+        dlclose(handle_);
+    }
+}
+
+CheckerPlugin::CheckerPlugin(const std::filesystem::path& library) : library_(library), handle_(nullptr), entry_(nullptr) {
+    if (!std::filesystem::exists(library_)) {
+        throw std::runtime_error("ERROR::CheckerPlugin: " + library_.string() + " doesn't exist.");
+    }
+
+    handle_ = dlopen(std::filesystem::absolute(library_).string().c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (handle_ == nullptr) {
+        throw std::runtime_error("ERROR::CheckerPlugin: Failed to load " + library_.string() + ": " + dlerror());
+    }
+
+    auto version = reinterpret_cast<oj_checker_abi_version_fn>(dlsym(handle_, OJ_CHECKER_ABI_VERSION_SYMBOL));
+    if (version == nullptr || version() != OJ_CHECKER_ABI_VERSION) {
+        dlclose(handle_);
+        handle_ = nullptr;
+        throw std::runtime_error("ERROR::CheckerPlugin: " + library_.string() + " doesn't implement checker ABI version " + std::to_string(OJ_CHECKER_ABI_VERSION) + ".");
+    }
+
+    entry_ = reinterpret_cast<oj_checker_entry_fn>(dlsym(handle_, OJ_CHECKER_ENTRY_SYMBOL));
+    if (entry_ == nullptr) {
+        dlclose(handle_);
+        handle_ = nullptr;
+        throw std::runtime_error("ERROR::CheckerPlugin: " + library_.string() + " doesn't export " + OJ_CHECKER_ENTRY_SYMBOL + ".");
+    }
+}
+
+CheckerVerdict CheckerPlugin::Run(std::string_view input, std::string_view user_answer, std::string_view correct_answer) const {
+    char message[MESSAGE_CAPACITY] = {};
+    int verdict = entry_(
+        input.data(), input.size(),
+        user_answer.data(), user_answer.size(),
+        correct_answer.data(), correct_answer.size(),
+        message, sizeof(message));
+    message[MESSAGE_CAPACITY - 1] = '\0';
+
+    switch (verdict) {
+        case OJ_CHECKER_ACCEPTED:
+            return {ExitStatus::JUDGE_SUCCESS, message};
+        case OJ_CHECKER_WRONG_ANSWER:
+            return {ExitStatus::JUDGE_WRONG_ANSWER, message};
+        case OJ_CHECKER_PRESENTATION_ERROR:
+            return {ExitStatus::JUDGE_INVALID_OUTPUT_FORMAT, message};
+        default:
+            throw std::runtime_error("ERROR::CheckerPlugin: Checker " + library_.string() + " failed: " + message);
+    }
+}
+
+std::shared_ptr<JudgeResult> CheckerPlugin::Check (
+    const std::filesystem::path& input_file,
+    const std::string&           user_answer,
+    const std::filesystem::path& answer_file
+) const {
+    MappedFile input(input_file);
+    MappedFile correct_answer(answer_file);
+    CheckerVerdict verdict = Run(input.view(), user_answer, correct_answer.view());
+
+    std::string correct_answer_data;
+    std::vector<TokenJudgeData> token_data;
+    std::vector<LineJudgeData> line_data;
+    std::shared_ptr<JudgeResult> result = CreateJudgeResult(CreateExitStatus(verdict.status), user_answer, correct_answer_data, token_data, line_data);
+    result->set_message(verdict.message);
+    return result;
+}
+
+std::filesystem::path CheckerPlugin::library() const {
+    return library_;
+}
+
+}
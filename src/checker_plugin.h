@@ -0,0 +1,44 @@
+#ifndef CHECKER_PLUGIN_H
+#define CHECKER_PLUGIN_H
+
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+#include "checker.h"
+#include "checker_plugin_abi.h"
+
+#include "judge_result.h"
+
+namespace oj {
+
+class CheckerPlugin {
+public:
+    ~CheckerPlugin();
+    explicit CheckerPlugin(const std::filesystem::path& library);
+    CheckerPlugin(const CheckerPlugin& other) = delete;
+    CheckerPlugin(CheckerPlugin&& other) = delete;
+
+    CheckerPlugin& operator=(const CheckerPlugin& other) = delete;
+    CheckerPlugin& operator=(CheckerPlugin&& other) = delete;
+
+    CheckerVerdict               Run(std::string_view input, std::string_view user_answer, std::string_view correct_answer) const;
+    std::shared_ptr<JudgeResult> Check (
+        const std::filesystem::path& input_file,
+        const std::string&           user_answer,
+        const std::filesystem::path& answer_file
+    ) const;
+
+    std::filesystem::path        library() const;
+
+private:
+    static constexpr size_t MESSAGE_CAPACITY = 256;
+
+    std::filesystem::path library_;
+    void*                 handle_;
+    oj_checker_entry_fn   entry_;
+};
+
+}
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef CHECKER_PLUGIN_ABI_H
+#define CHECKER_PLUGIN_ABI_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OJ_CHECKER_ABI_VERSION        1
+#define OJ_CHECKER_ABI_VERSION_SYMBOL "oj_checker_abi_version"
+#define OJ_CHECKER_ENTRY_SYMBOL       "oj_check"
+
+enum oj_checker_verdict {
+    OJ_CHECKER_ACCEPTED            = 0,
+    OJ_CHECKER_WRONG_ANSWER        = 1,
+    OJ_CHECKER_PRESENTATION_ERROR  = 2,
+    OJ_CHECKER_FAILURE             = 3
+};
+
+typedef int (*oj_checker_abi_version_fn)(void);
+
+typedef int (*oj_checker_entry_fn)(
+    const char* input,
+    size_t      input_size,
+    const char* output,
+    size_t      output_size,
+    const char* answer,
+    size_t      answer_size,
+    char*       message,
+    size_t      message_capacity
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
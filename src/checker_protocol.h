@@ -0,0 +1,91 @@
+#ifndef CHECKER_PROTOCOL_H
+#define CHECKER_PROTOCOL_H
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include <unistd.h>
+#include <sys/socket.h>
+
+namespace oj {
+
+inline constexpr int  CHECKER_SOCKET_FD = STDIN_FILENO;
+inline constexpr int  CHECKER_REQUEST_FDS = 3;
+inline constexpr char CHECKER_REQUEST_TAG = 'C';
+
+inline bool SendCheckerRequest(int socket, const int (&fds)[CHECKER_REQUEST_FDS]) {
+    char tag = CHECKER_REQUEST_TAG;
+    iovec iov;
+    iov.iov_base = &tag;
+    iov.iov_len = sizeof(tag);
+
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(fds))];
+    std::memset(control, 0, sizeof(control));
+
+    msghdr message;
+    std::memset(&message, 0, sizeof(message));
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    cmsghdr* header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_SOCKET;
+    header->cmsg_type = SCM_RIGHTS;
+    header->cmsg_len = CMSG_LEN(sizeof(fds));
+    std::memcpy(CMSG_DATA(header), fds, sizeof(fds));
+
+    ssize_t bytes;
+    while ((bytes = sendmsg(socket, &message, MSG_NOSIGNAL)) == -1 && errno == EINTR) {}
+    return bytes == sizeof(tag);
+}
+
+inline bool ReceiveCheckerRequest(int socket, int (&fds)[CHECKER_REQUEST_FDS]) {
+    char tag;
+    iovec iov;
+    iov.iov_base = &tag;
+    iov.iov_len = sizeof(tag);
+
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(fds))];
+
+    msghdr message;
+    std::memset(&message, 0, sizeof(message));
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    ssize_t bytes;
+    while ((bytes = recvmsg(socket, &message, MSG_CMSG_CLOEXEC)) == -1 && errno == EINTR) {}
+    if (bytes != sizeof(tag) || tag != CHECKER_REQUEST_TAG) {
+        return false;
+    }
+
+    cmsghdr* header = CMSG_FIRSTHDR(&message);
+    if (header == nullptr || header->cmsg_type != SCM_RIGHTS || header->cmsg_len != CMSG_LEN(sizeof(fds))) {
+        return false;
+    }
+    std::memcpy(fds, CMSG_DATA(header), sizeof(fds));
+    return true;
+}
+
+inline bool SendCheckerVerdict(int socket, const std::string& verdict, const std::string& message = std::string()) {
+    std::string line = verdict + ' ' + message + '\n';
+    size_t total_bytes = 0;
+    while (total_bytes < line.size()) {
+        ssize_t bytes = send(socket, line.data() + total_bytes, line.size() - total_bytes, MSG_NOSIGNAL);
+        if (bytes == -1 && errno == EINTR) {
+            continue;
+        }
+        if (bytes <= 0) {
+            return false;
+        }
+        total_bytes += bytes;
+    }
+    return true;
+}
+
+}
+
+#endif
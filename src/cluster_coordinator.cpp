@@ -0,0 +1,517 @@
+#include <algorithm>
+#include <cerrno>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <system_error>
+
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/random.h>
+#include <sys/socket.h>
+
+#include "answer_index.h"
+#include "cluster_coordinator.h"
+#include "mapped_file.h"
+#include "metrics.h"
+#include "sha256.h"
+
+namespace oj {
+
+namespace {
+
+constexpr int KEEPALIVE_IDLE_SEC = 10;
+constexpr int KEEPALIVE_INTERVAL_SEC = 5;
+constexpr int KEEPALIVE_COUNT = 3;
+constexpr size_t CHALLENGE_SIZE = 32;
+constexpr int HANDSHAKE_TIMEOUT_SEC = 10;
+
+void SetSocketOptions(int socket) {
+    int enable = 1;
+    int idle = KEEPALIVE_IDLE_SEC;
+    int interval = KEEPALIVE_INTERVAL_SEC;
+    int count = KEEPALIVE_COUNT;
+    setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    setsockopt(socket, SOL_SOCKET, SO_KEEPALIVE, &enable, sizeof(enable));
+    setsockopt(socket, IPPROTO_TCP, TCP_KEEPIDLE, &idle, sizeof(idle));
+    setsockopt(socket, IPPROTO_TCP, TCP_KEEPINTVL, &interval, sizeof(interval));
+    setsockopt(socket, IPPROTO_TCP, TCP_KEEPCNT, &count, sizeof(count));
+}
+
+void SetSocketTimeout(int socket, int timeout_sec) {
+    timeval timeout = {timeout_sec, 0};
+    setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+}
+
+std::string CreateChallenge() {
+    std::string challenge(CHALLENGE_SIZE, '\0');
+    size_t filled = 0;
+    while (filled < challenge.size()) {
+        ssize_t bytes = getrandom(challenge.data() + filled, challenge.size() - filled, 0);
+        if (bytes == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "ERROR::ClusterCoordinator: Failed to create a challenge.");
+        }
+        filled += bytes;
+    }
+    return challenge;
+}
+
+}
+
+ClusterCoordinator::~ClusterCoordinator() {
+    Close();
+    close(listen_socket_);
+}
+
+ClusterCoordinator::ClusterCoordinator (
+    uint16_t           port,
+    const std::string& address,
+    const std::string& secret,
+    size_t             max_attempts,
+    size_t             queue_capacity,
+    OfflineJudge&      judge
+) : judge_(judge),
+    secret_(secret),
+    max_attempts_(std::max<size_t>(max_attempts, 1)),
+    rescheduled_counter_(nullptr),
+    listen_socket_(-1),
+    port_(0),
+    compile_queue_(queue_capacity),
+    next_task_id_(0),
+    rescheduled_(0),
+    is_closed_(false) {
+    sockaddr_in listen_address = {};
+    listen_address.sin_family = AF_INET;
+    listen_address.sin_port = htons(port);
+    if (inet_pton(AF_INET, address.c_str(), &listen_address.sin_addr) != 1) {
+        throw std::invalid_argument("ERROR::ClusterCoordinator: Invalid listen address " + address + ".");
+    }
+    if (secret_.empty() && (ntohl(listen_address.sin_addr.s_addr) >> 24) != 127) {
+        throw std::invalid_argument("ERROR::ClusterCoordinator: Listening on " + address + " requires a shared secret.");
+    }
+
+    listen_socket_ = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_socket_ == -1) {
+        throw std::system_error(errno, std::generic_category(), "ERROR::ClusterCoordinator: Failed to open a socket.");
+    }
+
+    int enable = 1;
+    setsockopt(listen_socket_, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+    socklen_t address_size = sizeof(listen_address);
+    if (bind(listen_socket_, reinterpret_cast<sockaddr*>(&listen_address), sizeof(listen_address)) == -1 ||
+        listen(listen_socket_, SOMAXCONN) == -1 ||
+        getsockname(listen_socket_, reinterpret_cast<sockaddr*>(&listen_address), &address_size) == -1) {
+        int error = errno;
+        close(listen_socket_);
+        throw std::system_error(error, std::generic_category(), "ERROR::ClusterCoordinator: Failed to listen on " + address + ":" + std::to_string(port) + ".");
+    }
+    port_ = ntohs(listen_address.sin_port);
+
+    accept_worker_ = std::thread(&ClusterCoordinator::AcceptLoop, this);
+    compile_worker_ = std::thread(&ClusterCoordinator::CompileLoop, this);
+    dispatch_worker_ = std::thread(&ClusterCoordinator::DispatchLoop, this);
+
+    Metrics& metrics = Metrics::GetInstance();
+    std::string coordinator = "coordinator=\"" + std::to_string(port_) + "\"";
+    rescheduled_counter_ = &metrics.GetCounter("oj_cluster_rescheduled_total", "Tasks rescheduled after losing a worker.", coordinator);
+    metric_callbacks_ = {
+        metrics.AddCallback("oj_cluster_workers", "Workers connected to a coordinator.", coordinator, [this]() { return workers(); }),
+        metrics.AddCallback("oj_queue_depth", "Items waiting in a pipeline queue.", coordinator + ",queue=\"compile\"", [this]() { return compile_queue_.size(); }),
+        metrics.AddCallback("oj_queue_depth", "Items waiting in a pipeline queue.", coordinator + ",queue=\"dispatch\"", [this]() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return pending_.size();
+        })
+    };
+}
+
+std::future<std::shared_ptr<SubmissionResult>> ClusterCoordinator::Submit(PipelineSubmission submission) {
+    std::shared_ptr<Job> job = std::make_shared<Job>();
+    job->submission = std::move(submission);
+    job->remaining = job->submission.test_cases.size();
+    job->is_failed = false;
+
+    std::future<std::shared_ptr<SubmissionResult>> result = job->promise.get_future();
+    compile_queue_.Push(job);
+    return result;
+}
+
+void ClusterCoordinator::Close() {
+    std::lock_guard<std::mutex> close_lock(close_mutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (is_closed_) {
+            return;
+        }
+        is_closed_ = true;
+    }
+
+    for (size_t id : metric_callbacks_) {
+        Metrics::GetInstance().RemoveCallback(id);
+    }
+
+    compile_queue_.Close();
+    compile_worker_.join();
+
+    shutdown(listen_socket_, SHUT_RDWR);
+    accept_worker_.join();
+
+    std::vector<std::shared_ptr<Node>> nodes;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        nodes = nodes_;
+    }
+    for (const std::shared_ptr<Node>& node : nodes) {
+        std::lock_guard<std::mutex> send_lock(node->send_mutex);
+        if (node->socket != -1) {
+            shutdown(node->socket, SHUT_RDWR);
+        }
+    }
+
+    dispatch_.notify_all();
+    dispatch_worker_.join();
+    for (std::thread& worker : receive_workers_) {
+        worker.join();
+    }
+
+    std::deque<Task> pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending.swap(pending_);
+    }
+    for (const Task& task : pending) {
+        Fail(task.job, std::make_exception_ptr(std::runtime_error("ERROR::ClusterCoordinator: Closed before a submission finished.")));
+    }
+}
+
+uint16_t ClusterCoordinator::port() const {
+    return port_;
+}
+
+size_t ClusterCoordinator::workers() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return nodes_.size();
+}
+
+size_t ClusterCoordinator::rescheduled() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return rescheduled_;
+}
+
+void ClusterCoordinator::Fail(const std::shared_ptr<Job>& job, std::exception_ptr error) {
+    if (!job->is_failed.exchange(true)) {
+        job->promise.set_exception(error);
+    }
+}
+
+void ClusterCoordinator::AcceptLoop() {
+    while (true) {
+        int socket = accept4(listen_socket_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (socket == -1) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            return;
+        }
+        SetSocketOptions(socket);
+
+        std::vector<std::thread::id> finished;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (is_closed_) {
+                close(socket);
+                return;
+            }
+            finished.swap(finished_receivers_);
+        }
+        for (std::thread::id id : finished) {
+            auto worker = std::find_if(receive_workers_.begin(), receive_workers_.end(), [id](const std::thread& thread) { return thread.get_id() == id; });
+            if (worker != receive_workers_.end()) {
+                worker->join();
+                receive_workers_.erase(worker);
+            }
+        }
+        receive_workers_.emplace_back(&ClusterCoordinator::ReceiveLoop, this, socket);
+    }
+}
+
+void ClusterCoordinator::CompileLoop() {
+    while (std::optional<std::shared_ptr<Job>> job = compile_queue_.Pop()) {
+        try {
+            const PipelineSubmission& submission = (*job)->submission;
+            (*job)->compilation_result = judge_.CompileWithProfile(
+                submission.profile,
+                submission.source,
+                submission.target,
+                submission.compiler,
+                submission.compile_options
+            );
+            if (!(*job)->compilation_result->is_success() || submission.test_cases.empty()) {
+                Finish(*job);
+                continue;
+            }
+
+            MappedFile binary(submission.target);
+            (*job)->binary = std::make_shared<const std::string>(binary.view());
+            (*job)->binary_digest = Sha256Hex(*(*job)->binary);
+            (*job)->execution_results.resize(submission.test_cases.size());
+            (*job)->judge_results.resize(submission.test_cases.size());
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (size_t i = 0; i < submission.test_cases.size(); ++i) {
+                pending_.push_back({*job, i, 0, nullptr, {}});
+            }
+            dispatch_.notify_all();
+        } catch (...) {
+            Fail(*job, std::current_exception());
+        }
+    }
+}
+
+void ClusterCoordinator::DispatchLoop() {
+    while (true) {
+        std::shared_ptr<Node> node;
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            dispatch_.wait(lock, [&]() { return is_closed_ || (!pending_.empty() && (node = FindIdleNode()) != nullptr); });
+            if (is_closed_) {
+                return;
+            }
+            task = std::move(pending_.front());
+            pending_.pop_front();
+        }
+        if (task.job->is_failed) {
+            continue;
+        }
+
+        try {
+            if (task.input == nullptr) {
+                const PipelineTestCase& test_case = task.job->submission.test_cases[task.test_index];
+                MappedFile input(test_case.input_file);
+                AnswerIndex answer_index(test_case.answer_file);
+                task.input = std::make_shared<const std::string>(input.view());
+                task.expected_output = {answer_index.answer().size(), answer_index.raw_hash(), answer_index.normalized_hash(), false, std::string_view()};
+            }
+        } catch (...) {
+            Fail(task.job, std::current_exception());
+            continue;
+        }
+
+        ClusterTask request;
+        bool is_binary_needed;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (node->is_lost) {
+                pending_.push_front(std::move(task));
+                continue;
+            }
+            const PipelineSubmission& submission = task.job->submission;
+            request = {next_task_id_++, task.job->binary_digest, submission.time_limit_sec, submission.time_limit_usec, submission.memory_limit_mb, std::string(), task.expected_output};
+            is_binary_needed = node->binaries.insert(task.job->binary_digest).second;
+            ++task.attempts;
+            node->in_flight.emplace(request.id, task);
+        }
+
+        request.input = *task.input;
+        bool is_sent;
+        try {
+            std::lock_guard<std::mutex> send_lock(node->send_mutex);
+            is_sent = node->socket != -1 &&
+                      (!is_binary_needed || SendFrame(node->socket, ClusterMessage::BINARY, EncodeBinary(task.job->binary_digest, *task.job->binary))) &&
+                      SendFrame(node->socket, ClusterMessage::TASK, EncodeTask(request));
+        } catch (...) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                node->in_flight.erase(request.id);
+                if (is_binary_needed) {
+                    node->binaries.erase(task.job->binary_digest);
+                }
+            }
+            dispatch_.notify_all();
+            Fail(task.job, std::current_exception());
+            continue;
+        }
+        if (!is_sent) {
+            Lose(node);
+        }
+    }
+}
+
+void ClusterCoordinator::ReceiveLoop(int socket) {
+    std::shared_ptr<Node> node = std::make_shared<Node>();
+    node->socket = socket;
+    node->slots = 1;
+    node->is_lost = false;
+
+    try {
+        SetSocketTimeout(socket, HANDSHAKE_TIMEOUT_SEC);
+        Authenticate(socket, *node);
+        SetSocketTimeout(socket, 0);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (is_closed_) {
+                throw std::runtime_error("ERROR::ClusterCoordinator: Closed.");
+            }
+            nodes_.push_back(node);
+        }
+        dispatch_.notify_all();
+
+        ClusterMessage type;
+        std::string payload;
+        while (ReceiveFrame(socket, type, payload)) {
+            if (type != ClusterMessage::RESULT) {
+                throw std::runtime_error("ERROR::ClusterCoordinator: Unexpected message from " + node->name + ".");
+            }
+            ClusterResult result = DecodeResult(payload);
+
+            std::optional<Task> task;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto in_flight = node->in_flight.find(result.id);
+                if (in_flight != node->in_flight.end()) {
+                    task = std::move(in_flight->second);
+                    node->in_flight.erase(in_flight);
+                }
+            }
+            if (task.has_value()) {
+                dispatch_.notify_all();
+                Complete(*task, result);
+            }
+        }
+    } catch (...) {}
+
+    Lose(node);
+    {
+        std::lock_guard<std::mutex> send_lock(node->send_mutex);
+        close(node->socket);
+        node->socket = -1;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    finished_receivers_.push_back(std::this_thread::get_id());
+}
+
+void ClusterCoordinator::Authenticate(int socket, Node& node) {
+    std::string challenge = CreateChallenge();
+    if (!SendFrame(socket, ClusterMessage::CHALLENGE, challenge)) {
+        throw std::runtime_error("ERROR::ClusterCoordinator: Failed to challenge a worker.");
+    }
+
+    ClusterMessage type;
+    std::string payload;
+    if (!ReceiveFrame(socket, type, payload, CLUSTER_MAX_HELLO_SIZE) || type != ClusterMessage::HELLO) {
+        throw std::runtime_error("ERROR::ClusterCoordinator: Worker didn't greet.");
+    }
+    ClusterHello hello = DecodeHello(payload);
+    if (hello.version != CLUSTER_PROTOCOL_VERSION) {
+        throw std::runtime_error("ERROR::ClusterCoordinator: Worker " + hello.name + " speaks another protocol version.");
+    }
+    Sha256::Digest proof = {};
+    if (hello.proof.size() != proof.size()) {
+        throw std::runtime_error("ERROR::ClusterCoordinator: Worker " + hello.name + " failed to authenticate.");
+    }
+    std::copy(hello.proof.begin(), hello.proof.end(), proof.begin());
+    if (!IsDigestEqual(proof, HmacSha256(secret_, challenge))) {
+        throw std::runtime_error("ERROR::ClusterCoordinator: Worker " + hello.name + " failed to authenticate.");
+    }
+
+    node.name = hello.name;
+    node.slots = std::max<uint32_t>(hello.slots, 1);
+    for (std::string& digest : hello.binaries) {
+        if (IsSha256Hex(digest)) {
+            node.binaries.insert(std::move(digest));
+        }
+    }
+}
+
+void ClusterCoordinator::Complete(const Task& task, const ClusterResult& result) {
+    const PipelineSubmission& submission = task.job->submission;
+    try {
+        std::shared_ptr<ExecutionResult> execution_result = CreateExecutionResult(result.status, submission.target, *task.input, result.output, result.usage);
+        execution_result->set_status(result.status);
+        execution_result->set_startup_time_usec(result.startup_time_usec);
+        execution_result->set_output_hash(result.output_hash);
+        execution_result->set_output_matched(result.is_output_matched);
+
+        std::shared_ptr<JudgeResult> judge_result;
+        if (execution_result->is_success()) {
+            judge_result = judge_.JudgeExecution(*execution_result, submission.test_cases[task.test_index].answer_file);
+        }
+        task.job->execution_results[task.test_index] = std::move(execution_result);
+        task.job->judge_results[task.test_index] = std::move(judge_result);
+    } catch (...) {
+        Fail(task.job, std::current_exception());
+        return;
+    }
+
+    if (--task.job->remaining == 0) {
+        Finish(task.job);
+    }
+}
+
+void ClusterCoordinator::Lose(const std::shared_ptr<Node>& node) {
+    std::vector<std::shared_ptr<Job>> failed_jobs;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (node->is_lost) {
+            return;
+        }
+        node->is_lost = true;
+        nodes_.erase(std::remove(nodes_.begin(), nodes_.end(), node), nodes_.end());
+        for (auto& [id, task] : node->in_flight) {
+            if (task.attempts >= max_attempts_) {
+                failed_jobs.push_back(task.job);
+            } else {
+                pending_.push_front(std::move(task));
+                ++rescheduled_;
+                rescheduled_counter_->Add();
+            }
+        }
+        node->in_flight.clear();
+    }
+
+    {
+        std::lock_guard<std::mutex> send_lock(node->send_mutex);
+        if (node->socket != -1) {
+            shutdown(node->socket, SHUT_RDWR);
+        }
+    }
+    dispatch_.notify_all();
+
+    for (const std::shared_ptr<Job>& job : failed_jobs) {
+        Fail(job, std::make_exception_ptr(std::runtime_error("ERROR::ClusterCoordinator: Lost every worker that ran a test of " + job->submission.target.string() + ".")));
+    }
+}
+
+void ClusterCoordinator::Finish(const std::shared_ptr<Job>& job) {
+    try {
+        if (!job->is_failed.exchange(true)) {
+            job->promise.set_value(judge_.Submit(job->compilation_result, job->execution_results, job->judge_results));
+        }
+    } catch (...) {
+        job->promise.set_exception(std::current_exception());
+    }
+}
+
+std::shared_ptr<ClusterCoordinator::Node> ClusterCoordinator::FindIdleNode() const {
+    std::shared_ptr<Node> idle_node;
+    for (const std::shared_ptr<Node>& node : nodes_) {
+        if (node->in_flight.size() >= node->slots) {
+            continue;
+        }
+        if (idle_node == nullptr || node->in_flight.size() * idle_node->slots < idle_node->in_flight.size() * node->slots) {
+            idle_node = node;
+        }
+    }
+    return idle_node;
+}
+
+}
@@ -0,0 +1,125 @@
+#ifndef CLUSTER_COORDINATOR_H
+#define CLUSTER_COORDINATOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "bounded_queue.h"
+#include "cluster_protocol.h"
+#include "metrics.h"
+#include "offline_judge.h"
+#include "pipeline.h"
+
+#include "compilation_result.h"
+#include "execution_result.h"
+#include "judge_result.h"
+#include "submission_result.h"
+
+namespace oj {
+
+class ClusterCoordinator {
+public:
+    ~ClusterCoordinator();
+    explicit ClusterCoordinator (
+        uint16_t           port = 0,
+        const std::string& address = "127.0.0.1",
+        const std::string& secret = std::string(),
+        size_t             max_attempts = 3,
+        size_t             queue_capacity = 64,
+        OfflineJudge&      judge = OfflineJudge::GetInstance()
+    );
+    ClusterCoordinator(const ClusterCoordinator& other) = delete;
+    ClusterCoordinator(ClusterCoordinator&& other) = delete;
+
+    ClusterCoordinator& operator=(const ClusterCoordinator& other) = delete;
+    ClusterCoordinator& operator=(ClusterCoordinator&& other) = delete;
+
+    std::future<std::shared_ptr<SubmissionResult>> Submit(PipelineSubmission submission);
+    void                                           Close();
+
+    uint16_t                                       port() const;
+    size_t                                         workers() const;
+    size_t                                         rescheduled() const;
+
+private:
+    struct Job {
+        PipelineSubmission                              submission;
+        std::shared_ptr<CompilationResult>              compilation_result;
+        std::shared_ptr<const std::string>              binary;
+        std::string                                     binary_digest;
+        std::vector<std::shared_ptr<ExecutionResult>>   execution_results;
+        std::vector<std::shared_ptr<JudgeResult>>       judge_results;
+        std::atomic<size_t>                             remaining;
+        std::atomic<bool>                               is_failed;
+        std::promise<std::shared_ptr<SubmissionResult>> promise;
+    };
+
+    struct Task {
+        std::shared_ptr<Job>               job;
+        size_t                             test_index;
+        size_t                             attempts;
+        std::shared_ptr<const std::string> input;
+        ExpectedOutput                     expected_output;
+    };
+
+    struct Node {
+        int                                socket;
+        std::string                        name;
+        size_t                             slots;
+        std::unordered_set<std::string>    binaries;
+        std::unordered_map<uint64_t, Task> in_flight;
+        bool                               is_lost;
+        std::mutex                         send_mutex;
+    };
+
+    static void Fail(const std::shared_ptr<Job>& job, std::exception_ptr error);
+
+    void AcceptLoop();
+    void CompileLoop();
+    void DispatchLoop();
+    void ReceiveLoop(int socket);
+    void Authenticate(int socket, Node& node);
+    void Complete(const Task& task, const ClusterResult& result);
+    void Lose(const std::shared_ptr<Node>& node);
+    void Finish(const std::shared_ptr<Job>& job);
+
+    std::shared_ptr<Node> FindIdleNode() const;
+
+    OfflineJudge&                      judge_;
+    std::string                        secret_;
+    size_t                             max_attempts_;
+    Counter*                           rescheduled_counter_;
+    std::vector<size_t>                metric_callbacks_;
+    int                                listen_socket_;
+    uint16_t                           port_;
+    BoundedQueue<std::shared_ptr<Job>> compile_queue_;
+
+    mutable std::mutex                 mutex_;
+    std::condition_variable            dispatch_;
+    std::deque<Task>                   pending_;
+    std::vector<std::shared_ptr<Node>> nodes_;
+    uint64_t                           next_task_id_;
+    size_t                             rescheduled_;
+    bool                               is_closed_;
+    std::vector<std::thread::id>       finished_receivers_;
+
+    std::mutex                         close_mutex_;
+    std::thread                        accept_worker_;
+    std::thread                        compile_worker_;
+    std::thread                        dispatch_worker_;
+    std::vector<std::thread>           receive_workers_;
+};
+
+}
+
+#endif
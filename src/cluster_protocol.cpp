@@ -0,0 +1,274 @@
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+
+#include <sys/socket.h>
+
+#include "cluster_protocol.h"
+
+namespace oj {
+
+namespace {
+
+bool SendAll(int socket, const char* data, size_t size, int flags) {
+    while (size > 0) {
+        ssize_t bytes = send(socket, data, size, flags | MSG_NOSIGNAL);
+        if (bytes == -1 && errno == EINTR) {
+            continue;
+        }
+        if (bytes <= 0) {
+            return false;
+        }
+        data += bytes;
+        size -= bytes;
+    }
+    return true;
+}
+
+bool ReceiveAll(int socket, char* data, size_t size) {
+    while (size > 0) {
+        ssize_t bytes = recv(socket, data, size, 0);
+        if (bytes == -1 && errno == EINTR) {
+            continue;
+        }
+        if (bytes <= 0) {
+            return false;
+        }
+        data += bytes;
+        size -= bytes;
+    }
+    return true;
+}
+
+void PutTime(FrameWriter& writer, const timeval& time) {
+    writer.PutI64(time.tv_sec);
+    writer.PutI64(time.tv_usec);
+}
+
+timeval GetTime(FrameReader& reader) {
+    timeval time;
+    time.tv_sec = reader.GetI64();
+    time.tv_usec = reader.GetI64();
+    return time;
+}
+
+}
+
+void FrameWriter::PutU8(uint8_t value) {
+    data_.push_back(static_cast<char>(value));
+}
+
+void FrameWriter::PutU32(uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        data_.push_back(static_cast<char>(value >> shift));
+    }
+}
+
+void FrameWriter::PutU64(uint64_t value) {
+    for (int shift = 0; shift < 64; shift += 8) {
+        data_.push_back(static_cast<char>(value >> shift));
+    }
+}
+
+void FrameWriter::PutI64(int64_t value) {
+    PutU64(static_cast<uint64_t>(value));
+}
+
+void FrameWriter::PutString(std::string_view value) {
+    PutU64(value.size());
+    data_.append(value.data(), value.size());
+}
+
+const std::string& FrameWriter::data() const {
+    return data_;
+}
+
+FrameReader::FrameReader(std::string_view data) : data_(data), pos_(0) {}
+
+uint8_t FrameReader::GetU8() {
+    return static_cast<uint8_t>(Take(1)[0]);
+}
+
+uint32_t FrameReader::GetU32() {
+    std::string_view bytes = Take(4);
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; --i) {
+        value = value << 8 | static_cast<unsigned char>(bytes[i]);
+    }
+    return value;
+}
+
+uint64_t FrameReader::GetU64() {
+    std::string_view bytes = Take(8);
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) {
+        value = value << 8 | static_cast<unsigned char>(bytes[i]);
+    }
+    return value;
+}
+
+int64_t FrameReader::GetI64() {
+    return static_cast<int64_t>(GetU64());
+}
+
+std::string FrameReader::GetString() {
+    uint64_t size = GetU64();
+    if (size > data_.size() - pos_) {
+        throw std::runtime_error("ERROR::FrameReader: Truncated frame.");
+    }
+    return std::string(Take(size));
+}
+
+bool FrameReader::is_end() const {
+    return pos_ == data_.size();
+}
+
+std::string_view FrameReader::Take(size_t size) {
+    if (size > data_.size() - pos_) {
+        throw std::runtime_error("ERROR::FrameReader: Truncated frame.");
+    }
+    std::string_view bytes = data_.substr(pos_, size);
+    pos_ += size;
+    return bytes;
+}
+
+bool SendFrame(int socket, ClusterMessage type, std::string_view payload) {
+    if (payload.size() > CLUSTER_MAX_FRAME_SIZE) {
+        throw std::runtime_error("ERROR::ClusterProtocol: Frame is too large.");
+    }
+
+    FrameWriter header;
+    header.PutU32(static_cast<uint32_t>(type));
+    header.PutU32(static_cast<uint32_t>(payload.size()));
+    return SendAll(socket, header.data().data(), header.data().size(), payload.empty() ? 0 : MSG_MORE) &&
+           SendAll(socket, payload.data(), payload.size(), 0);
+}
+
+bool ReceiveFrame(int socket, ClusterMessage& type, std::string& payload, uint32_t max_size) {
+    char header[8];
+    if (!ReceiveAll(socket, header, sizeof(header))) {
+        return false;
+    }
+
+    FrameReader reader(std::string_view(header, sizeof(header)));
+    type = static_cast<ClusterMessage>(reader.GetU32());
+    uint32_t size = reader.GetU32();
+    if (size > std::min(max_size, CLUSTER_MAX_FRAME_SIZE)) {
+        return false;
+    }
+
+    payload.resize(size);
+    return ReceiveAll(socket, payload.data(), payload.size());
+}
+
+std::string EncodeHello(const ClusterHello& hello) {
+    FrameWriter writer;
+    writer.PutU32(hello.version);
+    writer.PutU32(hello.slots);
+    writer.PutString(hello.name);
+    writer.PutU64(hello.binaries.size());
+    for (const std::string& digest : hello.binaries) {
+        writer.PutString(digest);
+    }
+    writer.PutString(hello.proof);
+    return writer.data();
+}
+
+ClusterHello DecodeHello(std::string_view payload) {
+    FrameReader reader(payload);
+    ClusterHello hello;
+    hello.version = reader.GetU32();
+    hello.slots = reader.GetU32();
+    hello.name = reader.GetString();
+    uint64_t count = reader.GetU64();
+    for (uint64_t i = 0; i < count; ++i) {
+        hello.binaries.push_back(reader.GetString());
+    }
+    hello.proof = reader.GetString();
+    return hello;
+}
+
+std::string EncodeBinary(std::string_view digest, std::string_view data) {
+    FrameWriter writer;
+    writer.PutString(digest);
+    writer.PutString(data);
+    return writer.data();
+}
+
+ClusterBinary DecodeBinary(std::string_view payload) {
+    FrameReader reader(payload);
+    ClusterBinary binary;
+    binary.digest = reader.GetString();
+    binary.data = reader.GetString();
+    return binary;
+}
+
+std::string EncodeTask(const ClusterTask& task) {
+    FrameWriter writer;
+    writer.PutU64(task.id);
+    writer.PutString(task.binary_digest);
+    writer.PutU32(static_cast<uint32_t>(task.time_limit_sec));
+    writer.PutU32(static_cast<uint32_t>(task.time_limit_usec));
+    writer.PutU32(static_cast<uint32_t>(task.memory_limit_mb));
+    writer.PutString(task.input);
+    writer.PutU64(task.expected_output.size);
+    writer.PutU64(task.expected_output.raw_hash);
+    writer.PutU64(task.expected_output.normalized_hash);
+    writer.PutU8(task.expected_output.is_whitespace_insensitive);
+    return writer.data();
+}
+
+ClusterTask DecodeTask(std::string_view payload) {
+    FrameReader reader(payload);
+    ClusterTask task;
+    task.id = reader.GetU64();
+    task.binary_digest = reader.GetString();
+    task.time_limit_sec = static_cast<int32_t>(reader.GetU32());
+    task.time_limit_usec = static_cast<int32_t>(reader.GetU32());
+    task.memory_limit_mb = static_cast<int32_t>(reader.GetU32());
+    task.input = reader.GetString();
+    task.expected_output.size = reader.GetU64();
+    task.expected_output.raw_hash = reader.GetU64();
+    task.expected_output.normalized_hash = reader.GetU64();
+    task.expected_output.is_whitespace_insensitive = reader.GetU8() != 0;
+    return task;
+}
+
+std::string EncodeResult(const ClusterResult& result) {
+    FrameWriter writer;
+    writer.PutU64(result.id);
+    writer.PutU32(static_cast<uint32_t>(result.status));
+    writer.PutString(result.output);
+    PutTime(writer, result.usage.ru_utime);
+    PutTime(writer, result.usage.ru_stime);
+    writer.PutI64(result.usage.ru_maxrss);
+    writer.PutI64(result.usage.ru_minflt);
+    writer.PutI64(result.usage.ru_majflt);
+    writer.PutI64(result.usage.ru_nvcsw);
+    writer.PutI64(result.usage.ru_nivcsw);
+    writer.PutI64(result.startup_time_usec);
+    writer.PutU64(result.output_hash);
+    writer.PutU8(result.is_output_matched);
+    return writer.data();
+}
+
+ClusterResult DecodeResult(std::string_view payload) {
+    FrameReader reader(payload);
+    ClusterResult result = {};
+    result.id = reader.GetU64();
+    result.status = static_cast<int32_t>(reader.GetU32());
+    result.output = reader.GetString();
+    result.usage.ru_utime = GetTime(reader);
+    result.usage.ru_stime = GetTime(reader);
+    result.usage.ru_maxrss = reader.GetI64();
+    result.usage.ru_minflt = reader.GetI64();
+    result.usage.ru_majflt = reader.GetI64();
+    result.usage.ru_nvcsw = reader.GetI64();
+    result.usage.ru_nivcsw = reader.GetI64();
+    result.startup_time_usec = reader.GetI64();
+    result.output_hash = reader.GetU64();
+    result.is_output_matched = reader.GetU8() != 0;
+    return result;
+}
+
+}
@@ -0,0 +1,107 @@
+#ifndef CLUSTER_PROTOCOL_H
+#define CLUSTER_PROTOCOL_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "supervisor.h"
+
+namespace oj {
+
+inline constexpr uint32_t CLUSTER_PROTOCOL_VERSION = 2;
+inline constexpr uint32_t CLUSTER_MAX_FRAME_SIZE = 1U << 30;
+inline constexpr uint32_t CLUSTER_MAX_HELLO_SIZE = 1U << 24;
+
+enum class ClusterMessage : uint32_t {
+    HELLO     = 1,
+    BINARY    = 2,
+    TASK      = 3,
+    RESULT    = 4,
+    CHALLENGE = 5
+};
+
+struct ClusterHello {
+    uint32_t                 version;
+    uint32_t                 slots;
+    std::string              name;
+    std::vector<std::string> binaries;
+    std::string              proof;
+};
+
+struct ClusterBinary {
+    std::string digest;
+    std::string data;
+};
+
+struct ClusterTask {
+    uint64_t       id;
+    std::string    binary_digest;
+    int32_t        time_limit_sec;
+    int32_t        time_limit_usec;
+    int32_t        memory_limit_mb;
+    std::string    input;
+    ExpectedOutput expected_output;
+};
+
+struct ClusterResult {
+    uint64_t    id;
+    int32_t     status;
+    std::string output;
+    rusage      usage;
+    int64_t     startup_time_usec;
+    uint64_t    output_hash;
+    bool        is_output_matched;
+};
+
+class FrameWriter {
+public:
+    void               PutU8(uint8_t value);
+    void               PutU32(uint32_t value);
+    void               PutU64(uint64_t value);
+    void               PutI64(int64_t value);
+    void               PutString(std::string_view value);
+
+    const std::string& data() const;
+
+private:
+    std::string data_;
+};
+
+class FrameReader {
+public:
+    explicit FrameReader(std::string_view data);
+
+    uint8_t            GetU8();
+    uint32_t           GetU32();
+    uint64_t           GetU64();
+    int64_t            GetI64();
+    std::string        GetString();
+
+    bool               is_end() const;
+
+private:
+    std::string_view Take(size_t size);
+
+    std::string_view data_;
+    size_t           pos_;
+};
+
+bool          SendFrame(int socket, ClusterMessage type, std::string_view payload);
+bool          ReceiveFrame(int socket, ClusterMessage& type, std::string& payload, uint32_t max_size = CLUSTER_MAX_FRAME_SIZE);
+
+std::string   EncodeHello(const ClusterHello& hello);
+ClusterHello  DecodeHello(std::string_view payload);
+std::string   EncodeBinary(std::string_view digest, std::string_view data);
+ClusterBinary DecodeBinary(std::string_view payload);
+std::string   EncodeTask(const ClusterTask& task);
+ClusterTask   DecodeTask(std::string_view payload);
+std::string   EncodeResult(const ClusterResult& result);
+ClusterResult DecodeResult(std::string_view payload);
+
+}
+
+#endif
@@ -0,0 +1,224 @@
+#include <cerrno>
+#include <exception>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include <netdb.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include "cluster_worker.h"
+#include "exit_status.h"
+#include "sha256.h"
+
+#include "execution_result.h"
+
+namespace oj {
+
+ClusterWorker::~ClusterWorker() {
+    Stop();
+}
+
+ClusterWorker::ClusterWorker (
+    const std::filesystem::path& cache_dir,
+    const std::string&           secret,
+    size_t                       slots,
+    OfflineJudge&                judge
+) : judge_(judge),
+    cache_dir_(cache_dir),
+    secret_(secret),
+    slots_(slots != 0 ? slots : std::max(1u, std::thread::hardware_concurrency())),
+    socket_(-1),
+    is_stopped_(false) {
+    std::filesystem::create_directories(cache_dir_);
+}
+
+void ClusterWorker::Run(const std::string& host, uint16_t port) {
+    is_stopped_ = false;
+    int socket = Connect(host, port);
+    socket_ = socket;
+
+    ClusterMessage type;
+    std::string payload;
+    bool is_challenged = !is_stopped_ && ReceiveFrame(socket, type, payload, CLUSTER_MAX_HELLO_SIZE) && type == ClusterMessage::CHALLENGE;
+
+    char hostname[256] = {};
+    gethostname(hostname, sizeof(hostname) - 1);
+    Sha256::Digest proof = HmacSha256(secret_, payload);
+    ClusterHello hello = {CLUSTER_PROTOCOL_VERSION, static_cast<uint32_t>(slots_), std::string(hostname) + ":" + std::to_string(getpid()), ListBinaries(), std::string(proof.begin(), proof.end())};
+    if (is_stopped_ || !is_challenged || !Send(socket, ClusterMessage::HELLO, EncodeHello(hello))) {
+        socket_ = -1;
+        close(socket);
+        if (is_stopped_) {
+            return;
+        }
+        throw std::runtime_error("ERROR::ClusterWorker: Failed to greet a coordinator at " + host + ":" + std::to_string(port) + ".");
+    }
+
+    BoundedQueue<ClusterTask> tasks(slots_);
+    std::vector<std::thread> executors;
+    for (size_t i = 0; i < slots_; ++i) {
+        executors.emplace_back(&ClusterWorker::ExecuteLoop, this, socket, std::ref(tasks));
+    }
+
+    std::exception_ptr error;
+    try {
+        while (ReceiveFrame(socket, type, payload)) {
+            if (type == ClusterMessage::BINARY) {
+                ClusterBinary binary = DecodeBinary(payload);
+                if (Sha256Hex(binary.data) != binary.digest) {
+                    throw std::runtime_error("ERROR::ClusterWorker: Binary doesn't match its digest.");
+                }
+                StoreBinary(binary.digest, binary.data);
+            } else if (type == ClusterMessage::TASK) {
+                tasks.Push(DecodeTask(payload));
+            } else {
+                throw std::runtime_error("ERROR::ClusterWorker: Unexpected message.");
+            }
+        }
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    socket_ = -1;
+    shutdown(socket, SHUT_RDWR);
+    tasks.Close();
+    for (std::thread& executor : executors) {
+        executor.join();
+    }
+    close(socket);
+
+    if (error != nullptr && !is_stopped_) {
+        std::rethrow_exception(error);
+    }
+}
+
+void ClusterWorker::Stop() {
+    is_stopped_ = true;
+    int socket = socket_;
+    if (socket != -1) {
+        shutdown(socket, SHUT_RDWR);
+    }
+}
+
+size_t ClusterWorker::slots() const {
+    return slots_;
+}
+
+int ClusterWorker::Connect(const std::string& host, uint16_t port) {
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses;
+    int error = getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses);
+    if (error != 0) {
+        throw std::runtime_error("ERROR::ClusterWorker: Failed to resolve " + host + ": " + gai_strerror(error) + ".");
+    }
+
+    int socket = -1;
+    int connect_errno = 0;
+    for (addrinfo* address = addresses; address != nullptr && socket == -1; address = address->ai_next) {
+        socket = ::socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC, address->ai_protocol);
+        if (socket == -1) {
+            connect_errno = errno;
+            continue;
+        }
+        if (connect(socket, address->ai_addr, address->ai_addrlen) == -1) {
+            connect_errno = errno;
+            close(socket);
+            socket = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    if (socket == -1) {
+        throw std::system_error(connect_errno, std::generic_category(), "ERROR::ClusterWorker: Failed to connect to " + host + ":" + std::to_string(port) + ".");
+    }
+
+    int enable = 1;
+    setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    setsockopt(socket, SOL_SOCKET, SO_KEEPALIVE, &enable, sizeof(enable));
+    return socket;
+}
+
+std::filesystem::path ClusterWorker::GetBinary(const std::string& digest) const {
+    if (!IsSha256Hex(digest)) {
+        throw std::invalid_argument("ERROR::ClusterWorker: Invalid binary digest.");
+    }
+    return cache_dir_ / digest;
+}
+
+std::vector<std::string> ClusterWorker::ListBinaries() const {
+    std::vector<std::string> binaries;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(cache_dir_)) {
+        std::string name = entry.path().filename().string();
+        if (IsSha256Hex(name)) {
+            binaries.push_back(name);
+        }
+    }
+    return binaries;
+}
+
+void ClusterWorker::StoreBinary(const std::string& digest, std::string_view data) const {
+    std::filesystem::path binary = GetBinary(digest);
+    std::filesystem::path staging = binary.string() + "." + std::to_string(getpid());
+    {
+        std::ofstream out(staging, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            throw std::runtime_error("ERROR::ClusterWorker: Failed to open a file " + staging.string() + ".");
+        }
+        out.write(data.data(), data.size());
+        if (!out.flush()) {
+            throw std::runtime_error("ERROR::ClusterWorker: Failed to write a file " + staging.string() + ".");
+        }
+    }
+    std::filesystem::permissions(staging, std::filesystem::perms::owner_all | std::filesystem::perms::group_read | std::filesystem::perms::group_exec | std::filesystem::perms::others_read | std::filesystem::perms::others_exec);
+    std::filesystem::rename(staging, binary);
+}
+
+void ClusterWorker::ExecuteLoop(int socket, BoundedQueue<ClusterTask>& tasks) {
+    while (std::optional<ClusterTask> task = tasks.Pop()) {
+        if (socket_ != socket) {
+            continue;
+        }
+
+        ClusterResult result = {};
+        result.id = task->id;
+        try {
+            std::shared_ptr<ExecutionResult> execution = judge_.ExecuteWithExpectedOutput(
+                GetBinary(task->binary_digest),
+                task->time_limit_sec,
+                task->time_limit_usec,
+                task->memory_limit_mb,
+                task->input,
+                task->expected_output
+            );
+            result.status = execution->status();
+            result.output = execution->output();
+            result.usage = execution->usage();
+            result.startup_time_usec = execution->startup_time_usec();
+            result.output_hash = execution->output_hash();
+            result.is_output_matched = execution->is_output_matched();
+            if (result.output.size() > CLUSTER_MAX_FRAME_SIZE / 2) {
+                throw std::length_error("ERROR::ClusterWorker: Output is too large to send.");
+            }
+        } catch (const std::exception&) {
+            result.status = CreateExitStatus(ExitStatus::FAILURE);
+            result.output.clear();
+        }
+
+        if (!Send(socket, ClusterMessage::RESULT, EncodeResult(result))) {
+            shutdown(socket, SHUT_RDWR);
+        }
+    }
+}
+
+bool ClusterWorker::Send(int socket, ClusterMessage type, std::string_view payload) {
+    std::lock_guard<std::mutex> lock(send_mutex_);
+    return SendFrame(socket, type, payload);
+}
+
+}
@@ -0,0 +1,58 @@
+#ifndef CLUSTER_WORKER_H
+#define CLUSTER_WORKER_H
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bounded_queue.h"
+#include "cluster_protocol.h"
+#include "offline_judge.h"
+
+namespace oj {
+
+class ClusterWorker {
+public:
+    ~ClusterWorker();
+    explicit ClusterWorker (
+        const std::filesystem::path& cache_dir,
+        const std::string&           secret = std::string(),
+        size_t                       slots = 0,
+        OfflineJudge&                judge = OfflineJudge::GetInstance()
+    );
+    ClusterWorker(const ClusterWorker& other) = delete;
+    ClusterWorker(ClusterWorker&& other) = delete;
+
+    ClusterWorker& operator=(const ClusterWorker& other) = delete;
+    ClusterWorker& operator=(ClusterWorker&& other) = delete;
+
+    void                  Run(const std::string& host, uint16_t port);
+    void                  Stop();
+
+    size_t                slots() const;
+
+private:
+    static int               Connect(const std::string& host, uint16_t port);
+
+    std::filesystem::path    GetBinary(const std::string& digest) const;
+    std::vector<std::string> ListBinaries() const;
+    void                     StoreBinary(const std::string& digest, std::string_view data) const;
+    void                     ExecuteLoop(int socket, BoundedQueue<ClusterTask>& tasks);
+    bool                     Send(int socket, ClusterMessage type, std::string_view payload);
+
+    OfflineJudge&            judge_;
+    std::filesystem::path    cache_dir_;
+    std::string              secret_;
+    size_t                   slots_;
+    std::atomic<int>         socket_;
+    std::atomic<bool>        is_stopped_;
+    std::mutex               send_mutex_;
+};
+
+}
+
+#endif
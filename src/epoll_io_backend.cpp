@@ -0,0 +1,131 @@
+#include <cerrno>
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/stat.h>
+
+#include "epoll_io_backend.h"
+
+namespace oj {
+
+EpollIoBackend::~EpollIoBackend() {
+    close(epoll_fd_);
+}
+
+EpollIoBackend::EpollIoBackend() : epoll_fd_(-1), pending_(0), syscalls_(0) {
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ == -1) {
+        throw std::system_error(errno, std::generic_category(), "ERROR::EpollIoBackend: Failed to create an epoll instance.");
+    }
+}
+
+void EpollIoBackend::Submit(IoRequest request) {
+    ++pending_;
+
+    struct stat status;
+    ++syscalls_;
+    if (fstat(request.fd, &status) == -1 || S_ISREG(status.st_mode) || S_ISBLK(status.st_mode)) {
+        Perform(request);
+        return;
+    }
+
+    std::deque<IoRequest>& queue = waiting_[request.fd];
+    bool is_new = queue.empty();
+    if (is_new) {
+        int flags = fcntl(request.fd, F_GETFL);
+        if (flags != -1 && (flags & O_NONBLOCK) == 0) {
+            fcntl(request.fd, F_SETFL, flags | O_NONBLOCK);
+            ++syscalls_;
+        }
+        ++syscalls_;
+    }
+    queue.push_back(std::move(request));
+    if (is_new) {
+        Watch(queue.front().fd, true);
+    }
+}
+
+size_t EpollIoBackend::Poll(int timeout_ms) {
+    if (!waiting_.empty()) {
+        epoll_event events[MAX_EVENTS];
+        int ready = epoll_wait(epoll_fd_, events, MAX_EVENTS, completed_.empty() ? timeout_ms : 0);
+        ++syscalls_;
+        if (ready == -1 && errno != EINTR) {
+            throw std::system_error(errno, std::generic_category(), "ERROR::EpollIoBackend: Failed to wait for events.");
+        }
+
+        for (int i = 0; i < ready; ++i) {
+            int fd = events[i].data.fd;
+            auto it = waiting_.find(fd);
+            if (it == waiting_.end()) {
+                continue;
+            }
+
+            std::deque<IoRequest>& queue = it->second;
+            while (!queue.empty() && Perform(queue.front())) {
+                queue.pop_front();
+            }
+
+            if (queue.empty()) {
+                epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+                ++syscalls_;
+                waiting_.erase(it);
+            } else {
+                Watch(fd, false);
+            }
+        }
+    }
+
+    std::vector<std::pair<std::function<void(ssize_t)>, ssize_t>> completed;
+    completed.swap(completed_);
+    for (auto& [callback, result] : completed) {
+        callback(result);
+    }
+    return completed.size();
+}
+
+size_t EpollIoBackend::pending() const {
+    return pending_;
+}
+
+size_t EpollIoBackend::syscalls() const {
+    return syscalls_;
+}
+
+const char* EpollIoBackend::name() const {
+    return "epoll";
+}
+
+bool EpollIoBackend::Perform(IoRequest& request) {
+    ssize_t result;
+    do {
+        ++syscalls_;
+        if (request.operation == IoRequest::Operation::READ) {
+            result = request.offset < 0 ? read(request.fd, request.data, request.size) : pread(request.fd, request.data, request.size, request.offset);
+        } else {
+            result = request.offset < 0 ? write(request.fd, request.data, request.size) : pwrite(request.fd, request.data, request.size, request.offset);
+        }
+    } while (result == -1 && errno == EINTR);
+
+    if (result == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        return false;
+    }
+
+    --pending_;
+    completed_.emplace_back(std::move(request.callback), result == -1 ? -errno : result);
+    return true;
+}
+
+void EpollIoBackend::Watch(int fd, bool is_new) {
+    epoll_event event = {};
+    event.events = waiting_[fd].front().operation == IoRequest::Operation::READ ? EPOLLIN : EPOLLOUT;
+    event.data.fd = fd;
+    ++syscalls_;
+    if (epoll_ctl(epoll_fd_, is_new ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &event) == -1) {
+        throw std::system_error(errno, std::generic_category(), "ERROR::EpollIoBackend: Failed to watch a file descriptor.");
+    }
+}
+
+}
@@ -0,0 +1,46 @@
+#ifndef EPOLL_IO_BACKEND_H
+#define EPOLL_IO_BACKEND_H
+
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "io_backend.h"
+
+namespace oj {
+
+class EpollIoBackend : public IoBackend {
+public:
+    virtual ~EpollIoBackend();
+    EpollIoBackend();
+    EpollIoBackend(const EpollIoBackend& other) = delete;
+    EpollIoBackend(EpollIoBackend&& other) = delete;
+
+    EpollIoBackend& operator=(const EpollIoBackend& other) = delete;
+    EpollIoBackend& operator=(EpollIoBackend&& other) = delete;
+
+    virtual void        Submit(IoRequest request) override;
+    virtual size_t      Poll(int timeout_ms) override;
+
+    virtual size_t      pending() const override;
+    virtual size_t      syscalls() const override;
+    virtual const char* name() const override;
+
+private:
+    static constexpr int MAX_EVENTS = 64;
+
+    bool                 Perform(IoRequest& request);
+    void                 Watch(int fd, bool is_new);
+
+    int                                                          epoll_fd_;
+    std::unordered_map<int, std::deque<IoRequest>>               waiting_;
+    std::vector<std::pair<std::function<void(ssize_t)>, ssize_t>> completed_;
+    size_t                                                       pending_;
+    size_t                                                       syscalls_;
+};
+
+}
+
+#endif
@@ -0,0 +1,184 @@
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include "execution_cache.h"
+#include "hash.h"
+#include "mapped_file.h"
+
+namespace oj {
+
+ExecutionCache::ExecutionCache(const std::filesystem::path& directory) : directory_(directory), hits_(0), misses_(0) {
+    std::filesystem::create_directories(directory_);
+}
+
+std::shared_ptr<ExecutionResult> ExecutionCache::Find (
+    const std::filesystem::path& program,
+    int                          time_limit_sec,
+    int                          time_limit_usec,
+    int                          memory_limit_mb,
+    double                       wall_time_limit_factor,
+    const std::string&           runtime,
+    const std::string&           input
+) {
+    std::ifstream in(GetEntry(program, time_limit_sec, time_limit_usec, memory_limit_mb, wall_time_limit_factor, runtime, input), std::ios::binary);
+    if (!in.is_open()) {
+        ++misses_;
+        return nullptr;
+    }
+
+    int status;
+    uint64_t input_check;
+    long long wall_time_usec;
+    long startup_time_usec;
+    size_t timeline_size;
+    size_t output_size;
+    rusage usage = {};
+    MemoryProfile memory_profile = {};
+    in >> status >> input_check
+       >> usage.ru_utime.tv_sec >> usage.ru_utime.tv_usec
+       >> usage.ru_stime.tv_sec >> usage.ru_stime.tv_usec
+       >> usage.ru_maxrss >> wall_time_usec >> startup_time_usec
+       >> memory_profile.sample_interval_ms
+       >> memory_profile.peak_rss_kb >> memory_profile.peak_vm_size_kb
+       >> memory_profile.minor_page_faults >> memory_profile.major_page_faults
+       >> memory_profile.voluntary_context_switches >> memory_profile.involuntary_context_switches
+       >> timeline_size;
+    for (size_t i = 0; in && i < timeline_size; ++i) {
+        MemorySample sample;
+        in >> sample.time_ms >> sample.rss_kb >> sample.vm_size_kb;
+        memory_profile.timeline.push_back(sample);
+    }
+    in >> output_size;
+    in.ignore(1);
+
+    std::string output(in ? output_size : 0, '\0');
+    in.read(output.data(), output.size());
+    if (!in || input_check != Hash64(input, 1)) {
+        ++misses_;
+        return nullptr;
+    }
+
+    ++hits_;
+    std::shared_ptr<ExecutionResult> result = CreateExecutionResult(status, program, input, output, usage);
+    result->set_status(status);
+    result->set_memory_profile(memory_profile);
+    result->set_wall_time_usec(wall_time_usec);
+    result->set_startup_time_usec(startup_time_usec);
+    return result;
+}
+
+void ExecutionCache::Store (
+    const std::filesystem::path& program,
+    int                          time_limit_sec,
+    int                          time_limit_usec,
+    int                          memory_limit_mb,
+    double                       wall_time_limit_factor,
+    const std::string&           runtime,
+    const std::string&           input,
+    const ExecutionResult&       result
+) {
+    std::filesystem::path entry = GetEntry(program, time_limit_sec, time_limit_usec, memory_limit_mb, wall_time_limit_factor, runtime, input);
+    std::filesystem::create_directories(entry.parent_path());
+
+    std::ostringstream temporary_name;
+    temporary_name << entry.string() << ".tmp." << std::this_thread::get_id();
+    std::filesystem::path temporary = temporary_name.str();
+
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("ERROR::ExecutionCache: Failed to open a file " + temporary.string() + ".");
+    }
+    rusage usage = result.usage();
+    MemoryProfile memory_profile = result.memory_profile();
+    std::string output = result.output();
+    out << result.status() << ' ' << Hash64(input, 1) << ' '
+        << usage.ru_utime.tv_sec << ' ' << usage.ru_utime.tv_usec << ' '
+        << usage.ru_stime.tv_sec << ' ' << usage.ru_stime.tv_usec << ' '
+        << usage.ru_maxrss << ' ' << result.wall_time_usec() << ' ' << result.startup_time_usec() << ' '
+        << memory_profile.sample_interval_ms << ' '
+        << memory_profile.peak_rss_kb << ' ' << memory_profile.peak_vm_size_kb << ' '
+        << memory_profile.minor_page_faults << ' ' << memory_profile.major_page_faults << ' '
+        << memory_profile.voluntary_context_switches << ' ' << memory_profile.involuntary_context_switches << ' '
+        << memory_profile.timeline.size();
+    for (const MemorySample& sample : memory_profile.timeline) {
+        out << ' ' << sample.time_ms << ' ' << sample.rss_kb << ' ' << sample.vm_size_kb;
+    }
+    out << ' ' << output.size() << '\n';
+    out.write(output.data(), output.size());
+    out.close();
+    if (!out) {
+        std::filesystem::remove(temporary);
+        throw std::runtime_error("ERROR::ExecutionCache: Failed to write a file " + temporary.string() + ".");
+    }
+
+    std::filesystem::rename(temporary, entry);
+}
+
+void ExecutionCache::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    binary_hashes_.clear();
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(directory_)) {
+        std::filesystem::remove_all(entry.path());
+    }
+}
+
+size_t ExecutionCache::hits() const {
+    return hits_.load();
+}
+
+size_t ExecutionCache::misses() const {
+    return misses_.load();
+}
+
+uint64_t ExecutionCache::HashBinary(const std::filesystem::path& program) {
+    std::filesystem::file_time_type modification_time = std::filesystem::last_write_time(program);
+    uintmax_t size = std::filesystem::file_size(program);
+
+    std::string key = std::filesystem::absolute(program).string();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = binary_hashes_.find(key);
+        if (it != binary_hashes_.end() && it->second.modification_time == modification_time && it->second.size == size) {
+            return it->second.hash;
+        }
+    }
+
+    MappedFile binary(program);
+    uint64_t hash = Hash64(binary.view());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    binary_hashes_[key] = {modification_time, size, hash};
+    return hash;
+}
+
+std::filesystem::path ExecutionCache::GetEntry (
+    const std::filesystem::path& program,
+    int                          time_limit_sec,
+    int                          time_limit_usec,
+    int                          memory_limit_mb,
+    double                       wall_time_limit_factor,
+    const std::string&           runtime,
+    const std::string&           input
+) {
+    Hasher hasher;
+    uint64_t binary_hash = HashBinary(program);
+    uint64_t input_hash = Hash64(input);
+    uint64_t runtime_hash = Hash64(runtime);
+    hasher.Update(reinterpret_cast<const char*>(&binary_hash), sizeof(binary_hash));
+    hasher.Update(reinterpret_cast<const char*>(&input_hash), sizeof(input_hash));
+    hasher.Update(reinterpret_cast<const char*>(&time_limit_sec), sizeof(time_limit_sec));
+    hasher.Update(reinterpret_cast<const char*>(&time_limit_usec), sizeof(time_limit_usec));
+    hasher.Update(reinterpret_cast<const char*>(&memory_limit_mb), sizeof(memory_limit_mb));
+    hasher.Update(reinterpret_cast<const char*>(&wall_time_limit_factor), sizeof(wall_time_limit_factor));
+    hasher.Update(reinterpret_cast<const char*>(&runtime_hash), sizeof(runtime_hash));
+
+    std::ostringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << hasher.Digest();
+    std::string key = name.str();
+    return directory_ / key.substr(0, 2) / (key + ".entry");
+}
+
+}
@@ -0,0 +1,79 @@
+#ifndef EXECUTION_CACHE_H
+#define EXECUTION_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <sys/resource.h>
+
+#include "execution_result.h"
+
+namespace oj {
+
+class ExecutionCache {
+public:
+    ~ExecutionCache() = default;
+    explicit ExecutionCache(const std::filesystem::path& directory);
+    ExecutionCache(const ExecutionCache& other) = delete;
+    ExecutionCache(ExecutionCache&& other) = delete;
+
+    ExecutionCache& operator=(const ExecutionCache& other) = delete;
+    ExecutionCache& operator=(ExecutionCache&& other) = delete;
+
+    std::shared_ptr<ExecutionResult> Find (
+        const std::filesystem::path& program,
+        int                          time_limit_sec,
+        int                          time_limit_usec,
+        int                          memory_limit_mb,
+        double                       wall_time_limit_factor,
+        const std::string&           runtime,
+        const std::string&           input
+    );
+    void                             Store (
+        const std::filesystem::path& program,
+        int                          time_limit_sec,
+        int                          time_limit_usec,
+        int                          memory_limit_mb,
+        double                       wall_time_limit_factor,
+        const std::string&           runtime,
+        const std::string&           input,
+        const ExecutionResult&       result
+    );
+    void                             Clear();
+
+    size_t                           hits() const;
+    size_t                           misses() const;
+
+private:
+    struct BinaryHash {
+        std::filesystem::file_time_type modification_time;
+        uintmax_t                       size;
+        uint64_t                        hash;
+    };
+
+    uint64_t              HashBinary(const std::filesystem::path& program);
+    std::filesystem::path GetEntry (
+        const std::filesystem::path& program,
+        int                          time_limit_sec,
+        int                          time_limit_usec,
+        int                          memory_limit_mb,
+        double                       wall_time_limit_factor,
+        const std::string&           runtime,
+        const std::string&           input
+    );
+
+    std::filesystem::path                       directory_;
+    std::mutex                                  mutex_;
+    std::unordered_map<std::string, BinaryHash> binary_hashes_;
+    std::atomic<size_t>                         hits_;
+    std::atomic<size_t>                         misses_;
+};
+
+}
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef EXIT_STATUS_H
 #define EXIT_STATUS_H
 
+#include <cstdlib>
+
 namespace oj {
 
 enum class ExitStatus : int {
@@ -9,14 +11,35 @@ enum class ExitStatus : int {
 
     OUT_OF_MEMORY               = 100,
     TIMEOUT                     = 101,
+    CPU_TIMEOUT                 = 102,
+    WALL_TIMEOUT                = 103,
 
     EXCEPTION                   = 110,
     EXCEPTION_BAD_ALLOC         = 111,
     EXCEPTION_OUT_OF_RANGE      = 112,
     EXCEPTION_LENGTH_ERROR      = 113,
-    EXCEPTION_INVALID_ARGUMENT  = 114
+    EXCEPTION_INVALID_ARGUMENT  = 114,
+
+    JUDGE_SUCCESS               = 120,
+    JUDGE_WRONG_ANSWER          = 121,
+    JUDGE_INVALID_OUTPUT_FORMAT = 122,
+    JUDGE_OUTPUT_EXCEEDED       = 123,
+
+    COMPILATION_FILE_NOT_EXIST  = 130,
+    COMPILATION_FILE_UP_TO_DATE = 131,
+    COMPILATION_DUP_FAILURE     = 132,
+    COMPILATION_EXEC_FAILURE    = 133,
+
+    EXECUTION_PROGRAM_NOT_EXIST = 140,
+    EXECUTION_INPUT_NOT_EXIST   = 141,
+    EXECUTION_DUP_FAILURE       = 142,
+    EXECUTION_EXEC_FAILURE      = 143
 };
 
+inline int CreateExitStatus(ExitStatus status) {
+    return static_cast<int>(status) << 8;
+}
+
 }
 
 #endif
\ No newline at end of file
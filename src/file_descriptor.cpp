@@ -1,7 +1,10 @@
+#include <utility>
+
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/stat.h>
 
+#include "buffer_pool.h"
 #include "file_descriptor.h"
 
 namespace oj {
@@ -10,7 +13,7 @@ FileDescriptor::~FileDescriptor() {
     Close();
 }
 
-FileDescriptor::FileDescriptor(int fd) : fd_(fd), is_owner_(false) {}
+FileDescriptor::FileDescriptor(int fd, bool is_owner) : fd_(fd), is_owner_(is_owner) {}
 
 FileDescriptor::FileDescriptor(const std::filesystem::path& file, Flag flag) : fd_(-1), is_owner_(true) {
     Open(file, flag);
@@ -58,15 +61,15 @@ void FileDescriptor::Redirect(const FileDescriptor& other) {
     } 
 }
 
-void FileDescriptor::Read(std::ostream& out) {
+void FileDescriptor::Read(std::ostream& out, BufferPool& buffer_pool) const {
     if (!is_readable()) {
         throw std::runtime_error("ERROR::FileDescriptor: File is not open for reading.");
     }
 
-    char buf[256];
+    Buffer buf = buffer_pool.Acquire(BUFFER_SIZE);
     ssize_t bytes;
-    while ((bytes = read(fd_, buf, sizeof(buf))) > 0) {
-        out.write(buf, bytes);
+    while ((bytes = read(fd_, buf.data(), buf.size())) > 0) {
+        out.write(buf.data(), bytes);
     }
 
     if (bytes < 0) {
@@ -74,17 +77,17 @@ void FileDescriptor::Read(std::ostream& out) {
     }
 }
 
-void FileDescriptor::Write(std::istream& in) {
+void FileDescriptor::Write(std::istream& in, BufferPool& buffer_pool) const {
     if (!is_writable()) {
         throw std::runtime_error("ERROR::FileDescriptor: File is not open for writing.");
     }
 
-    char buf[256];
-    while (in.read(buf, sizeof(buf)) || in.gcount() > 0) {
+    Buffer buf = buffer_pool.Acquire(BUFFER_SIZE);
+    while (in.read(buf.data(), buf.size()) || in.gcount() > 0) {
         ssize_t total_bytes = 0;
         ssize_t bytes_to_write = in.gcount();
         while (total_bytes < bytes_to_write) {
-            ssize_t bytes = write(fd_, buf + total_bytes, bytes_to_write - total_bytes);
+            ssize_t bytes = write(fd_, buf.data() + total_bytes, bytes_to_write - total_bytes);
             if (bytes < 0) {
                 throw std::system_error(errno, std::generic_category(), "ERROR::FileDescriptor: Failed to write to a file.");
             }
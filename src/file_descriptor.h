@@ -4,6 +4,9 @@
 #include <filesystem>
 
 #include <fcntl.h>
+#include <unistd.h>
+
+#include "buffer_pool.h"
 
 namespace oj {
 
@@ -18,7 +21,7 @@ public:
     };
 
     ~FileDescriptor();
-    FileDescriptor(int fd);
+    FileDescriptor(int fd, bool is_owner = false);
     FileDescriptor(const std::filesystem::path& file, Flag flag);
     FileDescriptor(const FileDescriptor& other) = delete;
     FileDescriptor(FileDescriptor&& other) noexcept;
@@ -30,8 +33,8 @@ public:
     void Close();
     void Redirect(const FileDescriptor& other);
 
-    void Read(std::ostream& out);
-    void Write(std::istream& in);
+    void Read(std::ostream& out, BufferPool& buffer_pool = BufferPool::GetInstance()) const;
+    void Write(std::istream& in, BufferPool& buffer_pool = BufferPool::GetInstance()) const;
 
     int  fd() const;
     Flag flag() const;
@@ -41,6 +44,8 @@ public:
     bool is_set(Flag flag) const;
 
 private:
+    static constexpr size_t BUFFER_SIZE = 64 * 1024;
+
     int  fd_;
     bool is_owner_;
 };
@@ -61,6 +66,11 @@ inline FileDescriptor::Flag& operator&=(FileDescriptor::Flag& lhs, FileDescripto
     return lhs = lhs & rhs;
 }
 
+inline const FileDescriptor FD_EMPTY(-1);
+inline FileDescriptor FD_STD_IN(STDIN_FILENO);
+inline FileDescriptor FD_STD_OUT(STDOUT_FILENO);
+inline FileDescriptor FD_STD_ERR(STDERR_FILENO);
+
 }
 
 #endif
\ No newline at end of file
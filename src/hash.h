@@ -0,0 +1,131 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace oj {
+
+class Hasher {
+public:
+    explicit Hasher(uint64_t seed = 0) : state_(seed ^ K0), length_(0), tail_(0), tail_size_(0) {}
+
+    void Update(const char* data, size_t size) {
+        length_ += size;
+
+        while (tail_size_ != 0 && size > 0) {
+            Absorb(static_cast<unsigned char>(*data++));
+            --size;
+        }
+
+        for (; size >= sizeof(uint64_t); data += sizeof(uint64_t), size -= sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, data, sizeof(word));
+            state_ = Mix(state_ ^ word ^ K1, K2);
+        }
+
+        while (size > 0) {
+            Absorb(static_cast<unsigned char>(*data++));
+            --size;
+        }
+    }
+
+    void Update(std::string_view s) {
+        Update(s.data(), s.size());
+    }
+
+    void Update(char c) {
+        ++length_;
+        Absorb(static_cast<unsigned char>(c));
+    }
+
+    uint64_t Digest() const {
+        return Mix(Mix(state_ ^ tail_ ^ K1, K2 ^ tail_size_), length_ ^ K0);
+    }
+
+private:
+    static constexpr uint64_t K0 = 0xa0761d6478bd642full;
+    static constexpr uint64_t K1 = 0xe7037ed1a0b428dbull;
+    static constexpr uint64_t K2 = 0x8ebc6af09c88c6e3ull;
+
+    static uint64_t Mix(uint64_t a, uint64_t b) {
+        __uint128_t r = static_cast<__uint128_t>(a) * b;
+        return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+    }
+
+    void Absorb(unsigned char byte) {
+        tail_ |= static_cast<uint64_t>(byte) << (8 * tail_size_);
+        if (++tail_size_ == sizeof(uint64_t)) {
+            state_ = Mix(state_ ^ tail_ ^ K1, K2);
+            tail_ = 0;
+            tail_size_ = 0;
+        }
+    }
+
+    uint64_t state_;
+    uint64_t length_;
+    uint64_t tail_;
+    uint64_t tail_size_;
+};
+
+class OutputHasher {
+public:
+    static bool IsSpace(char c) {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    explicit OutputHasher(uint64_t seed = 0) : raw_(seed), normalized_(seed), is_in_token_(false), has_token_(false) {}
+
+    void Update(const char* data, size_t size) {
+        raw_.Update(data, size);
+
+        const char* end = data + size;
+        while (data != end) {
+            if (IsSpace(*data)) {
+                is_in_token_ = false;
+                ++data;
+                continue;
+            }
+
+            const char* begin = data;
+            while (data != end && !IsSpace(*data)) {
+                ++data;
+            }
+            if (!is_in_token_ && has_token_) {
+                normalized_.Update(' ');
+            }
+            normalized_.Update(begin, data - begin);
+            is_in_token_ = true;
+            has_token_ = true;
+        }
+    }
+
+    void Update(std::string_view s) {
+        Update(s.data(), s.size());
+    }
+
+    uint64_t raw_digest() const {
+        return raw_.Digest();
+    }
+
+    uint64_t normalized_digest() const {
+        return normalized_.Digest();
+    }
+
+private:
+    Hasher raw_;
+    Hasher normalized_;
+    bool   is_in_token_;
+    bool   has_token_;
+};
+
+inline uint64_t Hash64(std::string_view s, uint64_t seed = 0) {
+    Hasher hasher(seed);
+    hasher.Update(s);
+    return hasher.Digest();
+}
+
+}
+
+#endif
@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "epoll_io_backend.h"
+#include "io_backend.h"
+#include "uring_io_backend.h"
+
+namespace oj {
+
+std::unique_ptr<IoBackend> IoBackend::Create(Kind kind, unsigned queue_depth) {
+#ifdef OJ_HAVE_IO_URING
+    if (kind != Kind::EPOLL) {
+        try {
+            return std::make_unique<UringIoBackend>(queue_depth);
+        } catch (const std::system_error&) {
+            if (kind == Kind::IO_URING) {
+                throw;
+            }
+        }
+    }
+#else
+    if (kind == Kind::IO_URING) {
+        throw std::runtime_error("ERROR::IoBackend: io_uring isn't available in this build.");
+    }
+#endif
+    return std::make_unique<EpollIoBackend>();
+}
+
+void IoBackend::RegisterBuffers(const std::vector<iovec>&) {}
+
+std::string IoBackend::ReadFile(const std::filesystem::path& file) {
+    int fd = open(file.string().c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        throw std::system_error(errno, std::generic_category(), "ERROR::IoBackend: Failed to open a file " + file.string() + ".");
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) == -1) {
+        int error = errno;
+        close(fd);
+        throw std::system_error(error, std::generic_category(), "ERROR::IoBackend: Failed to stat a file " + file.string() + ".");
+    }
+
+    std::string data(status.st_size, '\0');
+    size_t size = data.size();
+    ssize_t error = 0;
+    for (size_t offset = 0; offset < data.size(); offset += CHUNK_SIZE) {
+        size_t length = std::min(CHUNK_SIZE, data.size() - offset);
+        Submit({IoRequest::Operation::READ, fd, data.data() + offset, length, static_cast<off_t>(offset), [&, offset, length](ssize_t result) {
+            if (result < 0) {
+                error = result;
+            } else if (static_cast<size_t>(result) < length) {
+                size = std::min(size, offset + result);
+            }
+        }});
+    }
+    Wait();
+    data.resize(size);
+
+    if (error == 0 && status.st_size == 0) {
+        std::string chunk(CHUNK_SIZE, '\0');
+        ssize_t bytes = 1;
+        while (error == 0 && bytes > 0) {
+            Submit({IoRequest::Operation::READ, fd, chunk.data(), chunk.size(), -1, [&](ssize_t result) {
+                bytes = result;
+                if (result < 0) {
+                    error = result;
+                } else {
+                    data.append(chunk.data(), result);
+                }
+            }});
+            Wait();
+        }
+    }
+
+    close(fd);
+    if (error < 0) {
+        throw std::system_error(static_cast<int>(-error), std::generic_category(), "ERROR::IoBackend: Failed to read a file " + file.string() + ".");
+    }
+    return data;
+}
+
+void IoBackend::WriteFile(const std::filesystem::path& file, std::string_view data) {
+    int fd = open(file.string().c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (fd == -1) {
+        throw std::system_error(errno, std::generic_category(), "ERROR::IoBackend: Failed to open a file " + file.string() + ".");
+    }
+
+    std::vector<std::pair<size_t, size_t>> remaining;
+    for (size_t offset = 0; offset < data.size(); offset += CHUNK_SIZE) {
+        remaining.emplace_back(offset, std::min(CHUNK_SIZE, data.size() - offset));
+    }
+
+    ssize_t error = 0;
+    while (!remaining.empty() && error == 0) {
+        std::vector<std::pair<size_t, size_t>> retry;
+        for (const auto& [offset, length] : remaining) {
+            char* chunk = const_cast<char*>(data.data()) + offset;
+            Submit({IoRequest::Operation::WRITE, fd, chunk, length, static_cast<off_t>(offset), [&, offset = offset, length = length](ssize_t result) {
+                if (result < 0) {
+                    error = result;
+                } else if (static_cast<size_t>(result) < length) {
+                    retry.emplace_back(offset + result, length - result);
+                }
+            }});
+        }
+        Wait();
+        remaining = std::move(retry);
+    }
+
+    close(fd);
+    if (error < 0) {
+        throw std::system_error(static_cast<int>(-error), std::generic_category(), "ERROR::IoBackend: Failed to write a file " + file.string() + ".");
+    }
+}
+
+void IoBackend::Wait() {
+    while (pending() != 0) {
+        Poll(-1);
+    }
+}
+
+}
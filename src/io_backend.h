@@ -0,0 +1,60 @@
+#ifndef IO_BACKEND_H
+#define IO_BACKEND_H
+
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/types.h>
+#include <sys/uio.h>
+
+namespace oj {
+
+struct IoRequest {
+    enum class Operation {
+        READ,
+        WRITE
+    };
+
+    Operation                    operation;
+    int                          fd;
+    char*                        data;
+    size_t                       size;
+    off_t                        offset;
+    std::function<void(ssize_t)> callback;
+};
+
+class IoBackend {
+public:
+    enum class Kind {
+        AUTO,
+        EPOLL,
+        IO_URING
+    };
+
+    static std::unique_ptr<IoBackend> Create(Kind kind = Kind::AUTO, unsigned queue_depth = 256);
+
+    virtual ~IoBackend() = default;
+
+    virtual void        Submit(IoRequest request) = 0;
+    virtual size_t      Poll(int timeout_ms) = 0;
+    virtual void        RegisterBuffers(const std::vector<iovec>& buffers);
+
+    virtual size_t      pending() const = 0;
+    virtual size_t      syscalls() const = 0;
+    virtual const char* name() const = 0;
+
+            std::string ReadFile(const std::filesystem::path& file);
+            void        WriteFile(const std::filesystem::path& file, std::string_view data);
+            void        Wait();
+
+protected:
+    static constexpr size_t CHUNK_SIZE = 1 << 20;
+};
+
+}
+
+#endif
@@ -0,0 +1,63 @@
+#include "judge_context.h"
+
+namespace oj {
+
+JudgeContext::JudgeContext (
+    const JudgeLimits&           limits,
+    const std::filesystem::path& cache_dir,
+    bool                         use_huge_pages,
+    IoBackend::Kind              io_backend_kind
+) : limits_(limits), buffer_pool_(use_huge_pages), judge_(buffer_pool_) {
+    if (!cache_dir.empty()) {
+        execution_cache_ = std::make_shared<ExecutionCache>(cache_dir);
+    }
+
+    judge_.SetExecutionCache(execution_cache_);
+    judge_.SetWallTimeLimitFactor(limits_.wall_time_limit_factor);
+    judge_.SetIoBackend(io_backend_kind);
+}
+
+std::shared_ptr<ExecutionResult> JudgeContext::Execute (
+    const std::filesystem::path& program,
+    const std::string&           input,
+    const std::filesystem::path& output_file
+) const {
+    return judge_.Execute(program, limits_.time_limit_sec, limits_.time_limit_usec, limits_.memory_limit_mb, input, output_file);
+}
+
+std::shared_ptr<ExecutionResult> JudgeContext::ExecuteWithFile (
+    const std::filesystem::path& program,
+    const std::filesystem::path& input_file,
+    const std::filesystem::path& output_file
+) const {
+    return judge_.ExecuteWithFile(program, limits_.time_limit_sec, limits_.time_limit_usec, limits_.memory_limit_mb, input_file, output_file);
+}
+
+std::shared_ptr<JudgeResult> JudgeContext::Judge(const std::string& user_answer, const std::string& correct_answer) const {
+    return judge_.Judge(user_answer, correct_answer);
+}
+
+std::shared_ptr<JudgeResult> JudgeContext::JudgeWithFile (
+    const std::filesystem::path& user_answer,
+    const std::filesystem::path& correct_answer
+) const {
+    return judge_.JudgeWithFile(user_answer, correct_answer);
+}
+
+OfflineJudge& JudgeContext::judge() {
+    return judge_;
+}
+
+const JudgeLimits& JudgeContext::limits() const {
+    return limits_;
+}
+
+BufferPool& JudgeContext::buffer_pool() {
+    return buffer_pool_;
+}
+
+std::shared_ptr<ExecutionCache> JudgeContext::execution_cache() const {
+    return execution_cache_;
+}
+
+}
@@ -0,0 +1,70 @@
+#ifndef JUDGE_CONTEXT_H
+#define JUDGE_CONTEXT_H
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include "buffer_pool.h"
+#include "execution_cache.h"
+#include "io_backend.h"
+#include "offline_judge.h"
+
+#include "execution_result.h"
+#include "judge_result.h"
+
+namespace oj {
+
+struct JudgeLimits {
+    int    time_limit_sec = 1;
+    int    time_limit_usec = 0;
+    int    memory_limit_mb = 256;
+    double wall_time_limit_factor = 2.0;
+};
+
+class JudgeContext {
+public:
+    ~JudgeContext() = default;
+    explicit JudgeContext (
+        const JudgeLimits&           limits,
+        const std::filesystem::path& cache_dir = std::filesystem::path(),
+        bool                         use_huge_pages = false,
+        IoBackend::Kind              io_backend_kind = IoBackend::Kind::AUTO
+    );
+    JudgeContext(const JudgeContext& other) = delete;
+    JudgeContext(JudgeContext&& other) = delete;
+
+    JudgeContext& operator=(const JudgeContext& other) = delete;
+    JudgeContext& operator=(JudgeContext&& other) = delete;
+
+    std::shared_ptr<ExecutionResult> Execute (
+        const std::filesystem::path& program,
+        const std::string&           input,
+        const std::filesystem::path& output_file = std::filesystem::path()
+    ) const;
+    std::shared_ptr<ExecutionResult> ExecuteWithFile (
+        const std::filesystem::path& program,
+        const std::filesystem::path& input_file,
+        const std::filesystem::path& output_file = std::filesystem::path()
+    ) const;
+    std::shared_ptr<JudgeResult>     Judge(const std::string& user_answer, const std::string& correct_answer) const;
+    std::shared_ptr<JudgeResult>     JudgeWithFile (
+        const std::filesystem::path& user_answer,
+        const std::filesystem::path& correct_answer
+    ) const;
+
+    OfflineJudge&                    judge();
+    const JudgeLimits&               limits() const;
+    BufferPool&                      buffer_pool();
+    std::shared_ptr<ExecutionCache>  execution_cache() const;
+
+private:
+    JudgeLimits                     limits_;
+    BufferPool                      buffer_pool_;
+    std::shared_ptr<ExecutionCache> execution_cache_;
+    OfflineJudge                    judge_;
+};
+
+}
+
+#endif
@@ -0,0 +1,114 @@
+#include "labeler.h"
+
+#include "compilation_result.h"
+#include "execution_result.h"
+#include "judge_result.h"
+#include "submission_result.h"
+
+namespace oj {
+
+void Labeler::Label(std::ostream& os, const CompilationSuccess&) const {
+    os << "CS";
+}
+
+void Labeler::Label(std::ostream& os, const CompilationFailure&) const {
+    os << "CE";
+}
+
+void Labeler::Label(std::ostream& os, const ExecutionSuccess&) const {
+    os << "OK";
+}
+
+void Labeler::Label(std::ostream& os, const ExecutionFailure&) const {
+    os << "RE";
+}
+
+void Labeler::Label(std::ostream& os, const ExecutionFileNotExist&) const {
+    os << "RE";
+}
+
+void Labeler::Label(std::ostream& os, const ExecutionFailureTimeout&) const {
+    os << "TLE";
+}
+
+void Labeler::Label(std::ostream& os, const ExecutionFailureCpuTimeLimitExceeded&) const {
+    os << "TLE";
+}
+
+void Labeler::Label(std::ostream& os, const ExecutionFailureWallTimeLimitExceeded&) const {
+    os << "TLE";
+}
+
+void Labeler::Label(std::ostream& os, const ExecutionFailureMemoryLimitExceeded&) const {
+    os << "MLE";
+}
+
+void Labeler::Label(std::ostream& os, const ExecutionFailureException&) const {
+    os << "RE";
+}
+
+void Labeler::Label(std::ostream& os, const ExecutionFailureBadAlloc&) const {
+    os << "RE";
+}
+
+void Labeler::Label(std::ostream& os, const ExecutionFailureOutofRange&) const {
+    os << "RE";
+}
+
+void Labeler::Label(std::ostream& os, const ExecutionFailureLengthError&) const {
+    os << "RE";
+}
+
+void Labeler::Label(std::ostream& os, const ExecutionFailureInvalidArgument&) const {
+    os << "RE";
+}
+
+void Labeler::Label(std::ostream& os, const ExecutionFailureSignaled&) const {
+    os << "RE";
+}
+
+void Labeler::Label(std::ostream& os, const ExecutionFailureSegmentationFault&) const {
+    os << "RE";
+}
+
+void Labeler::Label(std::ostream& os, const ExecutionFailureAbort&) const {
+    os << "RE";
+}
+
+void Labeler::Label(std::ostream& os, const ExecutionFailureInterrupt&) const {
+    os << "RE";
+}
+
+void Labeler::Label(std::ostream& os, const ExecutionFailureTermination&) const {
+    os << "RE";
+}
+
+void Labeler::Label(std::ostream& os, const ExecutionFailureKill&) const {
+    os << "RE";
+}
+
+void Labeler::Label(std::ostream& os, const JudgeSuccess&) const {
+    os << "AC";
+}
+
+void Labeler::Label(std::ostream& os, const JudgeFailureWrongAnswer&) const {
+    os << "WA";
+}
+
+void Labeler::Label(std::ostream& os, const JudgeFailureInvalidOutputFormat&) const {
+    os << "PE";
+}
+
+void Labeler::Label(std::ostream& os, const JudgeFailureOutputExceeded&) const {
+    os << "OLE";
+}
+
+void Labeler::Label(std::ostream& os, const SubmissionSuccess&) const {
+    os << "AC";
+}
+
+void Labeler::Label(std::ostream& os, const SubmissionFailure&) const {
+    os << "REJ";
+}
+
+}
@@ -3,55 +3,79 @@
 
 #include <ostream>
 
-#include "result.h"
-#include "compilation_result.h"
-#include "execution_result.h"
-#include "judge_result.h"
-#include "submission_result.h"
-
 namespace oj {
 
+class CompilationSuccess;
+class CompilationFailure;
+class ExecutionSuccess;
+class ExecutionFailure;
+class ExecutionFileNotExist;
+class ExecutionFailureTimeout;
+class ExecutionFailureCpuTimeLimitExceeded;
+class ExecutionFailureWallTimeLimitExceeded;
+class ExecutionFailureMemoryLimitExceeded;
+class ExecutionFailureException;
+class ExecutionFailureBadAlloc;
+class ExecutionFailureOutofRange;
+class ExecutionFailureLengthError;
+class ExecutionFailureInvalidArgument;
+class ExecutionFailureSignaled;
+class ExecutionFailureSegmentationFault;
+class ExecutionFailureAbort;
+class ExecutionFailureInterrupt;
+class ExecutionFailureTermination;
+class ExecutionFailureKill;
+class JudgeSuccess;
+class JudgeFailureWrongAnswer;
+class JudgeFailureInvalidOutputFormat;
+class JudgeFailureOutputExceeded;
+class SubmissionSuccess;
+class SubmissionFailure;
+
 class Labeler {
+public:
     static Labeler& GetInstance() {
         static Labeler instance;
         return instance;
     }
 
+    virtual ~Labeler() = default;
+    Labeler() = default;
     Labeler(const Labeler& other) = delete;
     Labeler(Labeler&& other) = delete;
 
     Labeler& operator=(const Labeler& other) = delete;
     Labeler& operator=(Labeler&& other) = delete;
 
-    virtual void Label(std::ostream& os, const CompilationSuccess& result);
-    virtual void Label(std::ostream& os, const CompilationFailure& result);
-    
-    virtual void Label(std::ostream& os, const ExecutionSuccess& result);
-    virtual void Label(std::ostream& os, const ExecutionFailureTimeout& result);
-    virtual void Label(std::ostream& os, const ExecutionFailureMemoryLimitExceeded& result);
-    virtual void Label(std::ostream& os, const ExecutionFailureException& result);
-    virtual void Label(std::ostream& os, const ExecutionFailureBadAlloc& result);
-    virtual void Label(std::ostream& os, const ExecutionFailureOutofRange& result);
-    virtual void Label(std::ostream& os, const ExecutionFailureLengthError& result);
-    virtual void Label(std::ostream& os, const ExecutionFailureInvalidArgument& result);
-    virtual void Label(std::ostream& os, const ExecutionFailureSignaled& result);
-    virtual void Label(std::ostream& os, const ExecutionFailureSegmentationFault& result);
-    virtual void Label(std::ostream& os, const ExecutionFailureAbort& result);
-    virtual void Label(std::ostream& os, const ExecutionFailureInterrupt& result);
-    virtual void Label(std::ostream& os, const ExecutionFailureTermination& result);
-    virtual void Label(std::ostream& os, const ExecutionFailureKill& result);
-
-    virtual void Label(std::ostream& os, const JudgeSuccess& result);
-    virtual void Label(std::ostream& os, const JudgeFailureInvalidOutputFormat& result);
-    virtual void Label(std::ostream& os, const JudgeFailureOutputExceeded& result);
-
-    virtual void Label(std::ostream& os, const SubmissionSuccess& result);
-    virtual void Label(std::ostream& os, const SubmissionFailure& result);
-
-private:
-    ~Labeler() = default;
+    virtual void Label(std::ostream& os, const CompilationSuccess& result) const;
+    virtual void Label(std::ostream& os, const CompilationFailure& result) const;
 
-    Labeler() = default;
+    virtual void Label(std::ostream& os, const ExecutionSuccess& result) const;
+    virtual void Label(std::ostream& os, const ExecutionFailure& result) const;
+    virtual void Label(std::ostream& os, const ExecutionFileNotExist& result) const;
+    virtual void Label(std::ostream& os, const ExecutionFailureTimeout& result) const;
+    virtual void Label(std::ostream& os, const ExecutionFailureCpuTimeLimitExceeded& result) const;
+    virtual void Label(std::ostream& os, const ExecutionFailureWallTimeLimitExceeded& result) const;
+    virtual void Label(std::ostream& os, const ExecutionFailureMemoryLimitExceeded& result) const;
+    virtual void Label(std::ostream& os, const ExecutionFailureException& result) const;
+    virtual void Label(std::ostream& os, const ExecutionFailureBadAlloc& result) const;
+    virtual void Label(std::ostream& os, const ExecutionFailureOutofRange& result) const;
+    virtual void Label(std::ostream& os, const ExecutionFailureLengthError& result) const;
+    virtual void Label(std::ostream& os, const ExecutionFailureInvalidArgument& result) const;
+    virtual void Label(std::ostream& os, const ExecutionFailureSignaled& result) const;
+    virtual void Label(std::ostream& os, const ExecutionFailureSegmentationFault& result) const;
+    virtual void Label(std::ostream& os, const ExecutionFailureAbort& result) const;
+    virtual void Label(std::ostream& os, const ExecutionFailureInterrupt& result) const;
+    virtual void Label(std::ostream& os, const ExecutionFailureTermination& result) const;
+    virtual void Label(std::ostream& os, const ExecutionFailureKill& result) const;
+
+    virtual void Label(std::ostream& os, const JudgeSuccess& result) const;
+    virtual void Label(std::ostream& os, const JudgeFailureWrongAnswer& result) const;
+    virtual void Label(std::ostream& os, const JudgeFailureInvalidOutputFormat& result) const;
+    virtual void Label(std::ostream& os, const JudgeFailureOutputExceeded& result) const;
+
+    virtual void Label(std::ostream& os, const SubmissionSuccess& result) const;
+    virtual void Label(std::ostream& os, const SubmissionFailure& result) const;
 };
 
 class KoreanLabeler : public Labeler {
@@ -60,4 +84,4 @@ class KoreanLabeler : public Labeler {
 
 }
 
-#endif
\ No newline at end of file
+#endif
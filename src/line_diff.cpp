@@ -0,0 +1,251 @@
+#include <algorithm>
+
+#include "hash.h"
+#include "line_diff.h"
+
+namespace oj {
+
+LineDiff::LineDiff (
+    size_t max_hunks,
+    size_t window_lines,
+    size_t max_edit_distance,
+    size_t max_hunk_lines,
+    int    time_limit_ms
+) : max_hunks_(max_hunks),
+    window_lines_(window_lines),
+    max_edit_distance_(max_edit_distance),
+    max_hunk_lines_(max_hunk_lines),
+    time_limit_ms_(time_limit_ms) {}
+
+std::vector<LineJudgeData> LineDiff::Diff(std::string_view user_answer, std::string_view correct_answer) const {
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(time_limit_ms_);
+
+    std::vector<LineJudgeData> hunks;
+    size_t user_pos = 0;
+    size_t correct_pos = 0;
+    size_t user_line = 0;
+    size_t correct_line = 0;
+
+    while (hunks.size() < max_hunks_) {
+        while (true) {
+            size_t user_next = user_pos;
+            size_t correct_next = correct_pos;
+            std::string_view user_text;
+            std::string_view correct_text;
+            bool has_user_line = NextLine(user_answer, user_next, user_text);
+            bool has_correct_line = NextLine(correct_answer, correct_next, correct_text);
+            if (!has_user_line && !has_correct_line) {
+                return hunks;
+            }
+            if (has_user_line != has_correct_line || user_text != correct_text) {
+                break;
+            }
+            user_pos = user_next;
+            correct_pos = correct_next;
+            ++user_line;
+            ++correct_line;
+        }
+
+        std::vector<Line> a = ReadWindow(user_answer, user_pos);
+        std::vector<Line> b = ReadWindow(correct_answer, correct_pos);
+        bool is_last_window = (a.empty() ? user_pos : a.back().end) >= user_answer.size() &&
+                              (b.empty() ? correct_pos : b.back().end) >= correct_answer.size();
+
+        std::optional<std::vector<Operation>> operations = Myers(a, b, deadline);
+        if (!operations.has_value()) {
+            LineJudgeData hunk = CreateHunk(a, 0, a.size(), user_line, b, 0, b.size(), correct_line);
+            hunk.is_truncated = true;
+            hunks.push_back(std::move(hunk));
+            return hunks;
+        }
+
+        std::vector<LineJudgeData> window_hunks;
+        size_t x = 0;
+        size_t y = 0;
+        size_t sync_x = 0;
+        size_t sync_y = 0;
+        size_t sync_hunks = 0;
+        for (size_t i = 0; i < operations->size();) {
+            if ((*operations)[i] == Operation::EQUAL) {
+                ++x;
+                ++y;
+                ++i;
+                sync_x = x;
+                sync_y = y;
+                sync_hunks = window_hunks.size();
+                continue;
+            }
+
+            size_t hunk_x = x;
+            size_t hunk_y = y;
+            for (; i < operations->size() && (*operations)[i] != Operation::EQUAL; ++i) {
+                if ((*operations)[i] == Operation::DELETE) {
+                    ++x;
+                } else {
+                    ++y;
+                }
+            }
+            window_hunks.push_back(CreateHunk(a, hunk_x, x, user_line + hunk_x, b, hunk_y, y, correct_line + hunk_y));
+        }
+
+        if (is_last_window) {
+            sync_hunks = window_hunks.size();
+        } else if (sync_hunks == 0) {
+            LineJudgeData hunk = CreateHunk(a, 0, a.size(), user_line, b, 0, b.size(), correct_line);
+            hunk.is_truncated = true;
+            hunks.push_back(std::move(hunk));
+            return hunks;
+        }
+
+        for (size_t i = 0; i < sync_hunks && hunks.size() < max_hunks_; ++i) {
+            hunks.push_back(std::move(window_hunks[i]));
+        }
+
+        if (is_last_window) {
+            return hunks;
+        }
+
+        user_pos = a[sync_x - 1].end;
+        correct_pos = b[sync_y - 1].end;
+        user_line += sync_x;
+        correct_line += sync_y;
+    }
+
+    return hunks;
+}
+
+bool LineDiff::NextLine(std::string_view data, size_t& pos, std::string_view& line) {
+    if (pos >= data.size()) {
+        return false;
+    }
+
+    size_t newline = data.find('\n', pos);
+    if (newline == std::string_view::npos) {
+        line = data.substr(pos);
+        pos = data.size();
+    } else {
+        line = data.substr(pos, newline - pos);
+        pos = newline + 1;
+    }
+    return true;
+}
+
+std::vector<LineDiff::Line> LineDiff::ReadWindow(std::string_view data, size_t pos) const {
+    std::vector<Line> lines;
+    std::string_view text;
+    while (lines.size() < window_lines_ && NextLine(data, pos, text)) {
+        lines.push_back({Hash64(text), text, pos});
+    }
+    return lines;
+}
+
+std::optional<std::vector<LineDiff::Operation>> LineDiff::Myers (
+    const std::vector<Line>&              a,
+    const std::vector<Line>&              b,
+    std::chrono::steady_clock::time_point deadline
+) const {
+    auto is_equal = [&a, &b](int x, int y) {
+        return a[x].hash == b[y].hash && a[x].text == b[y].text;
+    };
+
+    int n = static_cast<int>(a.size());
+    int m = static_cast<int>(b.size());
+    int max_d = static_cast<int>(std::min<size_t>(a.size() + b.size(), max_edit_distance_));
+
+    std::vector<int> v(2 * max_d + 3, 0);
+    int offset = max_d + 1;
+
+    std::vector<std::vector<int>> trace;
+    int found_d = -1;
+    for (int d = 0; d <= max_d && found_d == -1; ++d) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return std::nullopt;
+        }
+
+        for (int k = -d; k <= d; k += 2) {
+            int x = (k == -d || (k != d && v[offset + k - 1] < v[offset + k + 1])) ? v[offset + k + 1] : v[offset + k - 1] + 1;
+            int y = x - k;
+            while (x < n && y < m && is_equal(x, y)) {
+                ++x;
+                ++y;
+            }
+            v[offset + k] = x;
+
+            if (x >= n && y >= m) {
+                found_d = d;
+                break;
+            }
+        }
+
+        trace.emplace_back(v.begin() + offset - d, v.begin() + offset + d + 1);
+    }
+
+    if (found_d == -1) {
+        return std::nullopt;
+    }
+
+    std::vector<Operation> operations;
+    operations.reserve(n + m);
+    int x = n;
+    int y = m;
+    for (int d = found_d; d > 0; --d) {
+        const std::vector<int>& previous = trace[d - 1];
+        auto previous_x = [&previous, d](int k) {
+            return previous[k + d - 1];
+        };
+
+        int k = x - y;
+        int previous_k = (k == -d || (k != d && previous_x(k - 1) < previous_x(k + 1))) ? k + 1 : k - 1;
+        int start_x = previous_x(previous_k);
+        int start_y = start_x - previous_k;
+
+        while (x > start_x && y > start_y) {
+            operations.push_back(Operation::EQUAL);
+            --x;
+            --y;
+        }
+        operations.push_back(x == start_x ? Operation::INSERT : Operation::DELETE);
+        x = start_x;
+        y = start_y;
+    }
+    while (x > 0 && y > 0) {
+        operations.push_back(Operation::EQUAL);
+        --x;
+        --y;
+    }
+
+    std::reverse(operations.begin(), operations.end());
+    return operations;
+}
+
+LineJudgeData LineDiff::CreateHunk (
+    const std::vector<Line>& a, size_t a_begin, size_t a_end, size_t a_line,
+    const std::vector<Line>& b, size_t b_begin, size_t b_end, size_t b_line
+) const {
+    LineJudgeData hunk;
+    hunk.user_line_begin = a_line;
+    hunk.user_line_count = a_end - a_begin;
+    hunk.correct_line_begin = b_line;
+    hunk.correct_line_count = b_end - b_begin;
+    hunk.is_truncated = false;
+
+    for (size_t i = a_begin; i < a_end; ++i) {
+        if (hunk.user_lines.size() == max_hunk_lines_) {
+            hunk.is_truncated = true;
+            break;
+        }
+        hunk.user_lines.emplace_back(a[i].text);
+    }
+
+    for (size_t i = b_begin; i < b_end; ++i) {
+        if (hunk.correct_lines.size() == max_hunk_lines_) {
+            hunk.is_truncated = true;
+            break;
+        }
+        hunk.correct_lines.emplace_back(b[i].text);
+    }
+
+    return hunk;
+}
+
+}
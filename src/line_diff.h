@@ -0,0 +1,67 @@
+#ifndef LINE_DIFF_H
+#define LINE_DIFF_H
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "judge_result.h"
+
+namespace oj {
+
+class LineDiff {
+public:
+    ~LineDiff() = default;
+    LineDiff (
+        size_t max_hunks = 3,
+        size_t window_lines = 4096,
+        size_t max_edit_distance = 512,
+        size_t max_hunk_lines = 16,
+        int    time_limit_ms = 50
+    );
+    LineDiff(const LineDiff& other) = default;
+    LineDiff(LineDiff&& other) noexcept = default;
+
+    LineDiff& operator=(const LineDiff& other) = default;
+    LineDiff& operator=(LineDiff&& other) noexcept = default;
+
+    std::vector<LineJudgeData> Diff(std::string_view user_answer, std::string_view correct_answer) const;
+
+private:
+    enum class Operation : char {
+        EQUAL,
+        DELETE,
+        INSERT
+    };
+
+    struct Line {
+        uint64_t         hash;
+        std::string_view text;
+        size_t           end;
+    };
+
+    static bool                           NextLine(std::string_view data, size_t& pos, std::string_view& line);
+
+    std::vector<Line>                     ReadWindow(std::string_view data, size_t pos) const;
+    std::optional<std::vector<Operation>> Myers (
+        const std::vector<Line>&              a,
+        const std::vector<Line>&              b,
+        std::chrono::steady_clock::time_point deadline
+    ) const;
+    LineJudgeData                         CreateHunk (
+        const std::vector<Line>& a, size_t a_begin, size_t a_end, size_t a_line,
+        const std::vector<Line>& b, size_t b_begin, size_t b_end, size_t b_line
+    ) const;
+
+    size_t max_hunks_;
+    size_t window_lines_;
+    size_t max_edit_distance_;
+    size_t max_hunk_lines_;
+    int    time_limit_ms_;
+};
+
+}
+
+#endif
@@ -0,0 +1,96 @@
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "mapped_file.h"
+
+namespace oj {
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+MappedFile::MappedFile() : data_(nullptr), size_(0), is_opened_(false) {}
+
+MappedFile::MappedFile(const std::filesystem::path& file) : data_(nullptr), size_(0), is_opened_(false) {
+    Open(file);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      is_opened_(std::exchange(other.is_opened_, false)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        Close();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        is_opened_ = std::exchange(other.is_opened_, false);
+    }
+    return *this;
+}
+
+void MappedFile::Open(const std::filesystem::path& file) {
+    Close();
+
+    int fd = open(file.string().c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        throw std::system_error(errno, std::generic_category(), "ERROR::MappedFile: Failed to open file " + file.string() + ".");
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) == -1) {
+        int error = errno;
+        close(fd);
+        throw std::system_error(error, std::generic_category(), "ERROR::MappedFile: Failed to get status of file " + file.string() + ".");
+    }
+
+    size_t size = static_cast<size_t>(status.st_size);
+    if (size > 0) {
+        void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            int error = errno;
+            close(fd);
+            throw std::system_error(error, std::generic_category(), "ERROR::MappedFile: Failed to map file " + file.string() + ".");
+        }
+        madvise(data, size, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(data);
+    }
+    close(fd);
+
+    size_ = size;
+    is_opened_ = true;
+}
+
+void MappedFile::Close() {
+    if (data_ != nullptr) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    is_opened_ = false;
+}
+
+const char* MappedFile::data() const {
+    return data_;
+}
+
+size_t MappedFile::size() const {
+    return size_;
+}
+
+std::string_view MappedFile::view() const {
+    return std::string_view(data_, size_);
+}
+
+bool MappedFile::is_opened() const {
+    return is_opened_;
+}
+
+}
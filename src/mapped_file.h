@@ -0,0 +1,36 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <filesystem>
+#include <string_view>
+
+namespace oj {
+
+class MappedFile {
+public:
+    ~MappedFile();
+    MappedFile();
+    explicit MappedFile(const std::filesystem::path& file);
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+
+    MappedFile& operator=(const MappedFile& other) = delete;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    void             Open(const std::filesystem::path& file);
+    void             Close();
+
+    const char*      data() const;
+    size_t           size() const;
+    std::string_view view() const;
+    bool             is_opened() const;
+
+private:
+    const char* data_;
+    size_t      size_;
+    bool        is_opened_;
+};
+
+}
+
+#endif
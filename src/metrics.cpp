@@ -0,0 +1,221 @@
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+
+#include <sys/wait.h>
+
+#include "metrics.h"
+
+namespace oj {
+
+namespace {
+
+std::string FormatValue(double value) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.15g", value);
+    return buffer;
+}
+
+void WriteSample(std::ostringstream& os, const std::string& name, const std::string& labels, const std::string& value) {
+    os << name;
+    if (!labels.empty()) {
+        os << '{' << labels << '}';
+    }
+    os << ' ' << value << '\n';
+}
+
+std::string JoinLabels(const std::string& labels, const std::string& label) {
+    return labels.empty() ? label : labels + "," + label;
+}
+
+}
+
+const std::vector<double> Metrics::LATENCY_BOUNDS = {0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0, 30.0};
+
+Counter::Counter() {
+    for (Shard& shard : shards_) {
+        shard.value = 0;
+    }
+}
+
+uint64_t Counter::value() const {
+    uint64_t value = 0;
+    for (const Shard& shard : shards_) {
+        value += shard.value.load(std::memory_order_relaxed);
+    }
+    return value;
+}
+
+Gauge::Gauge() : value_(0) {}
+
+int64_t Gauge::value() const {
+    return value_.load(std::memory_order_relaxed);
+}
+
+Histogram::Histogram(const std::vector<double>& bounds) : bounds_(), bound_count_(bounds.size()) {
+    if (bounds.size() > MAX_BOUND_COUNT) {
+        throw std::invalid_argument("ERROR::Histogram: Too many bucket bounds.");
+    }
+    for (size_t i = 0; i < bounds.size(); ++i) {
+        if (i != 0 && bounds[i] <= bounds[i - 1]) {
+            throw std::invalid_argument("ERROR::Histogram: Bucket bounds must be increasing.");
+        }
+        bounds_[i] = bounds[i];
+    }
+    for (Shard& shard : shards_) {
+        for (std::atomic<uint64_t>& count : shard.counts) {
+            count = 0;
+        }
+        shard.sum = 0.0;
+    }
+}
+
+std::vector<double> Histogram::bounds() const {
+    return std::vector<double>(bounds_.begin(), bounds_.begin() + bound_count_);
+}
+
+std::vector<uint64_t> Histogram::counts() const {
+    std::vector<uint64_t> counts(bound_count_ + 1, 0);
+    for (const Shard& shard : shards_) {
+        for (size_t bucket = 0; bucket <= bound_count_; ++bucket) {
+            counts[bucket] += shard.counts[bucket].load(std::memory_order_relaxed);
+        }
+    }
+    return counts;
+}
+
+double Histogram::sum() const {
+    double sum = 0.0;
+    for (const Shard& shard : shards_) {
+        sum += shard.sum.load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+Metrics::Metrics() : next_callback_id_(0) {}
+
+Counter& Metrics::GetCounter(const std::string& name, const std::string& help, const std::string& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_ptr<Counter>& counter = GetFamily(name, help, Type::COUNTER).counters[labels];
+    if (counter == nullptr) {
+        counter = std::make_unique<Counter>();
+    }
+    return *counter;
+}
+
+Gauge& Metrics::GetGauge(const std::string& name, const std::string& help, const std::string& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_ptr<Gauge>& gauge = GetFamily(name, help, Type::GAUGE).gauges[labels];
+    if (gauge == nullptr) {
+        gauge = std::make_unique<Gauge>();
+    }
+    return *gauge;
+}
+
+Histogram& Metrics::GetHistogram (
+    const std::string&         name,
+    const std::string&         help,
+    const std::vector<double>& bounds,
+    const std::string&         labels
+) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_ptr<Histogram>& histogram = GetFamily(name, help, Type::HISTOGRAM).histograms[labels];
+    if (histogram == nullptr) {
+        histogram = std::make_unique<Histogram>(bounds);
+    } else if (histogram->bounds() != bounds) {
+        throw std::invalid_argument("ERROR::Metrics: Histogram " + name + " is already registered with other bounds.");
+    }
+    return *histogram;
+}
+
+size_t Metrics::AddCallback (
+    const std::string&      name,
+    const std::string&      help,
+    const std::string&      labels,
+    std::function<double()> callback
+) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t id = next_callback_id_++;
+    GetFamily(name, help, Type::GAUGE).callbacks.emplace(id, std::make_pair(labels, std::move(callback)));
+    callback_names_.emplace(id, name);
+    return id;
+}
+
+void Metrics::RemoveCallback(size_t id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto name = callback_names_.find(id);
+    if (name == callback_names_.end()) {
+        return;
+    }
+    families_[name->second].callbacks.erase(id);
+    callback_names_.erase(name);
+}
+
+std::string Metrics::Render() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::ostringstream os;
+    for (const auto& [name, family] : families_) {
+        os << "# HELP " << name << ' ' << family.help << '\n';
+        os << "# TYPE " << name << ' ' << (family.type == Type::COUNTER ? "counter" : family.type == Type::HISTOGRAM ? "histogram" : "gauge") << '\n';
+
+        for (const auto& [labels, counter] : family.counters) {
+            WriteSample(os, name, labels, std::to_string(counter->value()));
+        }
+        for (const auto& [labels, gauge] : family.gauges) {
+            WriteSample(os, name, labels, std::to_string(gauge->value()));
+        }
+        for (const auto& [id, callback] : family.callbacks) {
+            WriteSample(os, name, callback.first, FormatValue(callback.second()));
+        }
+        for (const auto& [labels, histogram] : family.histograms) {
+            std::vector<double> bounds = histogram->bounds();
+            std::vector<uint64_t> counts = histogram->counts();
+            uint64_t count = 0;
+            for (size_t bucket = 0; bucket < counts.size(); ++bucket) {
+                count += counts[bucket];
+                std::string bound = bucket < bounds.size() ? FormatValue(bounds[bucket]) : "+Inf";
+                WriteSample(os, name + "_bucket", JoinLabels(labels, "le=\"" + bound + "\""), std::to_string(count));
+            }
+            WriteSample(os, name + "_sum", labels, FormatValue(histogram->sum()));
+            WriteSample(os, name + "_count", labels, std::to_string(count));
+        }
+    }
+    return os.str();
+}
+
+Metrics::Family& Metrics::GetFamily(const std::string& name, const std::string& help, Type type) {
+    auto [family, is_inserted] = families_.try_emplace(name);
+    if (is_inserted) {
+        family->second.type = type;
+        family->second.help = help;
+    } else if (family->second.type != type) {
+        throw std::invalid_argument("ERROR::Metrics: Metric " + name + " is already registered with another type.");
+    }
+    return family->second;
+}
+
+StatusCounter::StatusCounter(const std::string& name, const std::string& help, Metrics& metrics)
+    : metrics_(metrics), name_(name), help_(help) {
+    for (std::atomic<Counter*>& counter : counters_) {
+        counter = nullptr;
+    }
+}
+
+void StatusCounter::Add(int status) {
+    size_t index;
+    if (WIFSIGNALED(status) && static_cast<size_t>(WTERMSIG(status)) < SIGNAL_COUNT) {
+        index = EXIT_CODE_COUNT + WTERMSIG(status);
+    } else {
+        index = WEXITSTATUS(status);
+    }
+
+    Counter* counter = counters_[index].load(std::memory_order_acquire);
+    if (counter == nullptr) {
+        std::string label = index < EXIT_CODE_COUNT ? std::to_string(index) : "signal_" + std::to_string(index - EXIT_CODE_COUNT);
+        counter = &metrics_.GetCounter(name_, help_, "status=\"" + label + "\"");
+        counters_[index].store(counter, std::memory_order_release);
+    }
+    counter->Add();
+}
+
+}
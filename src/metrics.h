@@ -0,0 +1,195 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace oj {
+
+constexpr size_t METRICS_SHARD_COUNT = 16;
+
+inline size_t GetMetricsShard() {
+    static std::atomic<size_t> next_shard(0);
+    thread_local size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % METRICS_SHARD_COUNT;
+    return shard;
+}
+
+class Counter {
+public:
+    ~Counter() = default;
+    Counter();
+    Counter(const Counter& other) = delete;
+    Counter(Counter&& other) = delete;
+
+    Counter& operator=(const Counter& other) = delete;
+    Counter& operator=(Counter&& other) = delete;
+
+    void Add(uint64_t value = 1) {
+        shards_[GetMetricsShard()].value.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    uint64_t value() const;
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> value;
+    };
+
+    std::array<Shard, METRICS_SHARD_COUNT> shards_;
+};
+
+class Gauge {
+public:
+    ~Gauge() = default;
+    Gauge();
+    Gauge(const Gauge& other) = delete;
+    Gauge(Gauge&& other) = delete;
+
+    Gauge& operator=(const Gauge& other) = delete;
+    Gauge& operator=(Gauge&& other) = delete;
+
+    void Set(int64_t value) {
+        value_.store(value, std::memory_order_relaxed);
+    }
+
+    void Add(int64_t value) {
+        value_.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    int64_t value() const;
+
+private:
+    std::atomic<int64_t> value_;
+};
+
+class Histogram {
+public:
+    static constexpr size_t MAX_BOUND_COUNT = 15;
+
+    ~Histogram() = default;
+    explicit Histogram(const std::vector<double>& bounds);
+    Histogram(const Histogram& other) = delete;
+    Histogram(Histogram&& other) = delete;
+
+    Histogram& operator=(const Histogram& other) = delete;
+    Histogram& operator=(Histogram&& other) = delete;
+
+    void Observe(double value) {
+        size_t bucket = 0;
+        while (bucket < bound_count_ && value > bounds_[bucket]) {
+            ++bucket;
+        }
+
+        Shard& shard = shards_[GetMetricsShard()];
+        shard.counts[bucket].fetch_add(1, std::memory_order_relaxed);
+        double sum = shard.sum.load(std::memory_order_relaxed);
+        while (!shard.sum.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed)) {
+        }
+    }
+
+    std::vector<double>   bounds() const;
+    std::vector<uint64_t> counts() const;
+    double                sum() const;
+
+private:
+    struct alignas(64) Shard {
+        std::array<std::atomic<uint64_t>, MAX_BOUND_COUNT + 1> counts;
+        std::atomic<double>                                    sum;
+    };
+
+    std::array<double, MAX_BOUND_COUNT>    bounds_;
+    size_t                                 bound_count_;
+    std::array<Shard, METRICS_SHARD_COUNT> shards_;
+};
+
+class Metrics {
+public:
+    static const std::vector<double> LATENCY_BOUNDS;
+
+    static Metrics& GetInstance() {
+        static Metrics instance;
+        return instance;
+    }
+
+    ~Metrics() = default;
+    Metrics();
+    Metrics(const Metrics& other) = delete;
+    Metrics(Metrics&& other) = delete;
+
+    Metrics& operator=(const Metrics& other) = delete;
+    Metrics& operator=(Metrics&& other) = delete;
+
+    Counter&    GetCounter(const std::string& name, const std::string& help, const std::string& labels = std::string());
+    Gauge&      GetGauge(const std::string& name, const std::string& help, const std::string& labels = std::string());
+    Histogram&  GetHistogram (
+        const std::string&         name,
+        const std::string&         help,
+        const std::vector<double>& bounds = LATENCY_BOUNDS,
+        const std::string&         labels = std::string()
+    );
+    size_t      AddCallback (
+        const std::string&      name,
+        const std::string&      help,
+        const std::string&      labels,
+        std::function<double()> callback
+    );
+    void        RemoveCallback(size_t id);
+
+    std::string Render() const;
+
+private:
+    enum class Type {
+        COUNTER,
+        GAUGE,
+        HISTOGRAM
+    };
+
+    struct Family {
+        Type                                                              type;
+        std::string                                                       help;
+        std::map<std::string, std::unique_ptr<Counter>>                   counters;
+        std::map<std::string, std::unique_ptr<Gauge>>                     gauges;
+        std::map<std::string, std::unique_ptr<Histogram>>                 histograms;
+        std::map<size_t, std::pair<std::string, std::function<double()>>> callbacks;
+    };
+
+    Family& GetFamily(const std::string& name, const std::string& help, Type type);
+
+    mutable std::mutex            mutex_;
+    std::map<std::string, Family> families_;
+    std::map<size_t, std::string> callback_names_;
+    size_t                        next_callback_id_;
+};
+
+class StatusCounter {
+public:
+    ~StatusCounter() = default;
+    StatusCounter(const std::string& name, const std::string& help, Metrics& metrics = Metrics::GetInstance());
+    StatusCounter(const StatusCounter& other) = delete;
+    StatusCounter(StatusCounter&& other) = delete;
+
+    StatusCounter& operator=(const StatusCounter& other) = delete;
+    StatusCounter& operator=(StatusCounter&& other) = delete;
+
+    void Add(int status);
+
+private:
+    static constexpr size_t EXIT_CODE_COUNT = 256;
+    static constexpr size_t SIGNAL_COUNT = 65;
+
+    Metrics&                                                          metrics_;
+    std::string                                                       name_;
+    std::string                                                       help_;
+    std::array<std::atomic<Counter*>, EXIT_CODE_COUNT + SIGNAL_COUNT> counters_;
+};
+
+}
+
+#endif
@@ -0,0 +1,195 @@
+#include <cerrno>
+#include <chrono>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+#include "metrics_exporter.h"
+
+namespace oj {
+
+namespace {
+
+constexpr size_t MAX_REQUEST_SIZE = 8192;
+constexpr int    SOCKET_TIMEOUT_SEC = 1;
+
+bool SendAll(int socket, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t bytes = send(socket, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (bytes == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        sent += bytes;
+    }
+    return true;
+}
+
+}
+
+MetricsExporter::~MetricsExporter() {
+    Stop();
+}
+
+MetricsExporter::MetricsExporter(Metrics& metrics) : metrics_(metrics), listen_socket_(-1), port_(0), is_stopped_(false) {}
+
+void MetricsExporter::Serve(uint16_t port) {
+    if (serve_worker_.joinable()) {
+        throw std::runtime_error("ERROR::MetricsExporter: Already serving on port " + std::to_string(port_) + ".");
+    }
+
+    int listen_socket = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_socket == -1) {
+        throw std::system_error(errno, std::generic_category(), "ERROR::MetricsExporter: Failed to open a socket.");
+    }
+
+    int enable = 1;
+    setsockopt(listen_socket, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    socklen_t address_size = sizeof(address);
+    if (bind(listen_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1 ||
+        listen(listen_socket, SOMAXCONN) == -1 ||
+        getsockname(listen_socket, reinterpret_cast<sockaddr*>(&address), &address_size) == -1) {
+        int error = errno;
+        close(listen_socket);
+        throw std::system_error(error, std::generic_category(), "ERROR::MetricsExporter: Failed to listen on port " + std::to_string(port) + ".");
+    }
+
+    listen_socket_ = listen_socket;
+    port_ = ntohs(address.sin_port);
+    serve_worker_ = std::thread(&MetricsExporter::ServeLoop, this);
+}
+
+void MetricsExporter::WriteFile(const std::filesystem::path& file, int interval_ms) {
+    if (write_worker_.joinable()) {
+        throw std::runtime_error("ERROR::MetricsExporter: Already writing to a file.");
+    }
+    if (interval_ms <= 0) {
+        throw std::invalid_argument("ERROR::MetricsExporter: Interval must be positive.");
+    }
+
+    Write(file);
+    write_worker_ = std::thread(&MetricsExporter::WriteLoop, this, file, interval_ms);
+}
+
+void MetricsExporter::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        is_stopped_ = true;
+    }
+    stop_.notify_all();
+
+    if (serve_worker_.joinable()) {
+        shutdown(listen_socket_, SHUT_RDWR);
+        serve_worker_.join();
+    }
+    if (listen_socket_ != -1) {
+        close(listen_socket_);
+        listen_socket_ = -1;
+    }
+    if (write_worker_.joinable()) {
+        write_worker_.join();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopped_ = false;
+}
+
+uint16_t MetricsExporter::port() const {
+    return port_;
+}
+
+void MetricsExporter::ServeLoop() {
+    while (true) {
+        int socket = accept4(listen_socket_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (socket == -1) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            return;
+        }
+
+        timeval timeout = {SOCKET_TIMEOUT_SEC, 0};
+        setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        Respond(socket);
+        close(socket);
+    }
+}
+
+void MetricsExporter::WriteLoop(std::filesystem::path file, int interval_ms) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_.wait_for(lock, std::chrono::milliseconds(interval_ms), [this]() { return is_stopped_; })) {
+        lock.unlock();
+        try {
+            Write(file);
+        } catch (const std::exception&) {
+        }
+        lock.lock();
+    }
+    lock.unlock();
+
+    try {
+        Write(file);
+    } catch (const std::exception&) {
+    }
+}
+
+void MetricsExporter::Respond(int socket) const {
+    std::string request;
+    char buffer[1024];
+    while (request.size() < MAX_REQUEST_SIZE && request.find("\r\n\r\n") == std::string::npos) {
+        ssize_t bytes = recv(socket, buffer, sizeof(buffer), 0);
+        if (bytes == -1 && errno == EINTR) {
+            continue;
+        }
+        if (bytes <= 0) {
+            break;
+        }
+        request.append(buffer, bytes);
+    }
+
+    std::string status = "404 Not Found";
+    std::string body = "Not Found\n";
+    if (request.compare(0, 13, "GET /metrics ") == 0 || request.compare(0, 6, "GET / ") == 0) {
+        status = "200 OK";
+        body = metrics_.Render();
+    }
+
+    SendAll(socket, "HTTP/1.1 " + status + "\r\n"
+                    "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                    "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                    "Connection: close\r\n"
+                    "\r\n" + body);
+}
+
+void MetricsExporter::Write(const std::filesystem::path& file) const {
+    std::filesystem::path staging = file.string() + "." + std::to_string(getpid());
+    {
+        std::ofstream out(staging, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            throw std::runtime_error("ERROR::MetricsExporter: Failed to open a file " + staging.string() + ".");
+        }
+        out << metrics_.Render();
+        if (!out.flush()) {
+            throw std::runtime_error("ERROR::MetricsExporter: Failed to write a file " + staging.string() + ".");
+        }
+    }
+    std::filesystem::rename(staging, file);
+}
+
+}
@@ -0,0 +1,48 @@
+#ifndef METRICS_EXPORTER_H
+#define METRICS_EXPORTER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+#include "metrics.h"
+
+namespace oj {
+
+class MetricsExporter {
+public:
+    ~MetricsExporter();
+    explicit MetricsExporter(Metrics& metrics = Metrics::GetInstance());
+    MetricsExporter(const MetricsExporter& other) = delete;
+    MetricsExporter(MetricsExporter&& other) = delete;
+
+    MetricsExporter& operator=(const MetricsExporter& other) = delete;
+    MetricsExporter& operator=(MetricsExporter&& other) = delete;
+
+    void     Serve(uint16_t port = 0);
+    void     WriteFile(const std::filesystem::path& file, int interval_ms = 10000);
+    void     Stop();
+
+    uint16_t port() const;
+
+private:
+    void ServeLoop();
+    void WriteLoop(std::filesystem::path file, int interval_ms);
+    void Respond(int socket) const;
+    void Write(const std::filesystem::path& file) const;
+
+    Metrics&                metrics_;
+    int                     listen_socket_;
+    uint16_t                port_;
+    std::mutex              mutex_;
+    std::condition_variable stop_;
+    bool                    is_stopped_;
+    std::thread             serve_worker_;
+    std::thread             write_worker_;
+};
+
+}
+
+#endif
@@ -1,15 +1,32 @@
+#include <cerrno>
+#include <chrono>
+#include <cstring>
 #include <filesystem>
 #include <stdexcept>
+#include <system_error>
 #include <fstream>
 #include <sstream>
+#include <string_view>
+#include <vector>
 
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <time.h>
 #include <unistd.h>
 #include <sys/wait.h>
 #include <sys/time.h>
 
 #include "exit_status.h"
 
+#include "answer_index.h"
+#include "buffer_pool.h"
 #include "offline_judge.h"
+#include "mapped_file.h"
+#include "metrics.h"
+#include "sampling_profiler.h"
+#include "supervisor.h"
+#include "zygote.h"
 
 #include "compilation_result.h"
 #include "execution_result.h"
@@ -18,67 +35,408 @@
 
 namespace oj {
 
+namespace {
+
+constexpr const char* STARTUP_PROBE_VARIABLE = "OJ_STARTUP_PROBE_FD";
+
+constexpr const char* STARTUP_PROBE_SOURCE = R"(#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+__attribute__((constructor(101))) static void oj_startup_probe(void) {
+    const char* fd = getenv("OJ_STARTUP_PROBE_FD");
+    if (fd != NULL) {
+        struct timespec main_time;
+        int probe_fd = atoi(fd);
+        clock_gettime(CLOCK_MONOTONIC, &main_time);
+        if (write(probe_fd, &main_time, sizeof(main_time)) < 0) {
+        }
+        close(probe_fd);
+        unsetenv("OJ_STARTUP_PROBE_FD");
+    }
+}
+)";
+
+constexpr const char* LINK_PROBE_SOURCE = R"(#include <stdio.h>
+
+int main(void) {
+    puts("");
+    return 0;
+}
+)";
+
+struct JudgeMetrics {
+    JudgeMetrics(Metrics& metrics = Metrics::GetInstance())
+        : fork_spawns(metrics.GetCounter("oj_spawns_total", "Processes spawned for executions.", "method=\"fork\"")),
+          zygote_spawns(metrics.GetCounter("oj_spawns_total", "Processes spawned for executions.", "method=\"zygote\"")),
+          compile_cache_hits(metrics.GetCounter("oj_cache_lookups_total", "Cache lookups by cache and result.", "cache=\"compile\",result=\"hit\"")),
+          compile_cache_misses(metrics.GetCounter("oj_cache_lookups_total", "Cache lookups by cache and result.", "cache=\"compile\",result=\"miss\"")),
+          execution_cache_hits(metrics.GetCounter("oj_cache_lookups_total", "Cache lookups by cache and result.", "cache=\"execution\",result=\"hit\"")),
+          execution_cache_misses(metrics.GetCounter("oj_cache_lookups_total", "Cache lookups by cache and result.", "cache=\"execution\",result=\"miss\"")),
+          input_bytes(metrics.GetCounter("oj_piped_bytes_total", "Bytes piped to and from executions.", "direction=\"stdin\"")),
+          output_bytes(metrics.GetCounter("oj_piped_bytes_total", "Bytes piped to and from executions.", "direction=\"stdout\"")),
+          compile_seconds(metrics.GetHistogram("oj_phase_seconds", "Latency of judge phases.", Metrics::LATENCY_BOUNDS, "phase=\"compile\"")),
+          startup_seconds(metrics.GetHistogram("oj_phase_seconds", "Latency of judge phases.", Metrics::LATENCY_BOUNDS, "phase=\"startup\"")),
+          execute_seconds(metrics.GetHistogram("oj_phase_seconds", "Latency of judge phases.", Metrics::LATENCY_BOUNDS, "phase=\"execute\"")),
+          judge_seconds(metrics.GetHistogram("oj_phase_seconds", "Latency of judge phases.", Metrics::LATENCY_BOUNDS, "phase=\"judge\"")),
+          executions("oj_executions_total", "Executions by exit status.", metrics),
+          verdicts("oj_verdicts_total", "Judge verdicts by exit status.", metrics) {}
+
+    Counter&      fork_spawns;
+    Counter&      zygote_spawns;
+    Counter&      compile_cache_hits;
+    Counter&      compile_cache_misses;
+    Counter&      execution_cache_hits;
+    Counter&      execution_cache_misses;
+    Counter&      input_bytes;
+    Counter&      output_bytes;
+    Histogram&    compile_seconds;
+    Histogram&    startup_seconds;
+    Histogram&    execute_seconds;
+    Histogram&    judge_seconds;
+    StatusCounter executions;
+    StatusCounter verdicts;
+};
+
+JudgeMetrics& GetJudgeMetrics() {
+    static JudgeMetrics metrics;
+    return metrics;
+}
+
+double GetElapsedSec(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool IsDeterministic(int status) {
+    if (!WIFEXITED(status)) {
+        return false;
+    }
+
+    switch (static_cast<ExitStatus>(WEXITSTATUS(status))) {
+    case ExitStatus::FAILURE:
+    case ExitStatus::TIMEOUT:
+    case ExitStatus::CPU_TIMEOUT:
+    case ExitStatus::WALL_TIMEOUT:
+    case ExitStatus::EXECUTION_DUP_FAILURE:
+    case ExitStatus::EXECUTION_EXEC_FAILURE:
+        return false;
+    default:
+        return true;
+    }
+}
+
+bool IsExpectedOutput(const ExpectedOutput& expected_output, std::string_view output, const OutputHasher& output_hasher) {
+    if (expected_output.answer.data() == nullptr) {
+        return output.size() == expected_output.size && output_hasher.raw_digest() == expected_output.raw_hash;
+    }
+    return output == expected_output.answer ||
+           (expected_output.is_whitespace_insensitive && output_hasher.normalized_digest() == expected_output.normalized_hash &&
+            AnswerIndex::IsTokenEqual(output, expected_output.answer));
+}
+
+std::string GetRuntimeKey(const Zygote* runtime) {
+    std::string key;
+    if (runtime != nullptr) {
+        for (const std::string& arg : runtime->command()) {
+            key.append(arg).push_back('\0');
+        }
+    }
+    return key;
+}
+
+}
+
 std::shared_ptr<ExecutionResult> OfflineJudge::Execute (
     const std::filesystem::path& program, 
     int                          time_limit_sec,
     int                          time_limit_usec,
     int                          memory_limit_mb,
     const std::string&           input,
-    const std::filesystem::path& output_file
+    const std::filesystem::path& output_file,
+    bool                         is_cacheable
+) const {
+    return ExecuteProgram(program, time_limit_sec, time_limit_usec, memory_limit_mb, input, output_file, nullptr, nullptr, is_cacheable);
+}
+
+std::shared_ptr<ExecutionResult> OfflineJudge::ExecuteWithAnswer (
+    const std::filesystem::path& program,
+    int                          time_limit_sec,
+    int                          time_limit_usec,
+    int                          memory_limit_mb,
+    const std::filesystem::path& input_file,
+    const std::filesystem::path& answer_file,
+    bool                         is_whitespace_insensitive
 ) const {
     if (!std::filesystem::exists(program)) {
         int status = CreateExitStatus(ExitStatus::EXECUTION_PROGRAM_NOT_EXIST);
+        std::string input;
         std::string output;
-        rusage usage;
+        rusage usage = {};
         return CreateExecutionResult(status, program, input, output, usage);
     }
 
-    int pipefd[2];
-    if (pipe(pipefd) == -1) {
-        throw std::runtime_error("ERROR::OfflineJudge: Failed to open a pipe.");
+    if (!std::filesystem::exists(input_file)) {
+        int status = CreateExitStatus(ExitStatus::EXECUTION_INPUT_NOT_EXIST);
+        std::string input;
+        std::string output;
+        rusage usage = {};
+        return CreateExecutionResult(status, program, input, output, usage);
     }
 
-    pid_t pid = fork();
-    if (pid < 0) {
-        throw std::runtime_error("ERROR::OfflineJudge: Failed to fork a process with " + program.string() + ".");
-    }
-    if (pid == 0) {
-        close(pipefd[0]);
-        if (dup2(pipefd[1], STDOUT_FILENO) == -1) {
-            exit(static_cast<int>(ExitStatus::EXECUTION_DUP_FAILURE));
-        }
-        close(pipefd[1]);
+    AnswerIndex answer_index(answer_file);
+    ExpectedOutput expected_output = {answer_index.answer().size(), answer_index.raw_hash(), answer_index.normalized_hash(), is_whitespace_insensitive, answer_index.answer()};
+    std::string input = ReadFileToString(input_file);
+    return ExecuteProgram(program, time_limit_sec, time_limit_usec, memory_limit_mb, input, std::filesystem::path(), &expected_output);
+}
 
-        SetTimeLimit(time_limit_sec, time_limit_usec);
+std::shared_ptr<ExecutionResult> OfflineJudge::ExecuteWithExpectedOutput (
+    const std::filesystem::path& program,
+    int                          time_limit_sec,
+    int                          time_limit_usec,
+    int                          memory_limit_mb,
+    const std::string&           input,
+    const ExpectedOutput&        expected_output
+) const {
+    return ExecuteProgram(program, time_limit_sec, time_limit_usec, memory_limit_mb, input, std::filesystem::path(), &expected_output);
+}
 
-        SetMemoryUsageLimit(memory_limit_mb);
+std::shared_ptr<ExecutionResult> OfflineJudge::ExecuteWithProfiler (
+    const std::filesystem::path& program,
+    int                          time_limit_sec,
+    int                          time_limit_usec,
+    int                          memory_limit_mb,
+    const std::filesystem::path& input_file,
+    int                          sample_frequency_hz,
+    size_t                       max_functions
+) const {
+    if (!std::filesystem::exists(input_file)) {
+        int status = CreateExitStatus(ExitStatus::EXECUTION_INPUT_NOT_EXIST);
+        std::string input;
+        std::string output;
+        rusage usage = {};
+        return CreateExecutionResult(status, program, input, output, usage);
+    }
 
-        execl(program.string().c_str(), program.string().c_str(), nullptr);
+    SamplingOptions sampling_options = {sample_frequency_hz, max_functions};
+    std::string input = ReadFileToString(input_file);
+    return ExecuteProgram(program, time_limit_sec, time_limit_usec, memory_limit_mb, input, std::filesystem::path(), nullptr, &sampling_options);
+}
 
-        exit(static_cast<int>(ExitStatus::EXECUTION_EXEC_FAILURE));
-    } else {
-        close(pipefd[1]);
+std::shared_ptr<ExecutionResult> OfflineJudge::ExecuteProgram (
+    const std::filesystem::path& program,
+    int                          time_limit_sec,
+    int                          time_limit_usec,
+    int                          memory_limit_mb,
+    const std::string&           input,
+    const std::filesystem::path& output_file,
+    const ExpectedOutput*        expected_output,
+    const SamplingOptions*       sampling_options,
+    bool                         is_cacheable
+) const {
+    if (!std::filesystem::exists(program)) {
+        int status = CreateExitStatus(ExitStatus::EXECUTION_PROGRAM_NOT_EXIST);
+        std::string output;
+        rusage usage = {};
+        std::shared_ptr<ExecutionResult> result = CreateExecutionResult(status, program, input, output, usage);
+        result->set_status(status);
+        GetJudgeMetrics().executions.Add(status);
+        return result;
+    }
 
-        std::string output = ReadFileDescriptiorToString(pipefd[0]);
+    JudgeMetrics& metrics = GetJudgeMetrics();
+    std::shared_ptr<Zygote> runtime = FindRuntime(program);
+    std::string runtime_key = GetRuntimeKey(runtime.get());
+    double wall_time_limit_factor = wall_time_limit_factor_;
+    std::shared_ptr<ExecutionCache> execution_cache = is_cacheable && sampling_options == nullptr ? std::atomic_load(&execution_cache_) : nullptr;
+    if (execution_cache != nullptr) {
+        std::shared_ptr<ExecutionResult> result = execution_cache->Find(program, time_limit_sec, time_limit_usec, memory_limit_mb, wall_time_limit_factor, runtime_key, input);
+        if (result != nullptr) {
+            metrics.execution_cache_hits.Add();
+            if (!output_file.empty()) {
+                WriteStringToFile(output_file, result->output());
+            }
+            if (expected_output != nullptr) {
+                OutputHasher output_hasher;
+                output_hasher.Update(result->output());
+                result->set_output_hash(output_hasher.raw_digest());
+                result->set_output_matched(result->is_success() && IsExpectedOutput(*expected_output, result->output(), output_hasher));
+            }
+            return result;
+        }
+        metrics.execution_cache_misses.Add();
+    }
 
-        close(pipefd[0]);
+    auto execute_start = std::chrono::steady_clock::now();
 
-        int status;
-        if (waitpid(pid, &status, 0) == -1) {
-            throw std::runtime_error("ERROR::OfflineJudge: Failed to wait a child process.");
+    int input_pipefd[2];
+    int output_pipefd[2];
+    if (pipe2(input_pipefd, O_CLOEXEC) == -1) {
+        throw std::runtime_error("ERROR::OfflineJudge: Failed to open a pipe.");
+    }
+    if (pipe2(output_pipefd, O_CLOEXEC) == -1) {
+        close(input_pipefd[0]);
+        close(input_pipefd[1]);
+        throw std::runtime_error("ERROR::OfflineJudge: Failed to open a pipe.");
+    }
+
+    std::string program_name = program.string();
+    long startup_time_usec = 0;
+
+    int probe_pipefd[2] = {-1, -1};
+    int hold_pipefd[2] = {-1, -1};
+    std::unique_ptr<SamplingProfiler> sampling_profiler;
+    pid_t pid;
+    if (runtime != nullptr) {
+        auto spawn_start = std::chrono::steady_clock::now();
+        try {
+            pid = runtime->Spawn(program, time_limit_sec, time_limit_usec, memory_limit_mb, input_pipefd[0], output_pipefd[1]);
+        } catch (...) {
+            for (int fd : {input_pipefd[0], input_pipefd[1], output_pipefd[0], output_pipefd[1]}) {
+                close(fd);
+            }
+            throw;
+        }
+        startup_time_usec = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - spawn_start).count();
+        metrics.zygote_spawns.Add();
+    } else {
+        if (IsProbed(program) && pipe2(probe_pipefd, O_CLOEXEC | O_NONBLOCK) == -1) {
+            for (int fd : {input_pipefd[0], input_pipefd[1], output_pipefd[0], output_pipefd[1]}) {
+                close(fd);
+            }
+            throw std::runtime_error("ERROR::OfflineJudge: Failed to open a pipe.");
         }
 
-        rusage usage;
-        if (getrusage(RUSAGE_CHILDREN, &usage) == -1) {
-            throw std::runtime_error("ERROR::OfflineJudge: Failed to get resource usage from a child process.");
+        if (sampling_options != nullptr && pipe2(hold_pipefd, O_CLOEXEC) == -1) {
+            for (int fd : {input_pipefd[0], input_pipefd[1], output_pipefd[0], output_pipefd[1], probe_pipefd[0], probe_pipefd[1]}) {
+                if (fd != -1) {
+                    close(fd);
+                }
+            }
+            throw std::runtime_error("ERROR::OfflineJudge: Failed to open a pipe.");
         }
 
-        if (!std::filesystem::is_empty(output_file)) {
-            WriteStringToFile(output_file, output);
+        std::string probe_variable = std::string(STARTUP_PROBE_VARIABLE) + "=" + std::to_string(probe_pipefd[1]);
+        std::vector<char*> environment;
+        for (char** variable = environ; *variable != nullptr; ++variable) {
+            if (strncmp(*variable, STARTUP_PROBE_VARIABLE, strlen(STARTUP_PROBE_VARIABLE)) != 0) {
+                environment.push_back(*variable);
+            }
+        }
+        if (probe_pipefd[1] != -1) {
+            environment.push_back(probe_variable.data());
+        }
+        environment.push_back(nullptr);
+        char* argv[] = {program_name.data(), nullptr};
+
+        pid = fork();
+        if (pid < 0) {
+            int error = errno;
+            for (int fd : {input_pipefd[0], input_pipefd[1], output_pipefd[0], output_pipefd[1], probe_pipefd[0], probe_pipefd[1], hold_pipefd[0], hold_pipefd[1]}) {
+                if (fd != -1) {
+                    close(fd);
+                }
+            }
+            throw std::system_error(error, std::generic_category(), "ERROR::OfflineJudge: Failed to fork a process with " + program.string() + ".");
+        }
+        if (pid == 0) {
+            if (setpgid(0, 0) == -1 || dup2(input_pipefd[0], STDIN_FILENO) == -1 || dup2(output_pipefd[1], STDOUT_FILENO) == -1) {
+                _exit(static_cast<int>(ExitStatus::EXECUTION_DUP_FAILURE));
+            }
+
+            if (!SetCpuTimeLimit(time_limit_sec, time_limit_usec) || !SetMemoryUsageLimit(memory_limit_mb)) {
+                _exit(static_cast<int>(ExitStatus::FAILURE));
+            }
+
+            if (hold_pipefd[0] != -1) {
+                char byte;
+                close(hold_pipefd[1]);
+                while (read(hold_pipefd[0], &byte, sizeof(byte)) == -1 && errno == EINTR) {}
+            }
+
+            if (probe_pipefd[1] != -1) {
+                timespec exec_time;
+                clock_gettime(CLOCK_MONOTONIC, &exec_time);
+                if (fcntl(probe_pipefd[1], F_SETFD, 0) == -1 || write(probe_pipefd[1], &exec_time, sizeof(exec_time)) != sizeof(exec_time)) {
+                    _exit(static_cast<int>(ExitStatus::FAILURE));
+                }
+            }
+
+            execve(program_name.c_str(), argv, environment.data());
+
+            _exit(static_cast<int>(ExitStatus::EXECUTION_EXEC_FAILURE));
         }
+        setpgid(pid, pid);
+        if (probe_pipefd[1] != -1) {
+            close(probe_pipefd[1]);
+        }
+        metrics.fork_spawns.Add();
+
+        if (hold_pipefd[0] != -1) {
+            close(hold_pipefd[0]);
+            try {
+                sampling_profiler = std::make_unique<SamplingProfiler>(pid, sampling_options->sample_frequency_hz);
+            } catch (const std::system_error&) {
+            }
+            close(hold_pipefd[1]);
+        }
+    }
 
-        return CreateExecutionResult(status, program, input, output, usage);
+    close(input_pipefd[0]);
+    close(output_pipefd[1]);
+
+    long long wall_time_limit_usec = static_cast<long long>((time_limit_sec * 1000000LL + time_limit_usec) * wall_time_limit_factor);
+    Supervisor supervisor(pid, buffer_pool_, memory_sample_interval_ms_);
+    supervisor.SetWallTimeLimit(wall_time_limit_usec / 1000000, wall_time_limit_usec % 1000000);
+    if (expected_output != nullptr) {
+        supervisor.SetExpectedOutput(*expected_output);
+    }
+    if (sampling_profiler != nullptr) {
+        supervisor.SetSamplingProfiler(*sampling_profiler);
     }
+
+    std::string output;
+    int status = supervisor.Run(input_pipefd[1], input, output_pipefd[0], output);
+    const rusage& usage = supervisor.usage();
+
+    if (probe_pipefd[0] != -1) {
+        startup_time_usec = ReadStartupProbe(probe_pipefd[0]);
+        close(probe_pipefd[0]);
+    }
+
+    long long time_limit_total_usec = time_limit_sec * 1000000LL + time_limit_usec;
+    long long cpu_time_usec = (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000LL + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+    if (time_limit_total_usec != 0 && (cpu_time_usec > time_limit_total_usec || (WIFSIGNALED(status) && WTERMSIG(status) == SIGXCPU))) {
+        status = CreateExitStatus(ExitStatus::CPU_TIMEOUT);
+    } else if (supervisor.is_wall_time_limit_exceeded()) {
+        status = CreateExitStatus(ExitStatus::WALL_TIMEOUT);
+    }
+
+    metrics.executions.Add(status);
+    metrics.execute_seconds.Observe(GetElapsedSec(execute_start));
+    metrics.startup_seconds.Observe(startup_time_usec / 1000000.0);
+    metrics.input_bytes.Add(supervisor.input_bytes());
+    metrics.output_bytes.Add(supervisor.output_bytes());
+
+    if (!output_file.empty()) {
+        WriteStringToFile(output_file, output);
+    }
+
+    std::shared_ptr<ExecutionResult> result = CreateExecutionResult(status, program, input, output, usage);
+    result->set_status(status);
+    result->set_memory_profile(supervisor.memory_profile());
+    result->set_wall_time_usec(supervisor.wall_time_usec());
+    result->set_startup_time_usec(startup_time_usec);
+    if (expected_output != nullptr) {
+        result->set_output_hash(supervisor.output_hash());
+        result->set_output_matched(supervisor.is_output_matched());
+    }
+    if (sampling_profiler != nullptr) {
+        result->set_sampling_profile(sampling_profiler->Collect(program, sampling_options->max_functions));
+    }
+    if (execution_cache != nullptr && !supervisor.is_output_matched() && IsDeterministic(status)) {
+        execution_cache->Store(program, time_limit_sec, time_limit_usec, memory_limit_mb, wall_time_limit_factor, runtime_key, input, *result);
+    }
+    return result;
 }
 
 std::shared_ptr<ExecutionResult> OfflineJudge::ExecuteWithFile (
@@ -87,13 +445,14 @@ std::shared_ptr<ExecutionResult> OfflineJudge::ExecuteWithFile (
         int                          time_limit_usec,
         int                          memory_limit_mb,
         const std::filesystem::path& input_file,
-        const std::filesystem::path& output_file
+        const std::filesystem::path& output_file,
+        bool                         is_cacheable
 ) const {
     if (!std::filesystem::exists(program)) {
         int status = CreateExitStatus(ExitStatus::EXECUTION_PROGRAM_NOT_EXIST);
         std::string input;
         std::string output;
-        rusage usage;
+        rusage usage = {};
         return CreateExecutionResult(status, program, input, output, usage);
     }
 
@@ -101,18 +460,343 @@ std::shared_ptr<ExecutionResult> OfflineJudge::ExecuteWithFile (
         int status = CreateExitStatus(ExitStatus::EXECUTION_INPUT_NOT_EXIST);
         std::string input;
         std::string output;
-        rusage usage;
+        rusage usage = {};
         return CreateExecutionResult(status, program, input, output, usage);
     }
 
     std::string input = ReadFileToString(input_file);
-    std::shared_ptr<ExecutionResult> result = Execute(program, time_limit_sec, time_limit_usec, memory_limit, input, output_file);
+    std::shared_ptr<ExecutionResult> result = Execute(program, time_limit_sec, time_limit_usec, memory_limit_mb, input, output_file, is_cacheable);
 
     return result;
 }
 
+void OfflineJudge::SetExecutionCache(const std::shared_ptr<ExecutionCache>& execution_cache) {
+    std::atomic_store(&execution_cache_, execution_cache);
+}
+
+void OfflineJudge::SetMemorySampleInterval(int sample_interval_ms) {
+    memory_sample_interval_ms_ = sample_interval_ms;
+}
+
+void OfflineJudge::SetRuntime(const std::string& extension, const std::shared_ptr<Zygote>& zygote) {
+    std::lock_guard<std::mutex> lock(runtime_mutex_);
+    if (zygote == nullptr) {
+        runtimes_.erase(extension);
+    } else {
+        runtimes_[extension] = zygote;
+    }
+}
+
+void OfflineJudge::SetIoBackend(IoBackend::Kind io_backend_kind) {
+    io_backend_kind_ = io_backend_kind;
+}
+
+void OfflineJudge::SetWallTimeLimitFactor(double wall_time_limit_factor) {
+    if (wall_time_limit_factor < 1.0) {
+        throw std::invalid_argument("ERROR::OfflineJudge: Wall time limit factor must be at least 1.");
+    }
+    wall_time_limit_factor_ = wall_time_limit_factor;
+}
+
 std::shared_ptr<JudgeResult> OfflineJudge::Judge(const std::string& user_answer, const std::string& correct_answer) const {
+    std::vector<TokenJudgeData> token_data;
+    std::vector<LineJudgeData> line_data;
+    bool is_equal = user_answer == correct_answer;
+    if (!is_equal) {
+        line_data = line_diff_.Diff(user_answer, correct_answer);
+    }
+
+    int status = CreateExitStatus(is_equal ? ExitStatus::JUDGE_SUCCESS : ExitStatus::JUDGE_WRONG_ANSWER);
+    return CreateJudgeResult(status, user_answer, correct_answer, token_data, line_data);
+}
+
+std::shared_ptr<JudgeResult> OfflineJudge::JudgeWithFile (
+    const std::filesystem::path& user_answer,
+    const std::filesystem::path& correct_answer
+) const {
+    MappedFile user_answer_file(user_answer);
+    AnswerIndex correct_answer_index(correct_answer);
+
+    std::vector<TokenJudgeData> token_data;
+    std::vector<LineJudgeData> line_data;
+    bool is_equal = user_answer_file.view() == correct_answer_index.answer();
+    if (!is_equal) {
+        line_data = line_diff_.Diff(user_answer_file.view(), correct_answer_index.answer());
+    }
+
+    int status = CreateExitStatus(is_equal ? ExitStatus::JUDGE_SUCCESS : ExitStatus::JUDGE_WRONG_ANSWER);
+    std::string user_answer_data;
+    std::string correct_answer_data;
+    return CreateJudgeResult(status, user_answer_data, correct_answer_data, token_data, line_data);
+}
+
+std::shared_ptr<JudgeResult> OfflineJudge::JudgeWithIndex(const std::string& user_answer, const std::filesystem::path& correct_answer) const {
+    AnswerIndex correct_answer_index(correct_answer);
+
+    std::vector<TokenJudgeData> token_data;
+    std::vector<LineJudgeData> line_data;
+    bool is_equal = correct_answer_index.IsEqual(user_answer);
+    if (!is_equal) {
+        line_data = line_diff_.Diff(user_answer, correct_answer_index.answer());
+    }
+
+    int status = CreateExitStatus(is_equal ? ExitStatus::JUDGE_SUCCESS : ExitStatus::JUDGE_WRONG_ANSWER);
+    std::string correct_answer_data;
+    return CreateJudgeResult(status, user_answer, correct_answer_data, token_data, line_data);
+}
+
+std::shared_ptr<JudgeResult> OfflineJudge::JudgeExecution (
+    const ExecutionResult&       execution_result,
+    const std::filesystem::path& correct_answer,
+    bool                         is_whitespace_insensitive
+) const {
+    auto start = std::chrono::steady_clock::now();
+    std::shared_ptr<JudgeResult> result;
+    if (execution_result.is_success() && execution_result.is_output_matched()) {
+        int status = CreateExitStatus(ExitStatus::JUDGE_SUCCESS);
+        std::string user_answer;
+        std::string correct_answer_data;
+        std::vector<TokenJudgeData> token_data;
+        std::vector<LineJudgeData> line_data;
+        result = CreateJudgeResult(status, user_answer, correct_answer_data, token_data, line_data);
+    } else if (is_whitespace_insensitive) {
+        result = JudgeWithTokens(execution_result.output(), correct_answer);
+    } else {
+        result = JudgeWithIndex(execution_result.output(), correct_answer);
+    }
+
+    JudgeMetrics& metrics = GetJudgeMetrics();
+    metrics.verdicts.Add(CreateExitStatus(result->is_success() ? ExitStatus::JUDGE_SUCCESS : ExitStatus::JUDGE_WRONG_ANSWER));
+    metrics.judge_seconds.Observe(GetElapsedSec(start));
+    return result;
+}
+
+std::shared_ptr<JudgeResult> OfflineJudge::JudgeWithTokens (
+    const std::string&           user_answer,
+    const std::filesystem::path& correct_answer,
+    double                       epsilon
+) const {
+    AnswerIndex correct_answer_index(correct_answer);
+
+    std::vector<TokenJudgeData> token_data;
+    std::vector<LineJudgeData> line_data;
+    if (std::optional<TokenJudgeData> mismatch = correct_answer_index.CompareTokens(user_answer, epsilon)) {
+        token_data.push_back(std::move(*mismatch));
+    }
+
+    int status = CreateExitStatus(token_data.empty() ? ExitStatus::JUDGE_SUCCESS : ExitStatus::JUDGE_WRONG_ANSWER);
+    std::string correct_answer_data;
+    return CreateJudgeResult(status, user_answer, correct_answer_data, token_data, line_data);
+}
+
+std::shared_ptr<JudgeResult> OfflineJudge::JudgeWithPlugin (
+    const std::filesystem::path& plugin,
+    const std::filesystem::path& input_file,
+    const std::string&           user_answer,
+    const std::filesystem::path& correct_answer
+) const {
+    return LoadPlugin(plugin)->Check(input_file, user_answer, correct_answer);
+}
+
+std::shared_ptr<SubmissionResult> OfflineJudge::Submit (
+    const std::shared_ptr<CompilationResult>&            compilation_result,
+    const std::vector<std::shared_ptr<ExecutionResult>>& execution_results,
+    const std::vector<std::shared_ptr<JudgeResult>>&     judge_results
+) const {
+    return CreateSubmissionResult(compilation_result, execution_results, judge_results);
+}
+
+std::shared_ptr<SubmissionResult> OfflineJudge::Submit (
+    const std::shared_ptr<CompilationResult>&            compilation_result,
+    const std::vector<std::shared_ptr<ExecutionResult>>& execution_results,
+    const std::vector<std::shared_ptr<JudgeResult>>&     judge_results,
+    const SubmissionSummary&                             summary
+) const {
+    return CreateSubmissionResult(compilation_result, execution_results, judge_results, summary);
+}
+
+void OfflineJudge::RecordCompilation(bool is_up_to_date, std::chrono::steady_clock::time_point start) const {
+    JudgeMetrics& metrics = GetJudgeMetrics();
+    if (is_up_to_date) {
+        metrics.compile_cache_hits.Add();
+    } else {
+        metrics.compile_cache_misses.Add();
+        metrics.compile_seconds.Observe(GetElapsedSec(start));
+    }
+}
+
+std::shared_ptr<CheckerPlugin> OfflineJudge::LoadPlugin(const std::filesystem::path& plugin) const {
+    std::lock_guard<std::mutex> lock(plugin_mutex_);
+    std::shared_ptr<CheckerPlugin>& loaded_plugin = plugins_[plugin.string()];
+    if (loaded_plugin == nullptr) {
+        loaded_plugin = std::make_shared<CheckerPlugin>(plugin);
+    }
+    return loaded_plugin;
+}
+
+std::shared_ptr<Zygote> OfflineJudge::FindRuntime(const std::filesystem::path& program) const {
+    std::lock_guard<std::mutex> lock(runtime_mutex_);
+    auto runtime = runtimes_.find(program.extension().string());
+    return runtime != runtimes_.end() ? runtime->second : nullptr;
+}
+
+std::string OfflineJudge::GetProfileOptions(CompileProfile profile, const std::string& compiler) {
+    std::lock_guard<std::mutex> lock(profile_mutex_);
+    switch (profile) {
+    case CompileProfile::DEFAULT:
+        return std::string();
+    case CompileProfile::DEBUG:
+        return "-g -fno-omit-frame-pointer";
+    case CompileProfile::FAST_STARTUP:
+        break;
+    }
+
+    auto options = fast_startup_options_.find(compiler);
+    if (options == fast_startup_options_.end()) {
+        std::string resolved;
+        for (const char* candidate : {"-static -no-pie", "-no-pie -static-libstdc++ -static-libgcc", "-no-pie"}) {
+            if (IsLinkable(compiler, candidate)) {
+                resolved = candidate;
+                break;
+            }
+        }
+        options = fast_startup_options_.emplace(compiler, resolved).first;
+    }
+    return options->second.empty() ? "-x c -" : options->second + " -x c -";
+}
+
+std::string OfflineJudge::GetProfileInput(CompileProfile profile) const {
+    return profile == CompileProfile::FAST_STARTUP ? STARTUP_PROBE_SOURCE : std::string();
+}
+
+bool OfflineJudge::IsLinkable(const std::string& compiler, const std::string& options) {
+    std::string directory_template = (std::filesystem::temp_directory_path() / "oj_link_probe_XXXXXX").string();
+    if (mkdtemp(directory_template.data()) == nullptr) {
+        throw std::system_error(errno, std::generic_category(), "ERROR::OfflineJudge: Failed to create a directory for a link probe.");
+    }
+    std::filesystem::path directory = directory_template;
+
+    std::string output;
+    int status = RunCommand(Concatenate(compiler, "-x c -", "-o", (directory / "probe").string(), options), output, LINK_PROBE_SOURCE);
+
+    std::filesystem::remove_all(directory);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
 
+bool OfflineJudge::IsStampMatched(const std::filesystem::path& target, const std::string& command, const std::string& input) const {
+    std::ifstream in(target.string() + ".stamp", std::ios::binary);
+    std::ostringstream stamp;
+    stamp << in.rdbuf();
+    return in.is_open() && stamp.str() == command + "\n" + std::to_string(Hash64(input)) + "\n";
+}
+
+void OfflineJudge::WriteStamp(const std::filesystem::path& target, const std::string& command, const std::string& input, bool is_success) const {
+    std::filesystem::path stamp = target.string() + ".stamp";
+    if (!is_success) {
+        std::filesystem::remove(stamp);
+        return;
+    }
+
+    std::ofstream out(stamp, std::ios::binary | std::ios::trunc);
+    out << command << '\n' << Hash64(input) << '\n';
+    if (!out) {
+        throw std::runtime_error("ERROR::OfflineJudge: Failed to write a file " + stamp.string() + ".");
+    }
+}
+
+void OfflineJudge::SetProbed(const std::filesystem::path& target, bool is_probed) {
+    std::string key = std::filesystem::absolute(target).lexically_normal().string();
+    std::lock_guard<std::mutex> lock(probe_mutex_);
+    if (is_probed) {
+        probed_programs_.insert(key);
+    } else {
+        probed_programs_.erase(key);
+    }
+}
+
+bool OfflineJudge::IsProbed(const std::filesystem::path& program) const {
+    std::string key = std::filesystem::absolute(program).lexically_normal().string();
+    std::lock_guard<std::mutex> lock(probe_mutex_);
+    return probed_programs_.count(key) != 0;
+}
+
+int OfflineJudge::RunCommand(const std::string& command, std::string& output, const std::string& input) const {
+    if (input.size() > PIPE_BUF) {
+        throw std::invalid_argument("ERROR::OfflineJudge: Command input doesn't fit in a pipe.");
+    }
+
+    int input_pipefd[2] = {-1, -1};
+    if (!input.empty()) {
+        if (pipe2(input_pipefd, O_CLOEXEC) == -1) {
+            throw std::runtime_error("ERROR::OfflineJudge: Failed to open a pipe.");
+        }
+        if (write(input_pipefd[1], input.data(), input.size()) != static_cast<ssize_t>(input.size())) {
+            close(input_pipefd[0]);
+            close(input_pipefd[1]);
+            throw std::runtime_error("ERROR::OfflineJudge: Failed to write to a pipe.");
+        }
+        close(input_pipefd[1]);
+    }
+
+    int pipefd[2];
+    if (pipe2(pipefd, O_CLOEXEC) == -1) {
+        if (input_pipefd[0] != -1) {
+            close(input_pipefd[0]);
+        }
+        throw std::runtime_error("ERROR::OfflineJudge: Failed to open a pipe.");
+    }
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        for (int fd : {pipefd[0], pipefd[1], input_pipefd[0]}) {
+            if (fd != -1) {
+                close(fd);
+            }
+        }
+        throw std::runtime_error("ERROR::OfflineJudge: Failed to fork a process with command \"" + command + "\".");
+    }
+    if (pid == 0) {
+        if (dup2(pipefd[1], STDOUT_FILENO) == -1 || dup2(pipefd[1], STDERR_FILENO) == -1 ||
+            (input_pipefd[0] != -1 && dup2(input_pipefd[0], STDIN_FILENO) == -1)) {
+            _exit(static_cast<int>(ExitStatus::COMPILATION_DUP_FAILURE));
+        }
+        execl("/bin/sh", "sh", "-c", command.c_str(), nullptr);
+        _exit(static_cast<int>(ExitStatus::COMPILATION_EXEC_FAILURE));
+    }
+
+    close(pipefd[1]);
+    if (input_pipefd[0] != -1) {
+        close(input_pipefd[0]);
+    }
+    output = ReadFileDescriptiorToString(pipefd[0]);
+    close(pipefd[0]);
+
+    int status;
+    while (waitpid(pid, &status, 0) == -1) {
+        if (errno != EINTR) {
+            throw std::runtime_error("ERROR::OfflineJudge: Failed to wait a child process.");
+        }
+    }
+    return status;
+}
+
+long OfflineJudge::ReadStartupProbe(int fd) const {
+    timespec times[2];
+    size_t size = 0;
+    ssize_t bytes;
+    while (size < sizeof(times) && (bytes = read(fd, reinterpret_cast<char*>(times) + size, sizeof(times) - size)) != 0) {
+        if (bytes == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return 0;
+        }
+        size += bytes;
+    }
+    if (size != sizeof(times)) {
+        return 0;
+    }
+    return (times[1].tv_sec - times[0].tv_sec) * 1000000L + (times[1].tv_nsec - times[0].tv_nsec) / 1000;
 }
 
 bool OfflineJudge::IsModifiedLaterThan(const std::filesystem::path& lhs, const std::filesystem::path& rhs) const {
@@ -123,12 +807,8 @@ bool OfflineJudge::IsModifiedLaterThan(const std::filesystem::path& lhs, const s
     return std::filesystem::last_write_time(lhs) > std::filesystem::last_write_time(rhs);
 }
 
-int WriteStringToFile(const std::filesystem::path& file, const std::string& s) {
-    std::ofstream out(file);
-    if (!out.is_open()) {
-        throw std::runtime_error("ERROR::OfflineJudge: Failed to open a file " + file.string() + ".");
-    }
-    out << s;
+void OfflineJudge::WriteStringToFile(const std::filesystem::path& file, const std::string& s) const {
+    GetIoBackend().WriteFile(file, s);
 }
 
 std::string OfflineJudge::ReadFileToString(const std::filesystem::path& file) const {
@@ -136,65 +816,62 @@ std::string OfflineJudge::ReadFileToString(const std::filesystem::path& file) co
         throw std::runtime_error("ERROR::OfflineJudge: " + file.string() + " doesn't exist.");
     }
 
-    std::ifstream in(file);
-    if (!in.is_open()) {
-        throw std::runtime_error("ERROR::OfflineJudge: Failed to open a file " + file.string() + ".");
-    }
+    return GetIoBackend().ReadFile(file);
+}
 
-    std::ostringstream sstream;
-    sstream << in.rdbuf();
-    return sstream.str();
+IoBackend& OfflineJudge::GetIoBackend() const {
+    thread_local std::unique_ptr<IoBackend> io_backends[3];
+    IoBackend::Kind kind = io_backend_kind_;
+    std::unique_ptr<IoBackend>& io_backend = io_backends[static_cast<int>(kind)];
+    if (io_backend == nullptr) {
+        io_backend = IoBackend::Create(kind);
+    }
+    return *io_backend;
 }
 
 std::string OfflineJudge::ReadFileDescriptiorToString(int fd) const {
-    std::string s;
-    char buffer[256];
+    BufferPool& buffer_pool = buffer_pool_;
+    Buffer buffer = buffer_pool.Acquire(64 * 1024);
+    size_t size = 0;
     ssize_t bytes;
-    while ((bytes = read(fd, buffer, sizeof(buffer) - 1)) > 0) {
-        buffer[bytes] = '\0';
-        s += buffer;
+    while (true) {
+        if (size == buffer.size()) {
+            buffer = buffer_pool.Grow(buffer, size);
+        }
+        if ((bytes = read(fd, buffer.data() + size, buffer.size() - size)) <= 0) {
+            break;
+        }
+        size += bytes;
     }
 
     if (bytes < 0) {
         throw std::runtime_error("ERROR::OfflineJudge: Failed to read from file descriptor.");
     }
-    return s;
+    return std::string(buffer.data(), size);
 }
 
-void OfflineJudge::SetMemoryUsageLimit(int memory_limit_mb) const {
+bool OfflineJudge::SetMemoryUsageLimit(int memory_limit_mb) const {
     if (memory_limit_mb == 0) {
-        return;
+        return true;
     }
 
     rlimit limit;
-    limit.rlim_cur = memory_limit_mb * 1024 * 1024;
-    limit.rlim_max = memory_limit_mb * 1024 * 1024;
+    limit.rlim_cur = static_cast<rlim_t>(memory_limit_mb) * 1024 * 1024;
+    limit.rlim_max = static_cast<rlim_t>(memory_limit_mb) * 1024 * 1024;
 
-    if (setrlimit(RLIMIT_AS, &limit) == -1) {
-        throw std::runtime_error("ERROR::OfflineJudge: Failed to set memory limit.");
-    }
+    return setrlimit(RLIMIT_AS, &limit) == 0;
 }
 
-void OfflineJudge::SetTimeLimit(int time_limit_sec, int time_limit_usec, void (*handler)(int) = nullptr) const {
+bool OfflineJudge::SetCpuTimeLimit(int time_limit_sec, int time_limit_usec) const {
     if (time_limit_sec == 0 && time_limit_usec == 0) {
-        return;
-    }
-
-    if (handler != nullptr) {
-        signal(SIGALRM, handler);
+        return true;
     }
 
-    itimerval timer;
-
-    timer.it_value.tv_sec = time_limit_sec;
-    timer.it_value.tv_usec = time_limit_usec;
-
-    timer.it_interval.tv_sec = 0;
-    timer.it_interval.tv_usec = 0;
+    rlimit limit;
+    limit.rlim_cur = time_limit_sec + (time_limit_usec > 0 ? 1 : 0);
+    limit.rlim_max = limit.rlim_cur + 1;
 
-    if (setitimer(ITIMER_REAL, &timer, nullptr) == -1) {
-        throw std::runtime_error("ERROR::OfflineJudge: Failed to set timer.");
-    }
+    return setrlimit(RLIMIT_CPU, &limit) == 0;
 }
 
 }
\ No newline at end of file
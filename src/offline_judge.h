@@ -1,14 +1,29 @@
 #ifndef OFFLINE_JUDGE_H
 #define OFFLINE_JUDGE_H
 
+#include <atomic>
+#include <chrono>
 #include <cstdlib>
 #include <filesystem>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 
+#include <sys/wait.h>
+
+#include "buffer_pool.h"
+#include "checker_plugin.h"
+#include "execution_cache.h"
 #include "exit_status.h"
+#include "io_backend.h"
+#include "line_diff.h"
+#include "sampling_profiler.h"
+#include "supervisor.h"
+#include "zygote.h"
 
 #include "compilation_result.h"
 #include "execution_result.h"
@@ -17,6 +32,12 @@
 
 namespace oj {
 
+enum class CompileProfile {
+    DEFAULT,
+    FAST_STARTUP,
+    DEBUG
+};
+
 class OfflineJudge {
 public:
     static OfflineJudge& GetInstance() {
@@ -24,6 +45,12 @@ public:
         return instance;
     }
 
+    ~OfflineJudge() = default;
+    explicit OfflineJudge(BufferPool& buffer_pool = BufferPool::GetInstance())
+        : buffer_pool_(buffer_pool),
+          memory_sample_interval_ms_(10),
+          wall_time_limit_factor_(2.0),
+          io_backend_kind_(IoBackend::Kind::AUTO) {}
     OfflineJudge(const OfflineJudge& other) = delete;
     OfflineJudge(OfflineJudge&& other) noexcept = delete;
 
@@ -32,55 +59,12 @@ public:
 
     template <typename... T>
     std::shared_ptr<CompilationResult> Compile(const std::filesystem::path& source, const std::filesystem::path& target, const std::string& compiler, T... args) {
-        std::string options = Concatenate(args...);
-        std::string command = Concatenate(compiler, source.string(), "-o", target.string(), options);
-
-        if (!std::filesystem::exists(source)) {
-            int status = CreateExitStatus(ExitStatus::COMPILATION_FILE_NOT_EXIST); 
-            std::string message;
-            return CreateCompilationResult(status, message, command, source, target);
-        }
-
-        if (std::filesystem::exists(target) && !IsModifiedLaterThan(source, target)) {
-            int status = CreateExitStatus(ExitStatus::COMPILATION_FILE_UP_TO_DATE);
-            std::string message;
-            return CreateCompilationResult(status, message, command, source, target);
-        }
-
-        int pipefd[2];
-        if (pipe(pipefd) == -1) {
-            throw std::runtime_error("ERROR::OfflineJudge: Failed to open a pipe.");
-        }
-
-        pid_t pid = fork();
-        if (pid < 0) {
-            throw std::runtime_error("ERROR::OfflineJudge: Failed to fork a process with " + program.string() + ".");
-        }
-        if (pid == 0) {
-            close(pipefd[0]);
-            if (dup2(pipefd[1], STDOUT_FILENO) == -1 || dup2(pipefd[1], STDERR_FILENO) == -1) {
-                exit(static_cast<int>(ExitStatus::COMPILATION_DUP_FAILURE));
-            }
-            execl(program.string().c_str(), program.string().c_str(), nullptr);
-            exit(static_cast<int>(ExitStatus::COMPILATION_EXEC_FAILURE));
-        } else {
-            close(pipefd[1]);
-
-            std::string output = ReadFileDescriptiorToString(pipefd[0]);
-
-            close(pipefd[0]);
-
-            int status;
-            if (waitpid(pid, &status, 0) == -1) {
-                throw std::runtime_error("ERROR::OfflineJudge: Failed to wait a child process.");
-            }
+        return CompileWithInput(std::string(), source, target, compiler, args...);
+    }
 
-            if (WIFEXITED(status)) {
-                return CreateCompilationResult(status, message, command, source, target);
-            } else {
-                throw std::runtime_error("ERROR::OfflineJudge: Failed to close a pipe.");
-            }
-        }
+    template <typename... T>
+    std::shared_ptr<CompilationResult> CompileWithProfile(CompileProfile profile, const std::filesystem::path& source, const std::filesystem::path& target, const std::string& compiler, T... args) {
+        return CompileWithInput(GetProfileInput(profile), source, target, compiler, args..., GetProfileOptions(profile, compiler));
     }
 
     /*
@@ -127,7 +111,8 @@ public:
         int                          time_limit_usec, 
         int                          memory_limit_mb,
         const std::string&           input,
-        const std::filesystem::path& output_file = std::filesystem::path()
+        const std::filesystem::path& output_file = std::filesystem::path(),
+        bool                         is_cacheable = true
     ) const;
     std::shared_ptr<ExecutionResult>   ExecuteWithFile (
         const std::filesystem::path& program, 
@@ -135,41 +120,161 @@ public:
         int                          time_limit_usec,
         int                          memory_limit_mb,
         const std::filesystem::path& input_file,
-        const std::filesystem::path& output_file = std::filesystem::path()
+        const std::filesystem::path& output_file = std::filesystem::path(),
+        bool                         is_cacheable = true
+    ) const;
+    std::shared_ptr<ExecutionResult>   ExecuteWithAnswer (
+        const std::filesystem::path& program,
+        int                          time_limit_sec,
+        int                          time_limit_usec,
+        int                          memory_limit_mb,
+        const std::filesystem::path& input_file,
+        const std::filesystem::path& answer_file,
+        bool                         is_whitespace_insensitive = false
+    ) const;
+    std::shared_ptr<ExecutionResult>   ExecuteWithExpectedOutput (
+        const std::filesystem::path& program,
+        int                          time_limit_sec,
+        int                          time_limit_usec,
+        int                          memory_limit_mb,
+        const std::string&           input,
+        const ExpectedOutput&        expected_output
+    ) const;
+    std::shared_ptr<ExecutionResult>   ExecuteWithProfiler (
+        const std::filesystem::path& program,
+        int                          time_limit_sec,
+        int                          time_limit_usec,
+        int                          memory_limit_mb,
+        const std::filesystem::path& input_file,
+        int                          sample_frequency_hz = 499,
+        size_t                       max_functions = 10
     ) const;
+    void                               SetExecutionCache(const std::shared_ptr<ExecutionCache>& execution_cache);
+    void                               SetMemorySampleInterval(int sample_interval_ms);
+    void                               SetWallTimeLimitFactor(double wall_time_limit_factor);
+    void                               SetIoBackend(IoBackend::Kind io_backend_kind);
+    void                               SetRuntime(const std::string& extension, const std::shared_ptr<Zygote>& zygote);
+
     std::shared_ptr<JudgeResult>       Judge(const std::string& user_answer, const std::string& correct_answer) const;
     std::shared_ptr<JudgeResult>       JudgeWithFile (
         const std::filesystem::path& user_answer, 
         const std::filesystem::path& correct_answer
     ) const;
+    std::shared_ptr<JudgeResult>       JudgeWithIndex(const std::string& user_answer, const std::filesystem::path& correct_answer) const;
+    std::shared_ptr<JudgeResult>       JudgeExecution (
+        const ExecutionResult&       execution_result,
+        const std::filesystem::path& correct_answer,
+        bool                         is_whitespace_insensitive = false
+    ) const;
+    std::shared_ptr<JudgeResult>       JudgeWithTokens (
+        const std::string&           user_answer,
+        const std::filesystem::path& correct_answer,
+        double                       epsilon = 0.0
+    ) const;
+    std::shared_ptr<JudgeResult>       JudgeWithPlugin (
+        const std::filesystem::path& plugin,
+        const std::filesystem::path& input_file,
+        const std::string&           user_answer,
+        const std::filesystem::path& correct_answer
+    ) const;
     std::shared_ptr<SubmissionResult>  Submit (
         const std::shared_ptr<CompilationResult>&            compilation_result,
         const std::vector<std::shared_ptr<ExecutionResult>>& execution_results,
         const std::vector<std::shared_ptr<JudgeResult>>&     judge_results 
     ) const;
+    std::shared_ptr<SubmissionResult>  Submit (
+        const std::shared_ptr<CompilationResult>&            compilation_result,
+        const std::vector<std::shared_ptr<ExecutionResult>>& execution_results,
+        const std::vector<std::shared_ptr<JudgeResult>>&     judge_results,
+        const SubmissionSummary&                             summary
+    ) const;
 
 private:
-    ~OfflineJudge() = default;
-
-    OfflineJudge() = default;
-
-    static void TimeOutHandler(int signal) {
-        exit(static_cast<int>(ExitStatus::EXECUTION_TIMEOUT));
-    }
-
     template <typename... T>
     std::string Concatenate(T... args) {
         std::ostringstream os;
-        (os << (os.tellp() ? " " : "") << args, ...);
+        ((os << (os.tellp() ? " " : "") << args), ...);
         return os.str();
     }
 
+    template <typename... T>
+    std::shared_ptr<CompilationResult> CompileWithInput(const std::string& input, const std::filesystem::path& source, const std::filesystem::path& target, const std::string& compiler, T... args) {
+        std::string options = Concatenate(args...);
+        std::string command = Concatenate(compiler, source.string(), "-o", target.string(), options);
+        auto start = std::chrono::steady_clock::now();
+
+        if (!std::filesystem::exists(source)) {
+            int status = CreateExitStatus(ExitStatus::COMPILATION_FILE_NOT_EXIST); 
+            std::string message;
+            return CreateCompilationResult(status, message, command, source, target);
+        }
+
+        if (std::filesystem::exists(target) && !IsModifiedLaterThan(source, target) && IsStampMatched(target, command, input)) {
+            int status = CreateExitStatus(ExitStatus::COMPILATION_FILE_UP_TO_DATE);
+            std::string message;
+            RecordCompilation(true, start);
+            SetProbed(target, !input.empty());
+            return CreateCompilationResult(status, message, command, source, target);
+        }
+
+        std::string message;
+        int status = RunCommand(command, message, input);
+        RecordCompilation(false, start);
+        if (WIFEXITED(status)) {
+            WriteStamp(target, command, input, WEXITSTATUS(status) == EXIT_SUCCESS);
+            SetProbed(target, WEXITSTATUS(status) == EXIT_SUCCESS && !input.empty());
+            return CreateCompilationResult(status, message, command, source, target);
+        } else {
+            throw std::runtime_error("ERROR::OfflineJudge: Failed to run a command \"" + command + "\".");
+        }
+    }
+
+    std::shared_ptr<ExecutionResult> ExecuteProgram (
+        const std::filesystem::path& program,
+        int                          time_limit_sec,
+        int                          time_limit_usec,
+        int                          memory_limit_mb,
+        const std::string&           input,
+        const std::filesystem::path& output_file,
+        const ExpectedOutput*        expected_output,
+        const SamplingOptions*       sampling_options = nullptr,
+        bool                         is_cacheable = true
+    ) const;
+    void                           RecordCompilation(bool is_up_to_date, std::chrono::steady_clock::time_point start) const;
+    std::shared_ptr<CheckerPlugin> LoadPlugin(const std::filesystem::path& plugin) const;
+    IoBackend&                     GetIoBackend() const;
+    std::shared_ptr<Zygote>        FindRuntime(const std::filesystem::path& program) const;
+    std::string                    GetProfileOptions(CompileProfile profile, const std::string& compiler);
+    std::string                    GetProfileInput(CompileProfile profile) const;
+    bool                           IsLinkable(const std::string& compiler, const std::string& options);
+    bool                           IsStampMatched(const std::filesystem::path& target, const std::string& command, const std::string& input) const;
+    void                           WriteStamp(const std::filesystem::path& target, const std::string& command, const std::string& input, bool is_success) const;
+    void                           SetProbed(const std::filesystem::path& target, bool is_probed);
+    bool                           IsProbed(const std::filesystem::path& program) const;
+    int                            RunCommand(const std::string& command, std::string& output, const std::string& input = std::string()) const;
+    long                           ReadStartupProbe(int fd) const;
+
     std::string ReadFileToString(const std::filesystem::path& file) const;
     std::string ReadFileDescriptiorToString(int fd) const;
     void        WriteStringToFile(const std::filesystem::path& file, const std::string& s) const;
-    void        SetMemoryUsageLimit(int memory_limit_mb) const;
-    void        SetTimeLimit(int time_limit_sec, int time_limit_usec, void (*handler)(int) = nullptr) const;
+    bool        SetMemoryUsageLimit(int memory_limit_mb) const;
+    bool        SetCpuTimeLimit(int time_limit_sec, int time_limit_usec) const;
     bool        IsModifiedLaterThan(const std::filesystem::path& lhs, const std::filesystem::path& rhs) const;
+
+    LineDiff                                                                line_diff_;
+    std::shared_ptr<ExecutionCache>                                         execution_cache_;
+    BufferPool&                                                             buffer_pool_;
+    std::atomic<int>                                                        memory_sample_interval_ms_;
+    std::atomic<double>                                                     wall_time_limit_factor_;
+    std::atomic<IoBackend::Kind>                                            io_backend_kind_;
+    mutable std::mutex                                                      plugin_mutex_;
+    mutable std::unordered_map<std::string, std::shared_ptr<CheckerPlugin>> plugins_;
+    mutable std::mutex                                                      runtime_mutex_;
+    std::unordered_map<std::string, std::shared_ptr<Zygote>>                runtimes_;
+    std::mutex                                                              profile_mutex_;
+    std::unordered_map<std::string, std::string>                            fast_startup_options_;
+    mutable std::mutex                                                      probe_mutex_;
+    std::unordered_set<std::string>                                         probed_programs_;
 };
 
 }
@@ -0,0 +1,283 @@
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+
+#include "metrics.h"
+#include "offline_judge.h"
+#include "pipeline.h"
+
+namespace oj {
+
+namespace {
+
+std::atomic<size_t> next_pipeline_id(0);
+
+}
+
+Pipeline::~Pipeline() {
+    Close();
+}
+
+Pipeline::Pipeline (
+    size_t                  compile_workers,
+    size_t                  execute_workers,
+    size_t                  judge_workers,
+    size_t                  queue_capacity,
+    OfflineJudge&           judge,
+    const SchedulerOptions& scheduler_options
+) : judge_(judge),
+    compile_queue_(queue_capacity),
+    execute_queue_(queue_capacity, scheduler_options),
+    judge_queue_(queue_capacity),
+    aggregate_queue_(queue_capacity),
+    is_closed_(false) {
+    if (execute_workers == 0) {
+        execute_workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (size_t i = 0; i < std::max<size_t>(compile_workers, 1); ++i) {
+        compile_workers_.emplace_back(&Pipeline::CompileLoop, this);
+    }
+    for (size_t i = 0; i < execute_workers; ++i) {
+        execute_workers_.emplace_back(&Pipeline::ExecuteLoop, this);
+    }
+    for (size_t i = 0; i < std::max<size_t>(judge_workers, 1); ++i) {
+        judge_workers_.emplace_back(&Pipeline::JudgeLoop, this);
+    }
+    aggregate_worker_ = std::thread(&Pipeline::AggregateLoop, this);
+
+    Metrics& metrics = Metrics::GetInstance();
+    std::string pipeline = "pipeline=\"" + std::to_string(next_pipeline_id++) + "\",";
+    metric_callbacks_ = {
+        metrics.AddCallback("oj_queue_depth", "Items waiting in a pipeline queue.", pipeline + "queue=\"compile\"", [this]() { return compile_queue_.size(); }),
+        metrics.AddCallback("oj_queue_depth", "Items waiting in a pipeline queue.", pipeline + "queue=\"execute\"", [this]() { return execute_queue_.size(); }),
+        metrics.AddCallback("oj_queue_depth", "Items waiting in a pipeline queue.", pipeline + "queue=\"judge\"", [this]() { return judge_queue_.size(); }),
+        metrics.AddCallback("oj_queue_depth", "Items waiting in a pipeline queue.", pipeline + "queue=\"aggregate\"", [this]() { return aggregate_queue_.size(); })
+    };
+}
+
+std::future<std::shared_ptr<SubmissionResult>> Pipeline::Submit(PipelineSubmission submission) {
+    std::shared_ptr<Job> job = std::make_shared<Job>();
+    job->submission = std::move(submission);
+    job->remaining = job->submission.test_cases.size();
+    job->is_failed = false;
+    job->is_stopped = false;
+
+    std::future<std::shared_ptr<SubmissionResult>> result = job->promise.get_future();
+    compile_queue_.Push(job);
+    return result;
+}
+
+void Pipeline::Close() {
+    std::lock_guard<std::mutex> lock(close_mutex_);
+    if (is_closed_) {
+        return;
+    }
+    is_closed_ = true;
+
+    for (size_t id : metric_callbacks_) {
+        Metrics::GetInstance().RemoveCallback(id);
+    }
+
+    compile_queue_.Close();
+    for (std::thread& worker : compile_workers_) {
+        worker.join();
+    }
+    execute_queue_.Close();
+    for (std::thread& worker : execute_workers_) {
+        worker.join();
+    }
+    judge_queue_.Close();
+    for (std::thread& worker : judge_workers_) {
+        worker.join();
+    }
+    aggregate_queue_.Close();
+    aggregate_worker_.join();
+}
+
+RuntimeHistory& Pipeline::runtime_history() {
+    return runtime_history_;
+}
+
+void Pipeline::Fail(const std::shared_ptr<Job>& job) {
+    if (!job->is_failed.exchange(true)) {
+        job->promise.set_exception(std::current_exception());
+    }
+}
+
+void Pipeline::CompileLoop() {
+    while (std::optional<std::shared_ptr<Job>> job = compile_queue_.Pop()) {
+        try {
+            const PipelineSubmission& submission = (*job)->submission;
+            (*job)->compilation_result = judge_.CompileWithProfile(
+                submission.profile,
+                submission.source,
+                submission.target,
+                submission.compiler,
+                submission.compile_options
+            );
+
+            if (!(*job)->compilation_result->is_success() || submission.test_cases.empty()) {
+                Finish(*job);
+                continue;
+            }
+
+            (*job)->execution_results.resize(submission.test_cases.size());
+            (*job)->judge_results.resize(submission.test_cases.size());
+            std::vector<size_t> order(submission.test_cases.size());
+            std::vector<double> failure_rates(submission.test_cases.size());
+            for (size_t i = 0; i < submission.test_cases.size(); ++i) {
+                order[i] = i;
+                failure_rates[i] = runtime_history_.FailureRate(submission.problem, submission.test_cases[i].input_file.string());
+            }
+            if (submission.stop_on_first_failure) {
+                std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+                    return failure_rates[lhs] > failure_rates[rhs];
+                });
+            }
+
+            std::vector<std::pair<Task, double>> tasks;
+            tasks.reserve(order.size());
+            for (size_t i : order) {
+                double expected_ms = runtime_history_.Estimate(submission.problem, submission.test_cases[i].input_file.string());
+                tasks.push_back({{*job, i, nullptr, nullptr}, expected_ms});
+            }
+            execute_queue_.Push(job->get(), submission.lane, std::move(tasks));
+        } catch (...) {
+            Fail(*job);
+        }
+    }
+}
+
+void Pipeline::ExecuteLoop() {
+    while (std::optional<Task> task = execute_queue_.Pop()) {
+        if (task->job->is_failed) {
+            continue;
+        }
+        if (task->job->is_stopped) {
+            aggregate_queue_.Push(std::move(*task));
+            continue;
+        }
+
+        try {
+            const PipelineSubmission& submission = task->job->submission;
+            const PipelineTestCase& test_case = submission.test_cases[task->test_index];
+            auto start = std::chrono::steady_clock::now();
+            task->execution_result = judge_.ExecuteWithAnswer(
+                submission.target,
+                submission.time_limit_sec,
+                submission.time_limit_usec,
+                submission.memory_limit_mb,
+                test_case.input_file,
+                test_case.answer_file
+            );
+            double wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            double cpu_ms = task->execution_result->elapsed_time_sec() * 1000.0 + task->execution_result->elapsed_time_usec() / 1000.0;
+            runtime_history_.Record(submission.problem, test_case.input_file.string(), cpu_ms, wall_ms);
+            if (submission.profile_timeouts && dynamic_cast<const ExecutionFailureTimeout*>(task->execution_result.get()) != nullptr) {
+                Profile(*task);
+            }
+
+            if (task->execution_result->is_success()) {
+                judge_queue_.Push(std::move(*task));
+            } else {
+                if (submission.stop_on_first_failure) {
+                    task->job->is_stopped = true;
+                }
+                aggregate_queue_.Push(std::move(*task));
+            }
+        } catch (...) {
+            Fail(task->job);
+        }
+    }
+}
+
+void Pipeline::JudgeLoop() {
+    while (std::optional<Task> task = judge_queue_.Pop()) {
+        if (task->job->is_failed) {
+            continue;
+        }
+
+        try {
+            const std::filesystem::path& answer_file = task->job->submission.test_cases[task->test_index].answer_file;
+            task->judge_result = judge_.JudgeExecution(*task->execution_result, answer_file);
+            if (!task->judge_result->is_success() && task->job->submission.stop_on_first_failure) {
+                task->job->is_stopped = true;
+            }
+            aggregate_queue_.Push(std::move(*task));
+        } catch (...) {
+            Fail(task->job);
+        }
+    }
+}
+
+void Pipeline::AggregateLoop() {
+    while (std::optional<Task> task = aggregate_queue_.Pop()) {
+        std::shared_ptr<Job>& job = task->job;
+        if (job->is_failed) {
+            continue;
+        }
+
+        job->summary.Add(task->execution_result.get(), task->judge_result.get());
+        if (task->execution_result != nullptr) {
+            bool is_failure = !task->execution_result->is_success() || (task->judge_result != nullptr && !task->judge_result->is_success());
+            runtime_history_.RecordVerdict(job->submission.problem, job->submission.test_cases[task->test_index].input_file.string(), is_failure);
+        }
+
+        job->execution_results[task->test_index] = std::move(task->execution_result);
+        job->judge_results[task->test_index] = std::move(task->judge_result);
+        if (--job->remaining == 0) {
+            Finish(job);
+        }
+    }
+}
+
+void Pipeline::Profile(Task& task) {
+    const PipelineSubmission& submission = task.job->submission;
+    const PipelineTestCase& test_case = submission.test_cases[task.test_index];
+    try {
+        std::call_once(task.job->profile_once, [&]() {
+            if (submission.profile == CompileProfile::DEBUG) {
+                task.job->profile_target = submission.target;
+                return;
+            }
+
+            std::filesystem::path target = submission.target;
+            target += ".profile";
+            std::shared_ptr<CompilationResult> compilation_result = judge_.CompileWithProfile(
+                CompileProfile::DEBUG,
+                submission.source,
+                target,
+                submission.compiler,
+                submission.compile_options
+            );
+            if (compilation_result->is_success()) {
+                task.job->profile_target = target;
+            }
+        });
+        if (task.job->profile_target.empty()) {
+            return;
+        }
+
+        std::shared_ptr<ExecutionResult> profiled_result = judge_.ExecuteWithProfiler(
+            task.job->profile_target,
+            submission.time_limit_sec,
+            submission.time_limit_usec,
+            submission.memory_limit_mb,
+            test_case.input_file
+        );
+        task.execution_result->set_sampling_profile(profiled_result->sampling_profile());
+    } catch (const std::exception&) {
+    }
+}
+
+void Pipeline::Finish(const std::shared_ptr<Job>& job) {
+    try {
+        job->promise.set_value(judge_.Submit(job->compilation_result, job->execution_results, job->judge_results, job->summary));
+    } catch (...) {
+        Fail(job);
+    }
+}
+
+}
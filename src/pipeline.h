@@ -0,0 +1,117 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <atomic>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bounded_queue.h"
+#include "offline_judge.h"
+#include "runtime_history.h"
+#include "scheduler.h"
+
+#include "compilation_result.h"
+#include "execution_result.h"
+#include "judge_result.h"
+#include "submission_result.h"
+
+namespace oj {
+
+struct PipelineTestCase {
+    std::filesystem::path input_file;
+    std::filesystem::path answer_file;
+};
+
+struct PipelineSubmission {
+    std::filesystem::path         source;
+    std::filesystem::path         target;
+    std::string                   compiler;
+    std::string                   compile_options;
+    int                           time_limit_sec;
+    int                           time_limit_usec;
+    int                           memory_limit_mb;
+    std::vector<PipelineTestCase> test_cases;
+    CompileProfile                profile = CompileProfile::DEFAULT;
+    std::string                   problem;
+    SchedulingLane                lane = SchedulingLane::CONTEST;
+    bool                          stop_on_first_failure = false;
+    bool                          profile_timeouts = false;
+};
+
+class Pipeline {
+public:
+    ~Pipeline();
+    Pipeline (
+        size_t                  compile_workers = 1,
+        size_t                  execute_workers = 0,
+        size_t                  judge_workers = 1,
+        size_t                  queue_capacity = 64,
+        OfflineJudge&           judge = OfflineJudge::GetInstance(),
+        const SchedulerOptions& scheduler_options = SchedulerOptions()
+    );
+    Pipeline(const Pipeline& other) = delete;
+    Pipeline(Pipeline&& other) = delete;
+
+    Pipeline& operator=(const Pipeline& other) = delete;
+    Pipeline& operator=(Pipeline&& other) = delete;
+
+    std::future<std::shared_ptr<SubmissionResult>> Submit(PipelineSubmission submission);
+    void                                           Close();
+
+    RuntimeHistory&                                runtime_history();
+
+private:
+    struct Job {
+        PipelineSubmission                              submission;
+        std::shared_ptr<CompilationResult>              compilation_result;
+        std::vector<std::shared_ptr<ExecutionResult>>   execution_results;
+        std::vector<std::shared_ptr<JudgeResult>>       judge_results;
+        SubmissionSummary                               summary;
+        size_t                                          remaining;
+        std::atomic<bool>                               is_failed;
+        std::atomic<bool>                               is_stopped;
+        std::promise<std::shared_ptr<SubmissionResult>> promise;
+        std::once_flag                                  profile_once;
+        std::filesystem::path                           profile_target;
+    };
+
+    struct Task {
+        std::shared_ptr<Job>             job;
+        size_t                           test_index;
+        std::shared_ptr<ExecutionResult> execution_result;
+        std::shared_ptr<JudgeResult>     judge_result;
+    };
+
+    static void Fail(const std::shared_ptr<Job>& job);
+
+    void CompileLoop();
+    void ExecuteLoop();
+    void JudgeLoop();
+    void AggregateLoop();
+    void Profile(Task& task);
+    void Finish(const std::shared_ptr<Job>& job);
+
+    OfflineJudge&                      judge_;
+    std::vector<size_t>                metric_callbacks_;
+    RuntimeHistory                     runtime_history_;
+    BoundedQueue<std::shared_ptr<Job>> compile_queue_;
+    Scheduler<Task>                    execute_queue_;
+    BoundedQueue<Task>                 judge_queue_;
+    BoundedQueue<Task>                 aggregate_queue_;
+
+    std::mutex                         close_mutex_;
+    bool                               is_closed_;
+    std::vector<std::thread>           compile_workers_;
+    std::vector<std::thread>           execute_workers_;
+    std::vector<std::thread>           judge_workers_;
+    std::thread                        aggregate_worker_;
+};
+
+}
+
+#endif
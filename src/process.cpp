@@ -13,39 +13,34 @@
 
 namespace oj {
 
-static std::unique_ptr<Process> CreateProcess () {
+std::unique_ptr<Process> Process::CreateProcess () {
     return std::make_unique<Process>();
 }
 
-static std::unique_ptr<Process> CreateProcess (
+std::unique_ptr<Process> Process::CreateProcess (
     const std::filesystem::path&    program, 
     const std::vector<std::string>& args,
     const FileDescriptor&           std_in,
     const FileDescriptor&           std_out,
     const FileDescriptor&           std_err) {
     std::unique_ptr<Process> process = std::make_unique<Process>();
+    std::string program_path = program.string();
+    std::unique_ptr<char*[]> c_args = process->GetCArgs(args);
+
     process->Fork();
     if (process->is_child()) {
-        if (std_in.is_opened()) {
-            FD_STD_IN.Redirect(std_in);
-        }
-
-        if (std_out.is_opened()) {
-            FD_STD_OUT.Redirect(std_out);
-        }
-
-        if (std_err.is_opened()) {
-            FD_STD_ERR.Redirect(std_err);
+        const FileDescriptor* redirects[] = {&std_in, &std_out, &std_err};
+        for (int target = STDIN_FILENO; target <= STDERR_FILENO; ++target) {
+            if (redirects[target]->is_opened() && dup2(redirects[target]->fd(), target) == -1) {
+                _exit(EXIT_FAILURE);
+            }
         }
     }
-    process->Execute(program, args);
-};
-
-bool Process::HasInstance() {
-    return has_instance_;
+    process->Execute(program_path.c_str(), c_args.get());
+    return process;
 }
 
-void Process::MemoryLimitHandler(int sig) {
+void Process::MemoryLimitHandler(int) {
     if (errno == ENOMEM) {
         exit(static_cast<int>(ExitStatus::OUT_OF_MEMORY));
     } else {
@@ -54,10 +49,6 @@ void Process::MemoryLimitHandler(int sig) {
     }
 }
 
-void Process::TimeLimitHandler(int sig) {
-    exit(static_cast<int>(ExitStatus::TIMEOUT));
-}
-
 void Process::ExceptionHandler() {
     try {
         std::exception_ptr eptr(std::current_exception());
@@ -79,12 +70,9 @@ void Process::ExceptionHandler() {
 
 Process::~Process () {
     ClosePipe();
-    has_instance_ = false;
 }
 
-Process::Process() : pid_(-1), status_(-1) {
-    has_instance_ = true;
-}
+Process::Process() : pid_(-1), pipe_in_(-1), pipe_out_(-1), status_(-1) {}
 
 void Process::Fork() {
     if (is_forked()) {
@@ -96,7 +84,7 @@ void Process::Fork() {
     }
 }
 
-void Process::Execute(const std::filesystem::path& program, const std::vector<std::string>& args) {
+void Process::Execute(const char* program, char* const args[]) const {
     if (!is_forked()) {
         throw std::runtime_error("ERROR::Process: Process is not yet forked.");
     }
@@ -105,9 +93,13 @@ void Process::Execute(const std::filesystem::path& program, const std::vector<st
         return;
     }
 
-    std::unique_ptr<char*[]> c_args = GetCArgs(args);
-    execv(program.string().c_str(), c_args.get());
-    exit(EXIT_FAILURE);
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGPIPE);
+    sigprocmask(SIG_UNBLOCK, &signals, nullptr);
+    signal(SIGPIPE, SIG_DFL);
+    execv(program, args);
+    _exit(EXIT_FAILURE);
 }
 
 void Process::Wait() {
@@ -119,11 +111,21 @@ void Process::Wait() {
         throw std::runtime_error("ERROR::Process: Can't wait a process not forked.");
     }
 
-    if (wait4(pid_, &status_, NULL, &usage_) == -1) {
+    if (wait4(pid_, &status_, 0, &usage_) == -1) {
         throw std::system_error(errno, std::generic_category(), "ERROR::Process: Failed to wait a child process with error.");
     }
 }
 
+void Process::Kill(int sig) const {
+    if (!is_parent() || !is_forked()) {
+        return;
+    }
+
+    if (kill(pid_, sig) == -1 && errno != ESRCH) {
+        throw std::system_error(errno, std::generic_category(), "ERROR::Process: Failed to send a signal.");
+    }
+}
+
 void Process::OpenPipe() {
     if (is_forked()) {
         throw std::runtime_error("ERROR::Process: Can't open a pipe after fork.");
@@ -193,25 +195,17 @@ void Process::SetMemoryLimit(int memory_limit_mb, void (*handler)(int)) const {
     }
 }
 
-void Process::SetTimeLimit(int time_limit_sec, int time_limit_usec, void (*handler)(int)) const {
+void Process::SetTimeLimit(int time_limit_sec, int time_limit_usec) const {
     if (!is_child() || (time_limit_sec == 0 && time_limit_usec == 0)) {
         return;
     }
 
-    if (handler != nullptr) {
-        SetSignalHandler(SIGALRM, handler);
-    }
-
-    itimerval timer;
-
-    timer.it_interval.tv_sec = 0;
-    timer.it_interval.tv_usec = 0;
-
-    timer.it_value.tv_sec = time_limit_sec;
-    timer.it_value.tv_usec = time_limit_usec;
+    rlimit limit;
+    limit.rlim_cur = time_limit_sec + (time_limit_usec > 0 ? 1 : 0);
+    limit.rlim_max = limit.rlim_cur + 1;
 
-    if (setitimer(ITIMER_REAL, &timer, nullptr) == -1) {
-        throw std::system_error(errno, std::generic_category(), "ERROR::Process: Failed to set a timer.");
+    if (setrlimit(RLIMIT_CPU, &limit) == -1) {
+        throw std::system_error(errno, std::generic_category(), "ERROR::Process: Failed to set a CPU time limit.");
     }
 }
 
@@ -243,6 +237,10 @@ const FileDescriptor& Process::pipe_out() const {
     return pipe_out_;
 }
 
+pid_t Process::pid() const {
+    return pid_;
+}
+
 int Process::status() const {
     return status_;
 }
@@ -279,8 +277,6 @@ int Process::memory_usage_mb() const {
     return usage_.ru_maxrss / KB; 
 }
 
-bool Process::has_instance_ = false;
-
 std::unique_ptr<char*[]> Process::GetCArgs(const std::vector<std::string>& args) const {
     std::unique_ptr<char*[]> c_args(new char*[args.size() + 1]);
     for (size_t i = 0; i < args.size(); ++i) {
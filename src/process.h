@@ -6,6 +6,9 @@
 #include <string>
 #include <memory>
 
+#include <signal.h>
+#include <sys/resource.h>
+
 #include "file_descriptor.h"
 
 namespace oj {
@@ -20,12 +23,8 @@ public:
         const FileDescriptor&           std_out = FD_EMPTY,
         const FileDescriptor&           std_err = FD_EMPTY);
 
-    static bool HasInstance();
-
     static void MemoryLimitHandler(int sig);
 
-    static void TimeLimitHandler(int sig);
-
     static void ExceptionHandler();
 
     ~Process();
@@ -37,8 +36,9 @@ public:
     Process& operator=(Process&& other) noexcept = delete;
 
     void                  Fork();
-    void                  Execute(const std::filesystem::path& program, const std::vector<std::string>& args);
+    void                  Execute(const char* program, char* const args[]) const;
     void                  Wait();
+    void                  Kill(int sig = SIGKILL) const;
     void                  OpenPipe();
     void                  ClosePipe();
     void                  ReadFromPipe(std::ostream& out, bool is_child) const;
@@ -46,7 +46,7 @@ public:
     void                  SetSignalHandler(int sig, void (*handler)(int)) const;
     void                  SetTerminateHandler(std::terminate_handler handler = ExceptionHandler) const;
     void                  SetMemoryLimit(int memory_limit_mb, void (*handler)(int) = MemoryLimitHandler) const;
-    void                  SetTimeLimit(int time_limit_sec, int time_limit_usec, void (*handler)(int) = TimeLimitHandler) const;
+    void                  SetTimeLimit(int time_limit_sec, int time_limit_usec) const;
 
     bool                  is_child() const;
     bool                  is_parent() const;
@@ -57,6 +57,7 @@ public:
     const FileDescriptor& pipe_in() const;
     const FileDescriptor& pipe_out() const;
 
+    pid_t                 pid() const;
     int                   status() const;
     int                   execution_time_sec() const;
     int                   execution_time_usec() const;
@@ -67,8 +68,6 @@ private:
     static constexpr int      KB = 1024;
     static constexpr int      MB = 1024 * 1024;
 
-    static bool               has_instance_;
-
     std::unique_ptr<char* []> GetCArgs(const std::vector<std::string>& args) const;
 
     pid_t                     pid_;
@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+
+#include "hash.h"
+#include "offline_judge.h"
+#include "reducer.h"
+
+#include "execution_result.h"
+#include "judge_result.h"
+
+namespace oj {
+
+Reducer::Reducer (
+    const std::filesystem::path& candidate,
+    const std::filesystem::path& reference,
+    int                          time_limit_sec,
+    int                          time_limit_usec,
+    int                          memory_limit_mb,
+    size_t                       workers,
+    OfflineJudge&                judge
+) : judge_(judge),
+    candidate_(candidate),
+    reference_(reference),
+    time_limit_sec_(time_limit_sec),
+    time_limit_usec_(time_limit_usec),
+    memory_limit_mb_(memory_limit_mb),
+    workers_(workers != 0 ? workers : std::max(1u, std::thread::hardware_concurrency())),
+    trials_(0),
+    cache_hits_(0) {}
+
+void Reducer::AddStructureHook(StructureHook hook) {
+    hooks_.push_back(std::move(hook));
+}
+
+ReductionReport Reducer::Reduce(const std::string& failing_input) {
+    auto start = std::chrono::steady_clock::now();
+
+    if (!IsFailing(failing_input)) {
+        throw std::invalid_argument("ERROR::Reducer: The given input doesn't make the candidate diverge from the reference.");
+    }
+
+    std::string input = failing_input;
+    bool is_reduced = true;
+    while (is_reduced) {
+        is_reduced = ReducePass(input, Granularity::LINE);
+        is_reduced = ReducePass(input, Granularity::TOKEN) || is_reduced;
+    }
+
+    ReductionReport report;
+    report.input = input;
+    report.original_size = failing_input.size();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        report.trials = trials_;
+        report.cache_hits = cache_hits_;
+    }
+    report.elapsed_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+bool Reducer::IsFailing(const std::string& input) {
+    uint64_t key = Hash64(input);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = verdicts_.find(key);
+        if (it != verdicts_.end()) {
+            ++cache_hits_;
+            return it->second;
+        }
+    }
+
+    bool is_failing = false;
+    std::shared_ptr<ExecutionResult> reference = judge_.Execute(reference_, time_limit_sec_, time_limit_usec_, memory_limit_mb_, input, std::filesystem::path(), false);
+    if (reference->is_success()) {
+        std::shared_ptr<ExecutionResult> candidate = judge_.Execute(candidate_, time_limit_sec_, time_limit_usec_, memory_limit_mb_, input, std::filesystem::path(), false);
+        is_failing = !candidate->is_success() || !judge_.Judge(candidate->output(), reference->output())->is_success();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++trials_;
+    verdicts_[key] = is_failing;
+    return is_failing;
+}
+
+std::vector<std::string> Reducer::Split(const std::string& input, Granularity granularity) {
+    std::vector<std::string> units;
+    size_t begin = 0;
+    while (begin < input.size()) {
+        size_t end;
+        if (granularity == Granularity::LINE) {
+            end = input.find('\n', begin);
+            end = end == std::string::npos ? input.size() : end + 1;
+        } else {
+            end = begin;
+            while (end < input.size() && !std::isspace(static_cast<unsigned char>(input[end]))) {
+                ++end;
+            }
+            while (end < input.size() && std::isspace(static_cast<unsigned char>(input[end]))) {
+                ++end;
+            }
+        }
+        units.push_back(input.substr(begin, end - begin));
+        begin = end;
+    }
+    return units;
+}
+
+std::string Reducer::Join(const std::vector<std::string>& units, size_t skip_begin, size_t skip_end) {
+    std::string joined;
+    for (size_t i = 0; i < units.size(); ++i) {
+        if (i < skip_begin || i >= skip_end) {
+            joined += units[i];
+        }
+    }
+    return joined;
+}
+
+bool Reducer::ReducePass(std::string& input, Granularity granularity) {
+    std::vector<std::string> units = Split(input, granularity);
+    bool is_reduced = false;
+    size_t granules = 2;
+
+    while (units.size() >= 2) {
+        size_t chunk = (units.size() + granules - 1) / granules;
+
+        std::vector<std::string> variants;
+        for (size_t begin = 0; begin < units.size(); begin += chunk) {
+            std::optional<std::string> variant = ApplyHooks(Join(units, begin, std::min(begin + chunk, units.size())));
+            if (variant.has_value() && *variant != input && variant->size() <= input.size()) {
+                variants.push_back(std::move(*variant));
+            }
+        }
+
+        size_t failing = FindFirstFailing(variants);
+        if (failing != variants.size()) {
+            input = std::move(variants[failing]);
+            units = Split(input, granularity);
+            granules = std::max<size_t>(granules - 1, 2);
+            is_reduced = true;
+        } else if (granules >= units.size()) {
+            break;
+        } else {
+            granules = std::min(granules * 2, units.size());
+        }
+    }
+
+    return is_reduced;
+}
+
+std::optional<std::string> Reducer::ApplyHooks(const std::string& variant) const {
+    std::optional<std::string> result = variant;
+    for (const StructureHook& hook : hooks_) {
+        result = hook(*result);
+        if (!result.has_value()) {
+            break;
+        }
+    }
+    return result;
+}
+
+size_t Reducer::FindFirstFailing(const std::vector<std::string>& variants) {
+    for (size_t batch = 0; batch < variants.size(); batch += workers_) {
+        size_t batch_end = std::min(batch + workers_, variants.size());
+        std::vector<char> is_failing(batch_end - batch, false);
+
+        std::atomic<size_t> next(batch);
+        std::mutex exception_mutex;
+        std::exception_ptr exception;
+        std::vector<std::thread> threads;
+        for (size_t i = batch; i < batch_end; ++i) {
+            threads.emplace_back([&]() {
+                try {
+                    size_t index;
+                    while ((index = next.fetch_add(1)) < batch_end) {
+                        is_failing[index - batch] = IsFailing(variants[index]);
+                    }
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(exception_mutex);
+                    exception = std::current_exception();
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        if (exception != nullptr) {
+            std::rethrow_exception(exception);
+        }
+
+        for (size_t i = batch; i < batch_end; ++i) {
+            if (is_failing[i - batch]) {
+                return i;
+            }
+        }
+    }
+
+    return variants.size();
+}
+
+}
@@ -0,0 +1,79 @@
+#ifndef REDUCER_H
+#define REDUCER_H
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "offline_judge.h"
+
+namespace oj {
+
+struct ReductionReport {
+    std::string input;
+    size_t      original_size;
+    size_t      trials;
+    size_t      cache_hits;
+    double      elapsed_sec;
+};
+
+class Reducer {
+public:
+    using StructureHook = std::function<std::optional<std::string>(const std::string& variant)>;
+
+    ~Reducer() = default;
+    Reducer (
+        const std::filesystem::path& candidate,
+        const std::filesystem::path& reference,
+        int                          time_limit_sec,
+        int                          time_limit_usec,
+        int                          memory_limit_mb,
+        size_t                       workers = 0,
+        OfflineJudge&                judge = OfflineJudge::GetInstance()
+    );
+    Reducer(const Reducer& other) = delete;
+    Reducer(Reducer&& other) = delete;
+
+    Reducer& operator=(const Reducer& other) = delete;
+    Reducer& operator=(Reducer&& other) = delete;
+
+    void            AddStructureHook(StructureHook hook);
+    ReductionReport Reduce(const std::string& failing_input);
+    bool            IsFailing(const std::string& input);
+
+private:
+    enum class Granularity {
+        LINE,
+        TOKEN
+    };
+
+    static std::vector<std::string> Split(const std::string& input, Granularity granularity);
+    static std::string              Join(const std::vector<std::string>& units, size_t skip_begin, size_t skip_end);
+
+    bool                            ReducePass(std::string& input, Granularity granularity);
+    std::optional<std::string>      ApplyHooks(const std::string& variant) const;
+    size_t                          FindFirstFailing(const std::vector<std::string>& variants);
+
+    OfflineJudge&                      judge_;
+    std::filesystem::path              candidate_;
+    std::filesystem::path              reference_;
+    int                                time_limit_sec_;
+    int                                time_limit_usec_;
+    int                                memory_limit_mb_;
+    size_t                             workers_;
+    std::vector<StructureHook>         hooks_;
+
+    std::mutex                         mutex_;
+    std::unordered_map<uint64_t, bool> verdicts_;
+    size_t                             trials_;
+    size_t                             cache_hits_;
+};
+
+}
+
+#endif
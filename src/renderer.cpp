@@ -0,0 +1,152 @@
+#include "renderer.h"
+
+#include "compilation_result.h"
+#include "execution_result.h"
+#include "judge_result.h"
+#include "submission_result.h"
+
+namespace oj {
+
+namespace {
+
+void RenderExecution(std::ostream& os, const char* verdict, const ExecutionResult& result) {
+    os << verdict
+       << " (status " << result.status()
+       << ", " << result.elapsed_time_sec() * 1000 + result.elapsed_time_usec() / 1000 << " ms"
+       << ", " << result.memory_usage() << " KB)" << std::endl;
+}
+
+void RenderJudge(std::ostream& os, const char* verdict, const JudgeResult& result) {
+    os << verdict;
+    if (!result.message().empty()) {
+        os << ": " << result.message();
+    }
+    os << std::endl;
+    for (const LineJudgeData& line_data : result.line_data()) {
+        os << "@@ -" << line_data.correct_line_begin + 1 << "," << line_data.correct_line_count
+           << " +" << line_data.user_line_begin + 1 << "," << line_data.user_line_count << " @@" << std::endl;
+        for (const std::string& line : line_data.correct_lines) {
+            os << "-" << line << std::endl;
+        }
+        for (const std::string& line : line_data.user_lines) {
+            os << "+" << line << std::endl;
+        }
+        if (line_data.is_truncated) {
+            os << "..." << std::endl;
+        }
+    }
+}
+
+}
+
+void Renderer::Render(std::ostream& os, const CompilationSuccess& result) const {
+    os << "Compilation Success: " << result.source().string() << std::endl;
+    if (!result.message().empty()) {
+        os << result.message();
+    }
+}
+
+void Renderer::Render(std::ostream& os, const CompilationFailure& result) const {
+    os << "Compilation Failure: " << result.source().string() << std::endl;
+    if (!result.message().empty()) {
+        os << result.message();
+    }
+}
+
+void Renderer::Render(std::ostream& os, const ExecutionSuccess& result) const {
+    RenderExecution(os, "Execution Success", result);
+}
+
+void Renderer::Render(std::ostream& os, const ExecutionFailure& result) const {
+    RenderExecution(os, "Runtime Error", result);
+}
+
+void Renderer::Render(std::ostream& os, const ExecutionFileNotExist& result) const {
+    RenderExecution(os, "File Not Exist", result);
+}
+
+void Renderer::Render(std::ostream& os, const ExecutionFailureTimeout& result) const {
+    RenderExecution(os, "Time Limit Exceeded", result);
+}
+
+void Renderer::Render(std::ostream& os, const ExecutionFailureCpuTimeLimitExceeded& result) const {
+    RenderExecution(os, "CPU Time Limit Exceeded", result);
+}
+
+void Renderer::Render(std::ostream& os, const ExecutionFailureWallTimeLimitExceeded& result) const {
+    RenderExecution(os, "Wall Time Limit Exceeded", result);
+}
+
+void Renderer::Render(std::ostream& os, const ExecutionFailureMemoryLimitExceeded& result) const {
+    RenderExecution(os, "Memory Limit Exceeded", result);
+}
+
+void Renderer::Render(std::ostream& os, const ExecutionFailureException& result) const {
+    RenderExecution(os, "Uncaught Exception", result);
+}
+
+void Renderer::Render(std::ostream& os, const ExecutionFailureBadAlloc& result) const {
+    RenderExecution(os, "Uncaught std::bad_alloc", result);
+}
+
+void Renderer::Render(std::ostream& os, const ExecutionFailureOutofRange& result) const {
+    RenderExecution(os, "Uncaught std::out_of_range", result);
+}
+
+void Renderer::Render(std::ostream& os, const ExecutionFailureLengthError& result) const {
+    RenderExecution(os, "Uncaught std::length_error", result);
+}
+
+void Renderer::Render(std::ostream& os, const ExecutionFailureInvalidArgument& result) const {
+    RenderExecution(os, "Uncaught std::invalid_argument", result);
+}
+
+void Renderer::Render(std::ostream& os, const ExecutionFailureSignaled& result) const {
+    RenderExecution(os, "Killed by Signal", result);
+}
+
+void Renderer::Render(std::ostream& os, const ExecutionFailureSegmentationFault& result) const {
+    RenderExecution(os, "Segmentation Fault", result);
+}
+
+void Renderer::Render(std::ostream& os, const ExecutionFailureAbort& result) const {
+    RenderExecution(os, "Aborted", result);
+}
+
+void Renderer::Render(std::ostream& os, const ExecutionFailureInterrupt& result) const {
+    RenderExecution(os, "Interrupted", result);
+}
+
+void Renderer::Render(std::ostream& os, const ExecutionFailureTermination& result) const {
+    RenderExecution(os, "Terminated", result);
+}
+
+void Renderer::Render(std::ostream& os, const ExecutionFailureKill& result) const {
+    RenderExecution(os, "Killed", result);
+}
+
+void Renderer::Render(std::ostream& os, const JudgeSuccess& result) const {
+    RenderJudge(os, "Accepted", result);
+}
+
+void Renderer::Render(std::ostream& os, const JudgeFailureWrongAnswer& result) const {
+    RenderJudge(os, "Wrong Answer", result);
+}
+
+void Renderer::Render(std::ostream& os, const JudgeFailureInvalidOutputFormat& result) const {
+    RenderJudge(os, "Invalid Output Format", result);
+}
+
+void Renderer::Render(std::ostream& os, const JudgeFailureOutputExceeded& result) const {
+    RenderJudge(os, "Output Limit Exceeded", result);
+}
+
+void Renderer::Render(std::ostream& os, const SubmissionSuccess& result) const {
+    os << "Submission Accepted: " << result.program().string() << " (" << result.summary().max_time_usec / 1000 << " ms, " << result.summary().max_memory_kb << " KB)" << std::endl;
+}
+
+void Renderer::Render(std::ostream& os, const SubmissionFailure& result) const {
+    os << "Submission Rejected: " << result.program().string() << " (" << result.summary().max_time_usec / 1000 << " ms, " << result.summary().max_memory_kb << " KB)" << std::endl;
+}
+
+}
@@ -3,14 +3,35 @@
 
 #include <iostream>
 
-#include "result.h"
-#include "compilation_result.h"
-#include "execution_result.h"
-#include "judge_result.h"
-#include "submission_result.h"
-
 namespace oj {
 
+class CompilationSuccess;
+class CompilationFailure;
+class ExecutionSuccess;
+class ExecutionFailure;
+class ExecutionFileNotExist;
+class ExecutionFailureTimeout;
+class ExecutionFailureCpuTimeLimitExceeded;
+class ExecutionFailureWallTimeLimitExceeded;
+class ExecutionFailureMemoryLimitExceeded;
+class ExecutionFailureException;
+class ExecutionFailureBadAlloc;
+class ExecutionFailureOutofRange;
+class ExecutionFailureLengthError;
+class ExecutionFailureInvalidArgument;
+class ExecutionFailureSignaled;
+class ExecutionFailureSegmentationFault;
+class ExecutionFailureAbort;
+class ExecutionFailureInterrupt;
+class ExecutionFailureTermination;
+class ExecutionFailureKill;
+class JudgeSuccess;
+class JudgeFailureWrongAnswer;
+class JudgeFailureInvalidOutputFormat;
+class JudgeFailureOutputExceeded;
+class SubmissionSuccess;
+class SubmissionFailure;
+
 class Renderer {
 public:
     static Renderer& GetInstance() {
@@ -18,41 +39,43 @@ public:
         return instance;
     }
 
+    virtual ~Renderer() = default;
+    Renderer() = default;
     Renderer(const Renderer& other) = delete;
     Renderer(Renderer&& other) = delete;
 
     Renderer& operator=(const Renderer& other) = delete;
     Renderer& operator=(Renderer&& other) = delete;
 
-    virtual void Render(std::ostream& os, const CompilationSuccess& result);
-    virtual void Render(std::ostream& os, const CompilationFailure& result);
-    
-    virtual void Render(std::ostream& os, const ExecutionSuccess& result);
-    virtual void Render(std::ostream& os, const ExecutionFailureTimeout& result);
-    virtual void Render(std::ostream& os, const ExecutionFailureMemoryLimitExceeded& result);
-    virtual void Render(std::ostream& os, const ExecutionFailureException& result);
-    virtual void Render(std::ostream& os, const ExecutionFailureBadAlloc& result);
-    virtual void Render(std::ostream& os, const ExecutionFailureOutofRange& result);
-    virtual void Render(std::ostream& os, const ExecutionFailureLengthError& result);
-    virtual void Render(std::ostream& os, const ExecutionFailureInvalidArgument& result);
-    virtual void Render(std::ostream& os, const ExecutionFailureSignaled& result);
-    virtual void Render(std::ostream& os, const ExecutionFailureSegmentationFault& result);
-    virtual void Render(std::ostream& os, const ExecutionFailureAbort& result);
-    virtual void Render(std::ostream& os, const ExecutionFailureInterrupt& result);
-    virtual void Render(std::ostream& os, const ExecutionFailureTermination& result);
-    virtual void Render(std::ostream& os, const ExecutionFailureKill& result);
+    virtual void Render(std::ostream& os, const CompilationSuccess& result) const;
+    virtual void Render(std::ostream& os, const CompilationFailure& result) const;
 
-    virtual void Render(std::ostream& os, const JudgeSuccess& result);
-    virtual void Render(std::ostream& os, const JudgeFailureInvalidOutputFormat& result);
-    virtual void Render(std::ostream& os, const JudgeFailureOutputExceeded& result);
+    virtual void Render(std::ostream& os, const ExecutionSuccess& result) const;
+    virtual void Render(std::ostream& os, const ExecutionFailure& result) const;
+    virtual void Render(std::ostream& os, const ExecutionFileNotExist& result) const;
+    virtual void Render(std::ostream& os, const ExecutionFailureTimeout& result) const;
+    virtual void Render(std::ostream& os, const ExecutionFailureCpuTimeLimitExceeded& result) const;
+    virtual void Render(std::ostream& os, const ExecutionFailureWallTimeLimitExceeded& result) const;
+    virtual void Render(std::ostream& os, const ExecutionFailureMemoryLimitExceeded& result) const;
+    virtual void Render(std::ostream& os, const ExecutionFailureException& result) const;
+    virtual void Render(std::ostream& os, const ExecutionFailureBadAlloc& result) const;
+    virtual void Render(std::ostream& os, const ExecutionFailureOutofRange& result) const;
+    virtual void Render(std::ostream& os, const ExecutionFailureLengthError& result) const;
+    virtual void Render(std::ostream& os, const ExecutionFailureInvalidArgument& result) const;
+    virtual void Render(std::ostream& os, const ExecutionFailureSignaled& result) const;
+    virtual void Render(std::ostream& os, const ExecutionFailureSegmentationFault& result) const;
+    virtual void Render(std::ostream& os, const ExecutionFailureAbort& result) const;
+    virtual void Render(std::ostream& os, const ExecutionFailureInterrupt& result) const;
+    virtual void Render(std::ostream& os, const ExecutionFailureTermination& result) const;
+    virtual void Render(std::ostream& os, const ExecutionFailureKill& result) const;
 
-    virtual void Render(std::ostream& os, const SubmissionSuccess& result);
-    virtual void Render(std::ostream& os, const SubmissionFailure& result);
+    virtual void Render(std::ostream& os, const JudgeSuccess& result) const;
+    virtual void Render(std::ostream& os, const JudgeFailureWrongAnswer& result) const;
+    virtual void Render(std::ostream& os, const JudgeFailureInvalidOutputFormat& result) const;
+    virtual void Render(std::ostream& os, const JudgeFailureOutputExceeded& result) const;
 
-private:
-    ~Renderer() = default;
-
-    Renderer() = default;
+    virtual void Render(std::ostream& os, const SubmissionSuccess& result) const;
+    virtual void Render(std::ostream& os, const SubmissionFailure& result) const;
 };
 
 class KoreanRenderer : public Renderer {
@@ -61,4 +84,4 @@ class KoreanRenderer : public Renderer {
 
 }
 
-#endif
\ No newline at end of file
+#endif
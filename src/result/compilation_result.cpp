@@ -0,0 +1,144 @@
+#include <sstream>
+
+#include <sys/wait.h>
+
+#include "exit_status.h"
+
+#include "compilation_result.h"
+
+namespace oj {
+
+CompilationResult::CompilationResult (
+    const std::string&           message,
+    const std::string&           command,
+    const std::filesystem::path& source,
+    const std::filesystem::path& target
+) : message_(message),
+    command_(command),
+    source_(source),
+    target_(target) {}
+
+std::string CompilationResult::message() const {
+    return message_;
+}
+
+std::string CompilationResult::command() const {
+    return command_;
+}
+
+std::filesystem::path CompilationResult::source() const {
+    return source_;
+}
+
+std::filesystem::path CompilationResult::target() const {
+    return target_;
+}
+
+CompilationSuccess::CompilationSuccess (
+    const std::string&           message,
+    const std::string&           command,
+    const std::filesystem::path& source,
+    const std::filesystem::path& target
+) : CompilationResult(message, command, source, target) {}
+
+void CompilationSuccess::Render(std::ostream& os, const Renderer& renderer) const {
+    renderer.Render(os, *this);
+}
+
+std::string CompilationSuccess::Label(const Labeler& labeler) const {
+    std::ostringstream os;
+    labeler.Label(os, *this);
+    return os.str();
+}
+
+bool CompilationSuccess::is_success() const {
+    return true;
+}
+
+CompilationTargetUpToDate::CompilationTargetUpToDate (
+    const std::string&           message,
+    const std::string&           command,
+    const std::filesystem::path& source,
+    const std::filesystem::path& target
+) : CompilationSuccess(message, command, source, target) {}
+
+void CompilationTargetUpToDate::Render(std::ostream& os, const Renderer& renderer) const {
+    renderer.Render(os, *this);
+}
+
+std::string CompilationTargetUpToDate::Label(const Labeler& labeler) const {
+    std::ostringstream os;
+    labeler.Label(os, *this);
+    return os.str();
+}
+
+bool CompilationTargetUpToDate::is_success() const {
+    return true;
+}
+
+CompilationFailure::CompilationFailure (
+    const std::string&           message,
+    const std::string&           command,
+    const std::filesystem::path& source,
+    const std::filesystem::path& target
+) : CompilationResult(message, command, source, target) {}
+
+void CompilationFailure::Render(std::ostream& os, const Renderer& renderer) const {
+    renderer.Render(os, *this);
+}
+
+std::string CompilationFailure::Label(const Labeler& labeler) const {
+    std::ostringstream os;
+    labeler.Label(os, *this);
+    return os.str();
+}
+
+bool CompilationFailure::is_success() const {
+    return false;
+}
+
+CompilationSourceNotExist::CompilationSourceNotExist (
+    const std::string&           message,
+    const std::string&           command,
+    const std::filesystem::path& source,
+    const std::filesystem::path& target
+) : CompilationFailure(message, command, source, target) {}
+
+void CompilationSourceNotExist::Render(std::ostream& os, const Renderer& renderer) const {
+    renderer.Render(os, *this);
+}
+
+std::string CompilationSourceNotExist::Label(const Labeler& labeler) const {
+    std::ostringstream os;
+    labeler.Label(os, *this);
+    return os.str();
+}
+
+bool CompilationSourceNotExist::is_success() const {
+    return false;
+}
+
+std::shared_ptr<CompilationResult> CreateCompilationResult (
+    int                          status,
+    const std::string&           message,
+    const std::string&           command,
+    const std::filesystem::path& source,
+    const std::filesystem::path& target
+) {
+    if (!WIFEXITED(status)) {
+        return std::make_shared<CompilationFailure>(message, command, source, target);
+    }
+
+    switch (static_cast<ExitStatus>(WEXITSTATUS(status))) {
+    case ExitStatus::SUCCESS:
+        return std::make_shared<CompilationSuccess>(message, command, source, target);
+    case ExitStatus::COMPILATION_FILE_UP_TO_DATE:
+        return std::make_shared<CompilationTargetUpToDate>(message, command, source, target);
+    case ExitStatus::COMPILATION_FILE_NOT_EXIST:
+        return std::make_shared<CompilationSourceNotExist>(message, command, source, target);
+    default:
+        return std::make_shared<CompilationFailure>(message, command, source, target);
+    }
+}
+
+}
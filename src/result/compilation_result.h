@@ -43,10 +43,10 @@ public:
     virtual bool        is_success() const = 0;
 
 private:
-    const std::string&           message_;
-    const std::string&           command_;
-    const std::filesystem::path& source_;
-    const std::filesystem::path& target_;
+    std::string           message_;
+    std::string           command_;
+    std::filesystem::path source_;
+    std::filesystem::path target_;
 };
 
 class CompilationSuccess : public CompilationResult {
@@ -72,6 +72,7 @@ public:
 };
 
 class CompilationTargetUpToDate : public CompilationSuccess {
+public:
     virtual ~CompilationTargetUpToDate() = default;
 
     CompilationTargetUpToDate (
@@ -146,4 +147,4 @@ std::shared_ptr<CompilationResult> CreateCompilationResult (
 
 }
 
-#endif
\ No newline at end of file
+#endif
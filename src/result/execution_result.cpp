@@ -0,0 +1,577 @@
+#include <sstream>
+
+#include <signal.h>
+#include <sys/wait.h>
+
+#include "exit_status.h"
+
+#include "execution_result.h"
+
+namespace oj {
+
+ExecutionResult::ExecutionResult (
+    const std::filesystem::path& program,
+    const std::string&           input,
+    const std::string&           output,
+    const rusage&                usage
+) : program_(program),
+    input_(input),
+    output_(output),
+    resource_usage_(usage),
+    status_(0),
+    memory_profile_(),
+    sampling_profile_(),
+    wall_time_usec_(0),
+    startup_time_usec_(0),
+    output_hash_(0),
+    is_output_matched_(false) {}
+
+int ExecutionResult::status() const {
+    return status_;
+}
+
+int ExecutionResult::elapsed_time_sec() const {
+    long usec = resource_usage_.ru_utime.tv_usec + resource_usage_.ru_stime.tv_usec;
+    return static_cast<int>(resource_usage_.ru_utime.tv_sec + resource_usage_.ru_stime.tv_sec + usec / 1000000);
+}
+
+int ExecutionResult::elapsed_time_usec() const {
+    return static_cast<int>((resource_usage_.ru_utime.tv_usec + resource_usage_.ru_stime.tv_usec) % 1000000);
+}
+
+long long ExecutionResult::wall_time_usec() const {
+    return wall_time_usec_;
+}
+
+long ExecutionResult::startup_time_usec() const {
+    return startup_time_usec_;
+}
+
+uint64_t ExecutionResult::output_hash() const {
+    return output_hash_;
+}
+
+bool ExecutionResult::is_output_matched() const {
+    return is_output_matched_;
+}
+
+int ExecutionResult::memory_usage() const {
+    return static_cast<int>(resource_usage_.ru_maxrss);
+}
+
+std::string ExecutionResult::input() const {
+    return input_;
+}
+
+std::string ExecutionResult::output() const {
+    return output_;
+}
+
+rusage ExecutionResult::usage() const {
+    return resource_usage_;
+}
+
+MemoryProfile ExecutionResult::memory_profile() const {
+    return memory_profile_;
+}
+
+SamplingProfile ExecutionResult::sampling_profile() const {
+    return sampling_profile_;
+}
+
+void ExecutionResult::set_status(int status) {
+    status_ = status;
+}
+
+void ExecutionResult::set_memory_profile(const MemoryProfile& memory_profile) {
+    memory_profile_ = memory_profile;
+}
+
+void ExecutionResult::set_sampling_profile(const SamplingProfile& sampling_profile) {
+    sampling_profile_ = sampling_profile;
+}
+
+void ExecutionResult::set_wall_time_usec(long long wall_time_usec) {
+    wall_time_usec_ = wall_time_usec;
+}
+
+void ExecutionResult::set_startup_time_usec(long startup_time_usec) {
+    startup_time_usec_ = startup_time_usec;
+}
+
+void ExecutionResult::set_output_hash(uint64_t output_hash) {
+    output_hash_ = output_hash;
+}
+
+void ExecutionResult::set_output_matched(bool is_output_matched) {
+    is_output_matched_ = is_output_matched;
+}
+
+ExecutionSuccess::ExecutionSuccess (
+    const std::filesystem::path& program,
+    const std::string&           input,
+    const std::string&           output,
+    const rusage&                usage
+) : ExecutionResult(program, input, output, usage) {}
+
+void ExecutionSuccess::Render(std::ostream& os, const Renderer& renderer) const {
+    renderer.Render(os, *this);
+}
+
+std::string ExecutionSuccess::Label(const Labeler& labeler) const {
+    std::ostringstream os;
+    labeler.Label(os, *this);
+    return os.str();
+}
+
+bool ExecutionSuccess::is_success() const {
+    return true;
+}
+
+ExecutionFailure::ExecutionFailure (
+    const std::filesystem::path& program,
+    const std::string&           input,
+    const std::string&           output,
+    const rusage&                usage
+) : ExecutionResult(program, input, output, usage) {}
+
+void ExecutionFailure::Render(std::ostream& os, const Renderer& renderer) const {
+    renderer.Render(os, *this);
+}
+
+std::string ExecutionFailure::Label(const Labeler& labeler) const {
+    std::ostringstream os;
+    labeler.Label(os, *this);
+    return os.str();
+}
+
+bool ExecutionFailure::is_success() const {
+    return false;
+}
+
+ExecutionFileNotExist::ExecutionFileNotExist (
+    const std::filesystem::path& program,
+    const std::string&           input,
+    const std::string&           output,
+    const rusage&                usage
+) : ExecutionFailure(program, input, output, usage) {}
+
+void ExecutionFileNotExist::Render(std::ostream& os, const Renderer& renderer) const {
+    renderer.Render(os, *this);
+}
+
+std::string ExecutionFileNotExist::Label(const Labeler& labeler) const {
+    std::ostringstream os;
+    labeler.Label(os, *this);
+    return os.str();
+}
+
+bool ExecutionFileNotExist::is_success() const {
+    return false;
+}
+
+ExecutionFailureResourceUsage::ExecutionFailureResourceUsage (
+    const std::filesystem::path& program,
+    const std::string&           input,
+    const std::string&           output,
+    const rusage&                usage
+) : ExecutionFailure(program, input, output, usage) {}
+
+bool ExecutionFailureResourceUsage::is_success() const {
+    return false;
+}
+
+ExecutionFailureTimeout::ExecutionFailureTimeout (
+    const std::filesystem::path& program,
+    const std::string&           input,
+    const std::string&           output,
+    const rusage&                usage
+) : ExecutionFailureResourceUsage(program, input, output, usage) {}
+
+void ExecutionFailureTimeout::Render(std::ostream& os, const Renderer& renderer) const {
+    renderer.Render(os, *this);
+}
+
+std::string ExecutionFailureTimeout::Label(const Labeler& labeler) const {
+    std::ostringstream os;
+    labeler.Label(os, *this);
+    return os.str();
+}
+
+bool ExecutionFailureTimeout::is_success() const {
+    return false;
+}
+
+ExecutionFailureCpuTimeLimitExceeded::ExecutionFailureCpuTimeLimitExceeded (
+    const std::filesystem::path& program,
+    const std::string&           input,
+    const std::string&           output,
+    const rusage&                usage
+) : ExecutionFailureTimeout(program, input, output, usage) {}
+
+void ExecutionFailureCpuTimeLimitExceeded::Render(std::ostream& os, const Renderer& renderer) const {
+    renderer.Render(os, *this);
+}
+
+std::string ExecutionFailureCpuTimeLimitExceeded::Label(const Labeler& labeler) const {
+    std::ostringstream os;
+    labeler.Label(os, *this);
+    return os.str();
+}
+
+bool ExecutionFailureCpuTimeLimitExceeded::is_success() const {
+    return false;
+}
+
+ExecutionFailureWallTimeLimitExceeded::ExecutionFailureWallTimeLimitExceeded (
+    const std::filesystem::path& program,
+    const std::string&           input,
+    const std::string&           output,
+    const rusage&                usage
+) : ExecutionFailureTimeout(program, input, output, usage) {}
+
+void ExecutionFailureWallTimeLimitExceeded::Render(std::ostream& os, const Renderer& renderer) const {
+    renderer.Render(os, *this);
+}
+
+std::string ExecutionFailureWallTimeLimitExceeded::Label(const Labeler& labeler) const {
+    std::ostringstream os;
+    labeler.Label(os, *this);
+    return os.str();
+}
+
+bool ExecutionFailureWallTimeLimitExceeded::is_success() const {
+    return false;
+}
+
+ExecutionFailureMemoryLimitExceeded::ExecutionFailureMemoryLimitExceeded (
+    const std::filesystem::path& program,
+    const std::string&           input,
+    const std::string&           output,
+    const rusage&                usage
+) : ExecutionFailureResourceUsage(program, input, output, usage) {}
+
+void ExecutionFailureMemoryLimitExceeded::Render(std::ostream& os, const Renderer& renderer) const {
+    renderer.Render(os, *this);
+}
+
+std::string ExecutionFailureMemoryLimitExceeded::Label(const Labeler& labeler) const {
+    std::ostringstream os;
+    labeler.Label(os, *this);
+    return os.str();
+}
+
+bool ExecutionFailureMemoryLimitExceeded::is_success() const {
+    return false;
+}
+
+ExecutionFailureException::ExecutionFailureException (
+    const std::filesystem::path& program,
+    const std::string&           input,
+    const std::string&           output,
+    const rusage&                usage
+) : ExecutionFailure(program, input, output, usage) {}
+
+void ExecutionFailureException::Render(std::ostream& os, const Renderer& renderer) const {
+    renderer.Render(os, *this);
+}
+
+std::string ExecutionFailureException::Label(const Labeler& labeler) const {
+    std::ostringstream os;
+    labeler.Label(os, *this);
+    return os.str();
+}
+
+bool ExecutionFailureException::is_success() const {
+    return false;
+}
+
+ExecutionFailureBadAlloc::ExecutionFailureBadAlloc (
+    const std::filesystem::path& program,
+    const std::string&           input,
+    const std::string&           output,
+    const rusage&                usage
+) : ExecutionFailureException(program, input, output, usage) {}
+
+void ExecutionFailureBadAlloc::Render(std::ostream& os, const Renderer& renderer) const {
+    renderer.Render(os, *this);
+}
+
+std::string ExecutionFailureBadAlloc::Label(const Labeler& labeler) const {
+    std::ostringstream os;
+    labeler.Label(os, *this);
+    return os.str();
+}
+
+bool ExecutionFailureBadAlloc::is_success() const {
+    return false;
+}
+
+ExecutionFailureOutofRange::ExecutionFailureOutofRange (
+    const std::filesystem::path& program,
+    const std::string&           input,
+    const std::string&           output,
+    const rusage&                usage
+) : ExecutionFailureException(program, input, output, usage) {}
+
+void ExecutionFailureOutofRange::Render(std::ostream& os, const Renderer& renderer) const {
+    renderer.Render(os, *this);
+}
+
+std::string ExecutionFailureOutofRange::Label(const Labeler& labeler) const {
+    std::ostringstream os;
+    labeler.Label(os, *this);
+    return os.str();
+}
+
+bool ExecutionFailureOutofRange::is_success() const {
+    return false;
+}
+
+ExecutionFailureLengthError::ExecutionFailureLengthError (
+    const std::filesystem::path& program,
+    const std::string&           input,
+    const std::string&           output,
+    const rusage&                usage
+) : ExecutionFailureException(program, input, output, usage) {}
+
+void ExecutionFailureLengthError::Render(std::ostream& os, const Renderer& renderer) const {
+    renderer.Render(os, *this);
+}
+
+std::string ExecutionFailureLengthError::Label(const Labeler& labeler) const {
+    std::ostringstream os;
+    labeler.Label(os, *this);
+    return os.str();
+}
+
+bool ExecutionFailureLengthError::is_success() const {
+    return false;
+}
+
+ExecutionFailureInvalidArgument::ExecutionFailureInvalidArgument (
+    const std::filesystem::path& program,
+    const std::string&           input,
+    const std::string&           output,
+    const rusage&                usage
+) : ExecutionFailureException(program, input, output, usage) {}
+
+void ExecutionFailureInvalidArgument::Render(std::ostream& os, const Renderer& renderer) const {
+    renderer.Render(os, *this);
+}
+
+std::string ExecutionFailureInvalidArgument::Label(const Labeler& labeler) const {
+    std::ostringstream os;
+    labeler.Label(os, *this);
+    return os.str();
+}
+
+bool ExecutionFailureInvalidArgument::is_success() const {
+    return false;
+}
+
+ExecutionFailureSignaled::ExecutionFailureSignaled (
+    const std::filesystem::path& program,
+    const std::string&           input,
+    const std::string&           output,
+    const rusage&                usage
+) : ExecutionFailure(program, input, output, usage) {}
+
+void ExecutionFailureSignaled::Render(std::ostream& os, const Renderer& renderer) const {
+    renderer.Render(os, *this);
+}
+
+std::string ExecutionFailureSignaled::Label(const Labeler& labeler) const {
+    std::ostringstream os;
+    labeler.Label(os, *this);
+    return os.str();
+}
+
+bool ExecutionFailureSignaled::is_success() const {
+    return false;
+}
+
+ExecutionFailureSegmentationFault::ExecutionFailureSegmentationFault (
+    const std::filesystem::path& program,
+    const std::string&           input,
+    const std::string&           output,
+    const rusage&                usage
+) : ExecutionFailureSignaled(program, input, output, usage) {}
+
+void ExecutionFailureSegmentationFault::Render(std::ostream& os, const Renderer& renderer) const {
+    renderer.Render(os, *this);
+}
+
+std::string ExecutionFailureSegmentationFault::Label(const Labeler& labeler) const {
+    std::ostringstream os;
+    labeler.Label(os, *this);
+    return os.str();
+}
+
+bool ExecutionFailureSegmentationFault::is_success() const {
+    return false;
+}
+
+ExecutionFailureAbort::ExecutionFailureAbort (
+    const std::filesystem::path& program,
+    const std::string&           input,
+    const std::string&           output,
+    const rusage&                usage
+) : ExecutionFailureSignaled(program, input, output, usage) {}
+
+void ExecutionFailureAbort::Render(std::ostream& os, const Renderer& renderer) const {
+    renderer.Render(os, *this);
+}
+
+std::string ExecutionFailureAbort::Label(const Labeler& labeler) const {
+    std::ostringstream os;
+    labeler.Label(os, *this);
+    return os.str();
+}
+
+bool ExecutionFailureAbort::is_success() const {
+    return false;
+}
+
+ExecutionFailureInterrupt::ExecutionFailureInterrupt (
+    const std::filesystem::path& program,
+    const std::string&           input,
+    const std::string&           output,
+    const rusage&                usage
+) : ExecutionFailureSignaled(program, input, output, usage) {}
+
+void ExecutionFailureInterrupt::Render(std::ostream& os, const Renderer& renderer) const {
+    renderer.Render(os, *this);
+}
+
+std::string ExecutionFailureInterrupt::Label(const Labeler& labeler) const {
+    std::ostringstream os;
+    labeler.Label(os, *this);
+    return os.str();
+}
+
+bool ExecutionFailureInterrupt::is_success() const {
+    return false;
+}
+
+ExecutionFailureTermination::ExecutionFailureTermination (
+    const std::filesystem::path& program,
+    const std::string&           input,
+    const std::string&           output,
+    const rusage&                usage
+) : ExecutionFailureSignaled(program, input, output, usage) {}
+
+void ExecutionFailureTermination::Render(std::ostream& os, const Renderer& renderer) const {
+    renderer.Render(os, *this);
+}
+
+std::string ExecutionFailureTermination::Label(const Labeler& labeler) const {
+    std::ostringstream os;
+    labeler.Label(os, *this);
+    return os.str();
+}
+
+bool ExecutionFailureTermination::is_success() const {
+    return false;
+}
+
+ExecutionFailureKill::ExecutionFailureKill (
+    const std::filesystem::path& program,
+    const std::string&           input,
+    const std::string&           output,
+    const rusage&                usage
+) : ExecutionFailureSignaled(program, input, output, usage) {}
+
+void ExecutionFailureKill::Render(std::ostream& os, const Renderer& renderer) const {
+    renderer.Render(os, *this);
+}
+
+std::string ExecutionFailureKill::Label(const Labeler& labeler) const {
+    std::ostringstream os;
+    labeler.Label(os, *this);
+    return os.str();
+}
+
+bool ExecutionFailureKill::is_success() const {
+    return false;
+}
+
+std::shared_ptr<ExecutionResult> CreateExecutionResult (
+    int                          status,
+    const std::filesystem::path& program,
+    const std::string&           input,
+    const std::string&           output,
+    const rusage&                usage
+) {
+    std::shared_ptr<ExecutionResult> result;
+    if (WIFSIGNALED(status)) {
+        switch (WTERMSIG(status)) {
+        case SIGXCPU:
+            result = std::make_shared<ExecutionFailureCpuTimeLimitExceeded>(program, input, output, usage);
+            break;
+        case SIGSEGV:
+            result = std::make_shared<ExecutionFailureSegmentationFault>(program, input, output, usage);
+            break;
+        case SIGABRT:
+            result = std::make_shared<ExecutionFailureAbort>(program, input, output, usage);
+            break;
+        case SIGINT:
+            result = std::make_shared<ExecutionFailureInterrupt>(program, input, output, usage);
+            break;
+        case SIGTERM:
+            result = std::make_shared<ExecutionFailureTermination>(program, input, output, usage);
+            break;
+        case SIGKILL:
+            result = std::make_shared<ExecutionFailureKill>(program, input, output, usage);
+            break;
+        default:
+            result = std::make_shared<ExecutionFailureSignaled>(program, input, output, usage);
+            break;
+        }
+    } else {
+        switch (static_cast<ExitStatus>(WEXITSTATUS(status))) {
+        case ExitStatus::SUCCESS:
+            result = std::make_shared<ExecutionSuccess>(program, input, output, usage);
+            break;
+        case ExitStatus::OUT_OF_MEMORY:
+            result = std::make_shared<ExecutionFailureMemoryLimitExceeded>(program, input, output, usage);
+            break;
+        case ExitStatus::TIMEOUT:
+            result = std::make_shared<ExecutionFailureTimeout>(program, input, output, usage);
+            break;
+        case ExitStatus::CPU_TIMEOUT:
+            result = std::make_shared<ExecutionFailureCpuTimeLimitExceeded>(program, input, output, usage);
+            break;
+        case ExitStatus::WALL_TIMEOUT:
+            result = std::make_shared<ExecutionFailureWallTimeLimitExceeded>(program, input, output, usage);
+            break;
+        case ExitStatus::EXCEPTION:
+            result = std::make_shared<ExecutionFailureException>(program, input, output, usage);
+            break;
+        case ExitStatus::EXCEPTION_BAD_ALLOC:
+            result = std::make_shared<ExecutionFailureBadAlloc>(program, input, output, usage);
+            break;
+        case ExitStatus::EXCEPTION_OUT_OF_RANGE:
+            result = std::make_shared<ExecutionFailureOutofRange>(program, input, output, usage);
+            break;
+        case ExitStatus::EXCEPTION_LENGTH_ERROR:
+            result = std::make_shared<ExecutionFailureLengthError>(program, input, output, usage);
+            break;
+        case ExitStatus::EXCEPTION_INVALID_ARGUMENT:
+            result = std::make_shared<ExecutionFailureInvalidArgument>(program, input, output, usage);
+            break;
+        case ExitStatus::EXECUTION_PROGRAM_NOT_EXIST:
+        case ExitStatus::EXECUTION_INPUT_NOT_EXIST:
+            result = std::make_shared<ExecutionFileNotExist>(program, input, output, usage);
+            break;
+        default:
+            result = std::make_shared<ExecutionFailure>(program, input, output, usage);
+            break;
+        }
+    }
+
+    result->set_status(status);
+    return result;
+}
+
+}
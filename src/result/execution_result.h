@@ -1,7 +1,9 @@
 #ifndef EXECUTION_RESULT_H
 #define EXECUTION_RESULT_H
 
+#include <cstdint>
 #include <filesystem>
+#include <memory>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -15,6 +17,36 @@
 
 namespace oj {
 
+struct MemorySample {
+    uint32_t time_ms;
+    uint32_t rss_kb;
+    uint32_t vm_size_kb;
+};
+
+struct MemoryProfile {
+    std::vector<MemorySample> timeline;
+    int                       sample_interval_ms;
+    long                      peak_rss_kb;
+    long                      peak_vm_size_kb;
+    long                      minor_page_faults;
+    long                      major_page_faults;
+    long                      voluntary_context_switches;
+    long                      involuntary_context_switches;
+};
+
+struct HotFunction {
+    std::string name;
+    uint32_t    self_samples;
+    uint32_t    total_samples;
+};
+
+struct SamplingProfile {
+    std::vector<HotFunction> hot_functions;
+    int                      sample_frequency_hz;
+    uint32_t                 samples;
+    uint32_t                 lost_samples;
+};
+
 class ExecutionResult : public Result {
 public:
     virtual ~ExecutionResult() = default;
@@ -31,21 +63,43 @@ public:
     ExecutionResult& operator=(const ExecutionResult& other) = default;
     ExecutionResult& operator=(ExecutionResult&& other) noexcept = default;
 
-    virtual void        Render(std::ostream& os, const Renderer& renderer) const = 0;
-    virtual std::string Label(const Labeler& labeler) const override;
-
-    virtual bool        is_success() const = 0;
-            int         elapsed_time_sec() const;
-            int         elapsed_time_usec() const;
-            int         memory_usage() const;
-            std::string input() const;
-            std::string output() const;
+    virtual void            Render(std::ostream& os, const Renderer& renderer) const = 0;
+    virtual std::string     Label(const Labeler& labeler) const = 0;
+
+    virtual bool            is_success() const = 0;
+            int             status() const;
+            int             elapsed_time_sec() const;
+            int             elapsed_time_usec() const;
+            long long       wall_time_usec() const;
+            long            startup_time_usec() const;
+            uint64_t        output_hash() const;
+            bool            is_output_matched() const;
+            int             memory_usage() const;
+            std::string     input() const;
+            std::string     output() const;
+            rusage          usage() const;
+            MemoryProfile   memory_profile() const;
+            SamplingProfile sampling_profile() const;
+            void            set_status(int status);
+            void            set_memory_profile(const MemoryProfile& memory_profile);
+            void            set_sampling_profile(const SamplingProfile& sampling_profile);
+            void            set_wall_time_usec(long long wall_time_usec);
+            void            set_startup_time_usec(long startup_time_usec);
+            void            set_output_hash(uint64_t output_hash);
+            void            set_output_matched(bool is_output_matched);
 
 private:
     std::filesystem::path program_;
     std::string           input_;
     std::string           output_;
     rusage                resource_usage_;
+    int                   status_;
+    MemoryProfile         memory_profile_;
+    SamplingProfile       sampling_profile_;
+    long long             wall_time_usec_;
+    long                  startup_time_usec_;
+    uint64_t              output_hash_;
+    bool                  is_output_matched_;
 };
 
 class ExecutionSuccess : public ExecutionResult {
@@ -86,8 +140,8 @@ public:
     ExecutionFailure& operator=(const ExecutionFailure& other) = default;
     ExecutionFailure& operator=(ExecutionFailure&& other) noexcept = default;
 
-    virtual void        Render(std::ostream& os, const Renderer& renderer) const = 0;
-    virtual std::string Label(const Labeler& labeler) const = 0;
+    virtual void        Render(std::ostream& os, const Renderer& renderer) const override;
+    virtual std::string Label(const Labeler& labeler) const override;
 
     virtual bool        is_success() const override;
 };
@@ -108,8 +162,8 @@ public:
     ExecutionFileNotExist& operator=(const ExecutionFileNotExist& other) = default;
     ExecutionFileNotExist& operator=(ExecutionFileNotExist&& other) noexcept = default;
 
-    virtual void        Render(std::ostream& os, const Renderer& renderer) const = 0;
-    virtual std::string Label(const Labeler& labeler) const = 0;
+    virtual void        Render(std::ostream& os, const Renderer& renderer) const override;
+    virtual std::string Label(const Labeler& labeler) const override;
 
     virtual bool        is_success() const override;
 };
@@ -152,8 +206,52 @@ public:
     ExecutionFailureTimeout& operator=(const ExecutionFailureTimeout& other) = default;
     ExecutionFailureTimeout& operator=(ExecutionFailureTimeout&& other) noexcept = default;
 
-    virtual void        Render(std::ostream& os, const Renderer& renderer) const = 0;
-    virtual std::string Label(const Labeler& labeler) const = 0;
+    virtual void        Render(std::ostream& os, const Renderer& renderer) const override;
+    virtual std::string Label(const Labeler& labeler) const override;
+
+    virtual bool        is_success() const override;
+};
+
+class ExecutionFailureCpuTimeLimitExceeded : public ExecutionFailureTimeout {
+public:
+    virtual ~ExecutionFailureCpuTimeLimitExceeded() = default;
+
+    ExecutionFailureCpuTimeLimitExceeded (
+        const std::filesystem::path& program,
+        const std::string&           input,
+        const std::string&           output,
+        const rusage&                usage
+    );
+    ExecutionFailureCpuTimeLimitExceeded(const ExecutionFailureCpuTimeLimitExceeded& other) = default;
+    ExecutionFailureCpuTimeLimitExceeded(ExecutionFailureCpuTimeLimitExceeded&& other) noexcept = default;
+
+    ExecutionFailureCpuTimeLimitExceeded& operator=(const ExecutionFailureCpuTimeLimitExceeded& other) = default;
+    ExecutionFailureCpuTimeLimitExceeded& operator=(ExecutionFailureCpuTimeLimitExceeded&& other) noexcept = default;
+
+    virtual void        Render(std::ostream& os, const Renderer& renderer) const override;
+    virtual std::string Label(const Labeler& labeler) const override;
+
+    virtual bool        is_success() const override;
+};
+
+class ExecutionFailureWallTimeLimitExceeded : public ExecutionFailureTimeout {
+public:
+    virtual ~ExecutionFailureWallTimeLimitExceeded() = default;
+
+    ExecutionFailureWallTimeLimitExceeded (
+        const std::filesystem::path& program,
+        const std::string&           input,
+        const std::string&           output,
+        const rusage&                usage
+    );
+    ExecutionFailureWallTimeLimitExceeded(const ExecutionFailureWallTimeLimitExceeded& other) = default;
+    ExecutionFailureWallTimeLimitExceeded(ExecutionFailureWallTimeLimitExceeded&& other) noexcept = default;
+
+    ExecutionFailureWallTimeLimitExceeded& operator=(const ExecutionFailureWallTimeLimitExceeded& other) = default;
+    ExecutionFailureWallTimeLimitExceeded& operator=(ExecutionFailureWallTimeLimitExceeded&& other) noexcept = default;
+
+    virtual void        Render(std::ostream& os, const Renderer& renderer) const override;
+    virtual std::string Label(const Labeler& labeler) const override;
 
     virtual bool        is_success() const override;
 };
@@ -174,8 +272,8 @@ public:
     ExecutionFailureMemoryLimitExceeded& operator=(const ExecutionFailureMemoryLimitExceeded& other) = default;
     ExecutionFailureMemoryLimitExceeded& operator=(ExecutionFailureMemoryLimitExceeded&& other) noexcept = default;
 
-    virtual void        Render(std::ostream& os, const Renderer& renderer) const = 0;
-    virtual std::string Label(const Labeler& labeler) const = 0;
+    virtual void        Render(std::ostream& os, const Renderer& renderer) const override;
+    virtual std::string Label(const Labeler& labeler) const override;
 
     virtual bool        is_success() const override;
 };
@@ -196,8 +294,8 @@ public:
     ExecutionFailureException& operator=(const ExecutionFailureException& other) = default;
     ExecutionFailureException& operator=(ExecutionFailureException&& other) noexcept = default;
 
-    virtual void        Render(std::ostream& os, const Renderer& renderer) const = 0;
-    virtual std::string Label(const Labeler& labeler) const = 0;
+    virtual void        Render(std::ostream& os, const Renderer& renderer) const override;
+    virtual std::string Label(const Labeler& labeler) const override;
 
     virtual bool        is_success() const override;
 };
@@ -218,8 +316,8 @@ public:
     ExecutionFailureBadAlloc& operator=(const ExecutionFailureBadAlloc& other) = default;
     ExecutionFailureBadAlloc& operator=(ExecutionFailureBadAlloc&& other) noexcept = default;
 
-    virtual void        Render(std::ostream& os, const Renderer& renderer) const = 0;
-    virtual std::string Label(const Labeler& labeler) const = 0;
+    virtual void        Render(std::ostream& os, const Renderer& renderer) const override;
+    virtual std::string Label(const Labeler& labeler) const override;
 
     virtual bool        is_success() const override;
 };
@@ -240,8 +338,8 @@ public:
     ExecutionFailureOutofRange& operator=(const ExecutionFailureOutofRange& other) = default;
     ExecutionFailureOutofRange& operator=(ExecutionFailureOutofRange&& other) noexcept = default;
 
-    virtual void        Render(std::ostream& os, const Renderer& renderer) const = 0;
-    virtual std::string Label(const Labeler& labeler) const = 0;
+    virtual void        Render(std::ostream& os, const Renderer& renderer) const override;
+    virtual std::string Label(const Labeler& labeler) const override;
 
     virtual bool        is_success() const override;
 };
@@ -262,8 +360,8 @@ public:
     ExecutionFailureLengthError& operator=(const ExecutionFailureLengthError& other) = default;
     ExecutionFailureLengthError& operator=(ExecutionFailureLengthError&& other) noexcept = default;
 
-    virtual void        Render(std::ostream& os, const Renderer& renderer) const = 0;
-    virtual std::string Label(const Labeler& labeler) const = 0;
+    virtual void        Render(std::ostream& os, const Renderer& renderer) const override;
+    virtual std::string Label(const Labeler& labeler) const override;
 
     virtual bool        is_success() const override;
 };
@@ -284,8 +382,8 @@ public:
     ExecutionFailureInvalidArgument& operator=(const ExecutionFailureInvalidArgument& other) = default;
     ExecutionFailureInvalidArgument& operator=(ExecutionFailureInvalidArgument&& other) noexcept = default;
 
-    virtual void        Render(std::ostream& os, const Renderer& renderer) const = 0;
-    virtual std::string Label(const Labeler& labeler) const = 0;
+    virtual void        Render(std::ostream& os, const Renderer& renderer) const override;
+    virtual std::string Label(const Labeler& labeler) const override;
 
     virtual bool        is_success() const override;
 };
@@ -328,8 +426,8 @@ public:
     ExecutionFailureSegmentationFault& operator=(const ExecutionFailureSegmentationFault& other) = default;
     ExecutionFailureSegmentationFault& operator=(ExecutionFailureSegmentationFault&& other) noexcept = default;
 
-    virtual void        Render(std::ostream& os, const Renderer& renderer) const = 0;
-    virtual std::string Label(const Labeler& labeler) const = 0;
+    virtual void        Render(std::ostream& os, const Renderer& renderer) const override;
+    virtual std::string Label(const Labeler& labeler) const override;
 
     virtual bool        is_success() const override;
 };
@@ -350,8 +448,8 @@ public:
     ExecutionFailureAbort& operator=(const ExecutionFailureAbort& other) = default;
     ExecutionFailureAbort& operator=(ExecutionFailureAbort&& other) noexcept = default;
 
-    virtual void        Render(std::ostream& os, const Renderer& renderer) const = 0;
-    virtual std::string Label(const Labeler& labeler) const = 0;
+    virtual void        Render(std::ostream& os, const Renderer& renderer) const override;
+    virtual std::string Label(const Labeler& labeler) const override;
 
     virtual bool        is_success() const override;
 };
@@ -372,8 +470,8 @@ public:
     ExecutionFailureInterrupt& operator=(const ExecutionFailureInterrupt& other) = default;
     ExecutionFailureInterrupt& operator=(ExecutionFailureInterrupt&& other) noexcept = default;
 
-    virtual void        Render(std::ostream& os, const Renderer& renderer) const = 0;
-    virtual std::string Label(const Labeler& labeler) const = 0;
+    virtual void        Render(std::ostream& os, const Renderer& renderer) const override;
+    virtual std::string Label(const Labeler& labeler) const override;
 
     virtual bool        is_success() const override;
 };
@@ -394,8 +492,8 @@ public:
     ExecutionFailureTermination& operator=(const ExecutionFailureTermination& other) = default;
     ExecutionFailureTermination& operator=(ExecutionFailureTermination&& other) noexcept = default;
 
-    virtual void        Render(std::ostream& os, const Renderer& renderer) const = 0;
-    virtual std::string Label(const Labeler& labeler) const = 0;
+    virtual void        Render(std::ostream& os, const Renderer& renderer) const override;
+    virtual std::string Label(const Labeler& labeler) const override;
 
     virtual bool        is_success() const override;
 };
@@ -416,8 +514,8 @@ public:
     ExecutionFailureKill& operator=(const ExecutionFailureKill& other) = default;
     ExecutionFailureKill& operator=(ExecutionFailureKill&& other) noexcept = default;
 
-    virtual void        Render(std::ostream& os, const Renderer& renderer) const = 0;
-    virtual std::string Label(const Labeler& labeler) const = 0;
+    virtual void        Render(std::ostream& os, const Renderer& renderer) const override;
+    virtual std::string Label(const Labeler& labeler) const override;
 
     virtual bool        is_success() const override;
 };
@@ -432,4 +530,4 @@ std::shared_ptr<ExecutionResult> CreateExecutionResult (
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,158 @@
+#include <sstream>
+#include <stdexcept>
+
+#include <sys/wait.h>
+
+#include "exit_status.h"
+
+#include "judge_result.h"
+
+namespace oj {
+
+JudgeResult::JudgeResult (
+    const std::string&                 user_answer,
+    const std::string&                 correct_answer,
+    const std::vector<TokenJudgeData>& token_data,
+    const std::vector<LineJudgeData>&  line_data
+) : user_answer_(user_answer),
+    correct_answer_(correct_answer),
+    token_data_(token_data),
+    line_data_(line_data) {}
+
+std::string JudgeResult::user_answer() const {
+    return user_answer_;
+}
+
+std::string JudgeResult::correct_answer() const {
+    return correct_answer_;
+}
+
+std::string JudgeResult::message() const {
+    return message_;
+}
+
+const std::vector<LineJudgeData>& JudgeResult::line_data() const {
+    return line_data_;
+}
+
+void JudgeResult::set_message(const std::string& message) {
+    message_ = message;
+}
+
+JudgeSuccess::JudgeSuccess (
+    const std::string&                 user_answer,
+    const std::string&                 correct_answer,
+    const std::vector<TokenJudgeData>& token_data,
+    const std::vector<LineJudgeData>&  line_data
+) : JudgeResult(user_answer, correct_answer, token_data, line_data) {}
+
+void JudgeSuccess::Render(std::ostream& os, const Renderer& renderer) const {
+    renderer.Render(os, *this);
+}
+
+std::string JudgeSuccess::Label(const Labeler& labeler) const {
+    std::ostringstream os;
+    labeler.Label(os, *this);
+    return os.str();
+}
+
+bool JudgeSuccess::is_success() const {
+    return true;
+}
+
+JudgeFailure::JudgeFailure (
+    const std::string&                 user_answer,
+    const std::string&                 correct_answer,
+    const std::vector<TokenJudgeData>& token_data,
+    const std::vector<LineJudgeData>&  line_data
+) : JudgeResult(user_answer, correct_answer, token_data, line_data) {}
+
+bool JudgeFailure::is_success() const {
+    return false;
+}
+
+JudgeFailureWrongAnswer::JudgeFailureWrongAnswer (
+    const std::string&                 user_answer,
+    const std::string&                 correct_answer,
+    const std::vector<TokenJudgeData>& token_data,
+    const std::vector<LineJudgeData>&  line_data
+) : JudgeFailure(user_answer, correct_answer, token_data, line_data) {}
+
+void JudgeFailureWrongAnswer::Render(std::ostream& os, const Renderer& renderer) const {
+    renderer.Render(os, *this);
+}
+
+std::string JudgeFailureWrongAnswer::Label(const Labeler& labeler) const {
+    std::ostringstream os;
+    labeler.Label(os, *this);
+    return os.str();
+}
+
+bool JudgeFailureWrongAnswer::is_success() const {
+    return false;
+}
+
+JudgeFailureInvalidOutputFormat::JudgeFailureInvalidOutputFormat (
+    const std::string&                 user_answer,
+    const std::string&                 correct_answer,
+    const std::vector<TokenJudgeData>& token_data,
+    const std::vector<LineJudgeData>&  line_data
+) : JudgeFailure(user_answer, correct_answer, token_data, line_data) {}
+
+void JudgeFailureInvalidOutputFormat::Render(std::ostream& os, const Renderer& renderer) const {
+    renderer.Render(os, *this);
+}
+
+std::string JudgeFailureInvalidOutputFormat::Label(const Labeler& labeler) const {
+    std::ostringstream os;
+    labeler.Label(os, *this);
+    return os.str();
+}
+
+bool JudgeFailureInvalidOutputFormat::is_success() const {
+    return false;
+}
+
+JudgeFailureOutputExceeded::JudgeFailureOutputExceeded (
+    const std::string&                 user_answer,
+    const std::string&                 correct_answer,
+    const std::vector<TokenJudgeData>& token_data,
+    const std::vector<LineJudgeData>&  line_data
+) : JudgeFailure(user_answer, correct_answer, token_data, line_data) {}
+
+void JudgeFailureOutputExceeded::Render(std::ostream& os, const Renderer& renderer) const {
+    renderer.Render(os, *this);
+}
+
+std::string JudgeFailureOutputExceeded::Label(const Labeler& labeler) const {
+    std::ostringstream os;
+    labeler.Label(os, *this);
+    return os.str();
+}
+
+bool JudgeFailureOutputExceeded::is_success() const {
+    return false;
+}
+
+std::shared_ptr<JudgeResult> CreateJudgeResult (
+    int                                status,
+    const std::string&                 user_answer,
+    const std::string&                 correct_answer,
+    const std::vector<TokenJudgeData>& token_data,
+    const std::vector<LineJudgeData>&  line_data
+) {
+    switch (static_cast<ExitStatus>(WEXITSTATUS(status))) {
+    case ExitStatus::JUDGE_SUCCESS:
+        return std::make_shared<JudgeSuccess>(user_answer, correct_answer, token_data, line_data);
+    case ExitStatus::JUDGE_WRONG_ANSWER:
+        return std::make_shared<JudgeFailureWrongAnswer>(user_answer, correct_answer, token_data, line_data);
+    case ExitStatus::JUDGE_INVALID_OUTPUT_FORMAT:
+        return std::make_shared<JudgeFailureInvalidOutputFormat>(user_answer, correct_answer, token_data, line_data);
+    case ExitStatus::JUDGE_OUTPUT_EXCEEDED:
+        return std::make_shared<JudgeFailureOutputExceeded>(user_answer, correct_answer, token_data, line_data);
+    default:
+        throw std::invalid_argument("ERROR::JudgeResult: Unknown judge status " + std::to_string(status) + ".");
+    }
+}
+
+}
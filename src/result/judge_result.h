@@ -2,7 +2,9 @@
 #define JUDGE_RESULT_H
 
 #include <chrono>
+#include <cstddef>
 #include <filesystem>
+#include <memory>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -16,8 +18,21 @@
 
 namespace oj {
 
-struct TokenJudgeData;
-struct LineJudgeData;
+struct TokenJudgeData {
+    size_t      token_index;
+    std::string user_token;
+    std::string correct_token;
+};
+
+struct LineJudgeData {
+    size_t                   user_line_begin;
+    size_t                   user_line_count;
+    size_t                   correct_line_begin;
+    size_t                   correct_line_count;
+    std::vector<std::string> user_lines;
+    std::vector<std::string> correct_lines;
+    bool                     is_truncated;
+};
 
 class JudgeResult : public Result {
 public:
@@ -36,15 +51,20 @@ public:
     JudgeResult& operator=(JudgeResult&& other) noexcept = default;
 
     virtual void        Render(std::ostream& os, const Renderer& renderer) const = 0;
-    virtual std::string Label(const Labeler& labeler) const override;
+    virtual std::string Label(const Labeler& labeler) const = 0;
 
     virtual bool        is_success() const = 0;
             std::string user_answer() const;
             std::string correct_answer() const;
+            std::string message() const;
+            const std::vector<LineJudgeData>& line_data() const;
+
+            void        set_message(const std::string& message);
 
 private:
     std::string                 user_answer_;
     std::string                 correct_answer_;
+    std::string                 message_;
     std::vector<TokenJudgeData> token_data_;
     std::vector<LineJudgeData>  line_data_;
 };
@@ -65,10 +85,10 @@ public:
     JudgeSuccess& operator=(const JudgeSuccess& other) = default;
     JudgeSuccess& operator=(JudgeSuccess&& other) noexcept = default;
 
-    virtual void        Render(std::ostream& os, const Renderer& renderer) const = 0;
+    virtual void        Render(std::ostream& os, const Renderer& renderer) const override;
     virtual std::string Label(const Labeler& labeler) const override;
 
-    virtual bool        is_success() const = 0;
+    virtual bool        is_success() const override;
 };
 
 class JudgeFailure : public JudgeResult {
@@ -88,9 +108,31 @@ public:
     JudgeFailure& operator=(JudgeFailure&& other) noexcept = default;
 
     virtual void        Render(std::ostream& os, const Renderer& renderer) const = 0;
+    virtual std::string Label(const Labeler& labeler) const = 0;
+
+    virtual bool        is_success() const override;
+};
+
+class JudgeFailureWrongAnswer : public JudgeFailure {
+public:
+    virtual ~JudgeFailureWrongAnswer() = default;
+
+    JudgeFailureWrongAnswer (
+        const std::string&                 user_answer,
+        const std::string&                 correct_answer,
+        const std::vector<TokenJudgeData>& token_data,
+        const std::vector<LineJudgeData>&  line_data
+    );
+    JudgeFailureWrongAnswer(const JudgeFailureWrongAnswer& other) = default;
+    JudgeFailureWrongAnswer(JudgeFailureWrongAnswer&& other) noexcept = default;
+
+    JudgeFailureWrongAnswer& operator=(const JudgeFailureWrongAnswer& other) = default;
+    JudgeFailureWrongAnswer& operator=(JudgeFailureWrongAnswer&& other) noexcept = default;
+
+    virtual void        Render(std::ostream& os, const Renderer& renderer) const override;
     virtual std::string Label(const Labeler& labeler) const override;
 
-    virtual bool        is_success() const = 0;
+    virtual bool        is_success() const override;
 };
 
 class JudgeFailureInvalidOutputFormat : public JudgeFailure {
@@ -109,10 +151,10 @@ public:
     JudgeFailureInvalidOutputFormat& operator=(const JudgeFailureInvalidOutputFormat& other) = default;
     JudgeFailureInvalidOutputFormat& operator=(JudgeFailureInvalidOutputFormat&& other) noexcept = default;
 
-    virtual void        Render(std::ostream& os, const Renderer& renderer) const = 0;
+    virtual void        Render(std::ostream& os, const Renderer& renderer) const override;
     virtual std::string Label(const Labeler& labeler) const override;
 
-    virtual bool        is_success() const = 0;
+    virtual bool        is_success() const override;
 };
 
 class JudgeFailureOutputExceeded : public JudgeFailure {
@@ -131,8 +173,8 @@ public:
     JudgeFailureOutputExceeded& operator=(const JudgeFailureOutputExceeded& other) = default;
     JudgeFailureOutputExceeded& operator=(JudgeFailureOutputExceeded&& other) noexcept = default;
 
-    virtual void        Render(std::ostream& os, const Renderer& renderer) const = 0;
-    virtual std::string Label(const Labeler& labeler) const = 0;
+    virtual void        Render(std::ostream& os, const Renderer& renderer) const override;
+    virtual std::string Label(const Labeler& labeler) const override;
 
     virtual bool        is_success() const override;
 };
@@ -147,4 +189,4 @@ std::shared_ptr<JudgeResult> CreateJudgeResult (
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -2,6 +2,7 @@
 #define RESULT_H
 
 #include <ostream>
+#include <string>
 
 #include "renderer.h"
 #include "labeler.h"
@@ -12,7 +13,7 @@ class Result {
 public:
     virtual ~Result() = default;
 
-    Result();
+    Result() = default;
     Result(const Result& other) = default;
     Result(Result&& other) noexcept = default;
 
@@ -27,4 +28,4 @@ public:
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <sstream>
+
+#include "submission_result.h"
+
+namespace oj {
+
+void SubmissionSummary::Add(const ExecutionResult* execution_result, const JudgeResult* judge_result) {
+    ++tests;
+    is_success = is_success && execution_result != nullptr && execution_result->is_success() && judge_result != nullptr && judge_result->is_success();
+    if (execution_result != nullptr) {
+        max_time_usec = std::max(max_time_usec, execution_result->elapsed_time_sec() * 1000000LL + execution_result->elapsed_time_usec());
+        max_wall_time_usec = std::max(max_wall_time_usec, execution_result->wall_time_usec());
+        max_memory_kb = std::max(max_memory_kb, static_cast<long>(execution_result->memory_usage()));
+    }
+}
+
+SubmissionResult::SubmissionResult (
+    const std::shared_ptr<CompilationResult>&            compilation_result,
+    const std::vector<std::shared_ptr<ExecutionResult>>& execution_results,
+    const std::vector<std::shared_ptr<JudgeResult>>&     judge_results,
+    const SubmissionSummary&                             summary
+) : compilation_result_(compilation_result),
+    execution_results_(execution_results),
+    judge_results_(judge_results),
+    summary_(summary) {}
+
+std::filesystem::path SubmissionResult::source() const {
+    return compilation_result_ != nullptr ? compilation_result_->source() : std::filesystem::path();
+}
+
+std::filesystem::path SubmissionResult::program() const {
+    return compilation_result_ != nullptr ? compilation_result_->target() : std::filesystem::path();
+}
+
+const SubmissionSummary& SubmissionResult::summary() const {
+    return summary_;
+}
+
+SubmissionSuccess::SubmissionSuccess (
+    const std::shared_ptr<CompilationResult>&            compilation_result,
+    const std::vector<std::shared_ptr<ExecutionResult>>& execution_results,
+    const std::vector<std::shared_ptr<JudgeResult>>&     judge_results,
+    const SubmissionSummary&                             summary
+) : SubmissionResult(compilation_result, execution_results, judge_results, summary) {}
+
+void SubmissionSuccess::Render(std::ostream& os, const Renderer& renderer) const {
+    renderer.Render(os, *this);
+}
+
+std::string SubmissionSuccess::Label(const Labeler& labeler) const {
+    std::ostringstream os;
+    labeler.Label(os, *this);
+    return os.str();
+}
+
+bool SubmissionSuccess::is_success() const {
+    return true;
+}
+
+SubmissionFailure::SubmissionFailure (
+    const std::shared_ptr<CompilationResult>&            compilation_result,
+    const std::vector<std::shared_ptr<ExecutionResult>>& execution_results,
+    const std::vector<std::shared_ptr<JudgeResult>>&     judge_results,
+    const SubmissionSummary&                             summary
+) : SubmissionResult(compilation_result, execution_results, judge_results, summary) {}
+
+void SubmissionFailure::Render(std::ostream& os, const Renderer& renderer) const {
+    renderer.Render(os, *this);
+}
+
+std::string SubmissionFailure::Label(const Labeler& labeler) const {
+    std::ostringstream os;
+    labeler.Label(os, *this);
+    return os.str();
+}
+
+bool SubmissionFailure::is_success() const {
+    return false;
+}
+
+std::shared_ptr<SubmissionResult> CreateSubmissionResult (
+    const std::shared_ptr<CompilationResult>&            compilation_result,
+    const std::vector<std::shared_ptr<ExecutionResult>>& execution_results,
+    const std::vector<std::shared_ptr<JudgeResult>>&     judge_results
+) {
+    SubmissionSummary summary;
+    for (size_t i = 0; i < execution_results.size(); ++i) {
+        summary.Add(execution_results[i].get(), i < judge_results.size() ? judge_results[i].get() : nullptr);
+    }
+    return CreateSubmissionResult(compilation_result, execution_results, judge_results, summary);
+}
+
+std::shared_ptr<SubmissionResult> CreateSubmissionResult (
+    const std::shared_ptr<CompilationResult>&            compilation_result,
+    const std::vector<std::shared_ptr<ExecutionResult>>& execution_results,
+    const std::vector<std::shared_ptr<JudgeResult>>&     judge_results,
+    const SubmissionSummary&                             summary
+) {
+    bool is_success = compilation_result != nullptr && compilation_result->is_success() &&
+                      execution_results.size() == judge_results.size() && summary.tests == execution_results.size() && summary.is_success;
+    if (is_success) {
+        return std::make_shared<SubmissionSuccess>(compilation_result, execution_results, judge_results, summary);
+    }
+    return std::make_shared<SubmissionFailure>(compilation_result, execution_results, judge_results, summary);
+}
+
+}
@@ -2,6 +2,7 @@
 #define SUBMISSION_RESULT_H
 
 #include <filesystem>
+#include <memory>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -16,6 +17,16 @@
 
 namespace oj {
 
+struct SubmissionSummary {
+    void Add(const ExecutionResult* execution_result, const JudgeResult* judge_result);
+
+    bool      is_success = true;
+    size_t    tests = 0;
+    long long max_time_usec = 0;
+    long long max_wall_time_usec = 0;
+    long      max_memory_kb = 0;
+};
+
 class SubmissionResult : public Result {
 public:
     virtual ~SubmissionResult() = default;
@@ -23,7 +34,8 @@ public:
     SubmissionResult (
         const std::shared_ptr<CompilationResult>&            compilation_result,
         const std::vector<std::shared_ptr<ExecutionResult>>& execution_results,
-        const std::vector<std::shared_ptr<JudgeResult>>&     judge_results 
+        const std::vector<std::shared_ptr<JudgeResult>>&     judge_results,
+        const SubmissionSummary&                             summary
     );
     SubmissionResult(const SubmissionResult& other) = default;
     SubmissionResult(SubmissionResult&& other) noexcept = default;
@@ -31,26 +43,30 @@ public:
     SubmissionResult& operator=(const SubmissionResult& other) = default;
     SubmissionResult& operator=(SubmissionResult&& other) noexcept = default;
 
-    virtual void          Render(std::ostream& os, const Renderer& renderer) const = 0;
-    virtual std::string   Label(const Labeler& labeler) const = 0;
+    virtual void             Render(std::ostream& os, const Renderer& renderer) const = 0;
+    virtual std::string      Label(const Labeler& labeler) const = 0;
 
-    virtual bool          is_success() const = 0;
-    std::filesystem::path source() const;
-    std::filesystem::path program() const;
+    virtual bool             is_success() const = 0;
+    std::filesystem::path    source() const;
+    std::filesystem::path    program() const;
+    const SubmissionSummary& summary() const;
 
 private:
     std::shared_ptr<CompilationResult>            compilation_result_;
     std::vector<std::shared_ptr<ExecutionResult>> execution_results_;
     std::vector<std::shared_ptr<JudgeResult>>     judge_results_;
+    SubmissionSummary                             summary_;
 };
 
 class SubmissionSuccess : public SubmissionResult {
+public:
     virtual ~SubmissionSuccess() = default;
 
     SubmissionSuccess (
-        const std::shared_ptr<CompilationSuccess>&            compilation_result,
-        const std::vector<std::shared_ptr<ExecutionSuccess>>& execution_results,
-        const std::vector<std::shared_ptr<JudgeSuccess>>&     judge_results 
+        const std::shared_ptr<CompilationResult>&            compilation_result,
+        const std::vector<std::shared_ptr<ExecutionResult>>& execution_results,
+        const std::vector<std::shared_ptr<JudgeResult>>&     judge_results,
+        const SubmissionSummary&                             summary
     );
     SubmissionSuccess(const SubmissionSuccess& other) = default;
     SubmissionSuccess(SubmissionSuccess&& other) noexcept = default;
@@ -58,19 +74,21 @@ class SubmissionSuccess : public SubmissionResult {
     SubmissionSuccess& operator=(const SubmissionSuccess& other) = default;
     SubmissionSuccess& operator=(SubmissionSuccess&& other) noexcept = default;
 
-    virtual void        Render(std::ostream& os, const Renderer& renderer) const = 0;
-    virtual std::string Label(const Labeler& labeler) const = 0;
+    virtual void        Render(std::ostream& os, const Renderer& renderer) const override;
+    virtual std::string Label(const Labeler& labeler) const override;
 
     virtual bool        is_success() const override;
 };
 
 class SubmissionFailure : public SubmissionResult {
+public:
     virtual ~SubmissionFailure() = default;
 
     SubmissionFailure (
         const std::shared_ptr<CompilationResult>&            compilation_result,
         const std::vector<std::shared_ptr<ExecutionResult>>& execution_results,
-        const std::vector<std::shared_ptr<JudgeResult>>&     judge_results 
+        const std::vector<std::shared_ptr<JudgeResult>>&     judge_results,
+        const SubmissionSummary&                             summary
     );
     SubmissionFailure(const SubmissionFailure& other) = default;
     SubmissionFailure(SubmissionFailure&& other) noexcept = default;
@@ -78,8 +96,8 @@ class SubmissionFailure : public SubmissionResult {
     SubmissionFailure& operator=(const SubmissionFailure& other) = default;
     SubmissionFailure& operator=(SubmissionFailure&& other) noexcept = default;
 
-    virtual void        Render(std::ostream& os, const Renderer& renderer) const = 0;
-    virtual std::string Label(const Labeler& labeler) const = 0;
+    virtual void        Render(std::ostream& os, const Renderer& renderer) const override;
+    virtual std::string Label(const Labeler& labeler) const override;
 
     virtual bool        is_success() const override;
 };
@@ -89,7 +107,13 @@ std::shared_ptr<SubmissionResult> CreateSubmissionResult (
     const std::vector<std::shared_ptr<ExecutionResult>>& execution_results,
     const std::vector<std::shared_ptr<JudgeResult>>&     judge_results 
 );
+std::shared_ptr<SubmissionResult> CreateSubmissionResult (
+    const std::shared_ptr<CompilationResult>&            compilation_result,
+    const std::vector<std::shared_ptr<ExecutionResult>>& execution_results,
+    const std::vector<std::shared_ptr<JudgeResult>>&     judge_results,
+    const SubmissionSummary&                             summary
+);
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,138 @@
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include <unistd.h>
+
+#include "runtime_history.h"
+
+namespace oj {
+
+RuntimeHistory::RuntimeHistory(double smoothing, double default_ms) : smoothing_(smoothing), default_ms_(default_ms) {
+    if (smoothing_ <= 0.0 || smoothing_ > 1.0) {
+        throw std::invalid_argument("ERROR::RuntimeHistory: Smoothing must be in (0, 1].");
+    }
+}
+
+void RuntimeHistory::Record(const std::string& problem, const std::string& test, double cpu_ms, double wall_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Update(tests_[GetKey(problem, test)], cpu_ms, wall_ms);
+    Update(problems_[problem], cpu_ms, wall_ms);
+}
+
+void RuntimeHistory::RecordVerdict(const std::string& problem, const std::string& test, bool is_failure) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = tests_[GetKey(problem, test)];
+    ++entry.verdicts;
+    if (is_failure) {
+        ++entry.failures;
+    }
+}
+
+double RuntimeHistory::Estimate(const std::string& problem, const std::string& test) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto entry = tests_.find(GetKey(problem, test));
+    if (entry != tests_.end() && entry->second.samples != 0) {
+        return entry->second.wall_ms;
+    }
+    entry = problems_.find(problem);
+    if (entry != problems_.end()) {
+        return entry->second.wall_ms;
+    }
+    return default_ms_;
+}
+
+double RuntimeHistory::FailureRate(const std::string& problem, const std::string& test) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto entry = tests_.find(GetKey(problem, test));
+    if (entry == tests_.end()) {
+        return 0.5;
+    }
+    return (entry->second.failures + 1.0) / (entry->second.verdicts + 2.0);
+}
+
+void RuntimeHistory::Load(const std::filesystem::path& file) {
+    std::ifstream in(file);
+    if (!in.is_open()) {
+        throw std::runtime_error("ERROR::RuntimeHistory: Failed to open a file " + file.string() + ".");
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string kind;
+        std::string problem;
+        std::string test;
+        Entry entry;
+        if (!std::getline(fields, kind, '\t') || !std::getline(fields, problem, '\t')) {
+            continue;
+        }
+        if (kind == "test" && !std::getline(fields, test, '\t')) {
+            continue;
+        }
+        if (!(fields >> entry.cpu_ms >> entry.wall_ms >> entry.samples)) {
+            continue;
+        }
+        if (!(fields >> entry.verdicts >> entry.failures)) {
+            entry.verdicts = 0;
+            entry.failures = 0;
+        }
+        if (kind == "test") {
+            tests_[GetKey(problem, test)] = entry;
+        } else if (kind == "problem") {
+            problems_[problem] = entry;
+        }
+    }
+}
+
+void RuntimeHistory::Save(const std::filesystem::path& file) const {
+    std::filesystem::path staging = file.string() + "." + std::to_string(getpid());
+    {
+        std::ofstream out(staging, std::ios::trunc);
+        if (!out.is_open()) {
+            throw std::runtime_error("ERROR::RuntimeHistory: Failed to open a file " + staging.string() + ".");
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& [problem, entry] : problems_) {
+            out << "problem\t" << problem << '\t' << entry.cpu_ms << '\t' << entry.wall_ms << '\t' << entry.samples << '\t'
+                << entry.verdicts << '\t' << entry.failures << '\n';
+        }
+        for (const auto& [key, entry] : tests_) {
+            size_t separator = key.find('\0');
+            out << "test\t" << key.substr(0, separator) << '\t' << key.substr(separator + 1) << '\t'
+                << entry.cpu_ms << '\t' << entry.wall_ms << '\t' << entry.samples << '\t'
+                << entry.verdicts << '\t' << entry.failures << '\n';
+        }
+        if (!out.flush()) {
+            throw std::runtime_error("ERROR::RuntimeHistory: Failed to write a file " + staging.string() + ".");
+        }
+    }
+    std::filesystem::rename(staging, file);
+}
+
+size_t RuntimeHistory::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tests_.size();
+}
+
+std::string RuntimeHistory::GetKey(const std::string& problem, const std::string& test) {
+    std::string key = problem;
+    key += '\0';
+    key += test;
+    return key;
+}
+
+void RuntimeHistory::Update(Entry& entry, double cpu_ms, double wall_ms) const {
+    if (entry.samples == 0) {
+        entry.cpu_ms = cpu_ms;
+        entry.wall_ms = wall_ms;
+    } else {
+        entry.cpu_ms += smoothing_ * (cpu_ms - entry.cpu_ms);
+        entry.wall_ms += smoothing_ * (wall_ms - entry.wall_ms);
+    }
+    ++entry.samples;
+}
+
+}
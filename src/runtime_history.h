@@ -0,0 +1,52 @@
+#ifndef RUNTIME_HISTORY_H
+#define RUNTIME_HISTORY_H
+
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace oj {
+
+class RuntimeHistory {
+public:
+    ~RuntimeHistory() = default;
+    explicit RuntimeHistory(double smoothing = 0.3, double default_ms = 100.0);
+    RuntimeHistory(const RuntimeHistory& other) = delete;
+    RuntimeHistory(RuntimeHistory&& other) = delete;
+
+    RuntimeHistory& operator=(const RuntimeHistory& other) = delete;
+    RuntimeHistory& operator=(RuntimeHistory&& other) = delete;
+
+    void   Record(const std::string& problem, const std::string& test, double cpu_ms, double wall_ms);
+    void   RecordVerdict(const std::string& problem, const std::string& test, bool is_failure);
+    double Estimate(const std::string& problem, const std::string& test) const;
+    double FailureRate(const std::string& problem, const std::string& test) const;
+    void   Load(const std::filesystem::path& file);
+    void   Save(const std::filesystem::path& file) const;
+
+    size_t size() const;
+
+private:
+    struct Entry {
+        double cpu_ms;
+        double wall_ms;
+        size_t samples;
+        size_t verdicts;
+        size_t failures;
+    };
+
+    static std::string GetKey(const std::string& problem, const std::string& test);
+
+    void Update(Entry& entry, double cpu_ms, double wall_ms) const;
+
+    double                                 smoothing_;
+    double                                 default_ms_;
+    mutable std::mutex                     mutex_;
+    std::unordered_map<std::string, Entry> tests_;
+    std::unordered_map<std::string, Entry> problems_;
+};
+
+}
+
+#endif
@@ -0,0 +1,349 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <cxxabi.h>
+#include <elf.h>
+#include <unistd.h>
+#include <linux/perf_event.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include "mapped_file.h"
+#include "sampling_profiler.h"
+
+namespace oj {
+
+namespace {
+
+constexpr uint32_t NO_MAPPING = UINT32_MAX;
+
+template <typename T>
+bool ReadAt(std::string_view data, uint64_t offset, T& value) {
+    if (offset > data.size() || data.size() - offset < sizeof(T)) {
+        return false;
+    }
+    memcpy(&value, data.data() + offset, sizeof(T));
+    return true;
+}
+
+void CopyFromRing(const char* ring, size_t ring_size, uint64_t position, char* out, size_t size) {
+    size_t begin = position % ring_size;
+    size_t first = std::min(size, ring_size - begin);
+    memcpy(out, ring + begin, first);
+    memcpy(out + first, ring, size - first);
+}
+
+std::string Demangle(const char* name) {
+    int status;
+    std::unique_ptr<char, decltype(&free)> demangled(abi::__cxa_demangle(name, nullptr, nullptr, &status), free);
+    return status == 0 && demangled != nullptr ? std::string(demangled.get()) : std::string(name);
+}
+
+class SymbolTable {
+public:
+    explicit SymbolTable(const std::string& file) {
+        try {
+            MappedFile mapped_file(file);
+            Load(mapped_file.view());
+        } catch (const std::exception&) {
+            segments_.clear();
+            symbols_.clear();
+        }
+    }
+
+    std::string Find(uint64_t offset) const {
+        auto segment = std::find_if(segments_.begin(), segments_.end(), [&](const Segment& segment) {
+            return offset >= segment.offset && offset - segment.offset < segment.size;
+        });
+        if (segment == segments_.end()) {
+            return std::string();
+        }
+
+        uint64_t address = offset - segment->offset + segment->address;
+        auto symbol = std::upper_bound(symbols_.begin(), symbols_.end(), address, [](uint64_t address, const Symbol& symbol) {
+            return address < symbol.address;
+        });
+        if (symbol == symbols_.begin()) {
+            return std::string();
+        }
+        --symbol;
+        if (symbol->size != 0 && address - symbol->address >= symbol->size) {
+            return std::string();
+        }
+        return symbol->name;
+    }
+
+private:
+    struct Segment {
+        uint64_t offset;
+        uint64_t size;
+        uint64_t address;
+    };
+
+    struct Symbol {
+        uint64_t    address;
+        uint64_t    size;
+        std::string name;
+    };
+
+    void Load(std::string_view data) {
+        Elf64_Ehdr header;
+        if (!ReadAt(data, 0, header) || memcmp(header.e_ident, ELFMAG, SELFMAG) != 0 || header.e_ident[EI_CLASS] != ELFCLASS64) {
+            return;
+        }
+
+        for (uint64_t i = 0; i < header.e_phnum; ++i) {
+            Elf64_Phdr program_header;
+            if (ReadAt(data, header.e_phoff + i * header.e_phentsize, program_header) && program_header.p_type == PT_LOAD) {
+                segments_.push_back({program_header.p_offset, program_header.p_filesz, program_header.p_vaddr});
+            }
+        }
+
+        std::vector<Elf64_Shdr> sections(header.e_shnum);
+        for (uint64_t i = 0; i < header.e_shnum; ++i) {
+            if (!ReadAt(data, header.e_shoff + i * header.e_shentsize, sections[i])) {
+                return;
+            }
+        }
+        auto table = std::find_if(sections.begin(), sections.end(), [](const Elf64_Shdr& section) { return section.sh_type == SHT_SYMTAB; });
+        if (table == sections.end()) {
+            table = std::find_if(sections.begin(), sections.end(), [](const Elf64_Shdr& section) { return section.sh_type == SHT_DYNSYM; });
+        }
+        if (table == sections.end() || table->sh_link >= sections.size()) {
+            return;
+        }
+
+        const Elf64_Shdr& strings = sections[table->sh_link];
+        if (strings.sh_offset > data.size() || data.size() - strings.sh_offset < strings.sh_size) {
+            return;
+        }
+        std::string_view names = data.substr(strings.sh_offset, strings.sh_size);
+        for (uint64_t offset = 0; offset + sizeof(Elf64_Sym) <= table->sh_size; offset += sizeof(Elf64_Sym)) {
+            Elf64_Sym symbol;
+            if (!ReadAt(data, table->sh_offset + offset, symbol)) {
+                break;
+            }
+            unsigned char type = ELF64_ST_TYPE(symbol.st_info);
+            if ((type != STT_FUNC && type != STT_GNU_IFUNC) || symbol.st_shndx == SHN_UNDEF || symbol.st_value == 0 || symbol.st_name >= names.size()) {
+                continue;
+            }
+            std::string name(names.substr(symbol.st_name, names.find('\0', symbol.st_name) - symbol.st_name));
+            symbols_.push_back({symbol.st_value, symbol.st_size, Demangle(name.c_str())});
+        }
+        std::sort(symbols_.begin(), symbols_.end(), [](const Symbol& lhs, const Symbol& rhs) {
+            return lhs.address < rhs.address;
+        });
+    }
+
+    std::vector<Segment> segments_;
+    std::vector<Symbol>  symbols_;
+};
+
+}
+
+SamplingProfiler::~SamplingProfiler() {
+    munmap(ring_, ring_size_);
+    close(fd_);
+}
+
+SamplingProfiler::SamplingProfiler(pid_t pid, int sample_frequency_hz)
+    : fd_(-1),
+      sample_frequency_hz_(sample_frequency_hz),
+      ring_(nullptr),
+      ring_size_(0),
+      page_size_(static_cast<size_t>(sysconf(_SC_PAGESIZE))),
+      is_exec_seen_(false),
+      lost_samples_(0) {
+    perf_event_attr attr = {};
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_SOFTWARE;
+    attr.config = PERF_COUNT_SW_TASK_CLOCK;
+    attr.sample_freq = static_cast<uint64_t>(std::max(sample_frequency_hz, 1));
+    attr.freq = 1;
+    attr.sample_type = PERF_SAMPLE_IP | PERF_SAMPLE_TID | PERF_SAMPLE_CALLCHAIN;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.exclude_callchain_kernel = 1;
+    attr.mmap = 1;
+    attr.mmap2 = 1;
+    attr.comm = 1;
+    attr.comm_exec = 1;
+    attr.watermark = 1;
+    attr.wakeup_watermark = static_cast<uint32_t>(RING_PAGES * page_size_ / 2);
+    attr.sample_max_stack = MAX_STACK_DEPTH;
+
+    fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, pid, -1, -1, PERF_FLAG_FD_CLOEXEC));
+    if (fd_ == -1) {
+        throw std::system_error(errno, std::generic_category(), "ERROR::SamplingProfiler: Failed to open a perf event.");
+    }
+
+    ring_size_ = (RING_PAGES + 1) * page_size_;
+    void* ring = mmap(nullptr, ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (ring == MAP_FAILED) {
+        int error = errno;
+        close(fd_);
+        throw std::system_error(error, std::generic_category(), "ERROR::SamplingProfiler: Failed to map a perf ring buffer.");
+    }
+    ring_ = static_cast<char*>(ring);
+}
+
+void SamplingProfiler::Drain() {
+    perf_event_mmap_page* page = reinterpret_cast<perf_event_mmap_page*>(ring_);
+    const char* data = ring_ + page_size_;
+    size_t data_size = RING_PAGES * page_size_;
+    uint64_t head = __atomic_load_n(&page->data_head, __ATOMIC_ACQUIRE);
+    uint64_t tail = page->data_tail;
+
+    std::vector<char> record;
+    while (tail < head) {
+        perf_event_header header;
+        CopyFromRing(data, data_size, tail, reinterpret_cast<char*>(&header), sizeof(header));
+        if (header.size < sizeof(header) || header.size > head - tail) {
+            tail = head;
+            break;
+        }
+        record.resize(header.size);
+        CopyFromRing(data, data_size, tail, record.data(), header.size);
+        Parse(record.data(), header.size);
+        tail += header.size;
+    }
+    __atomic_store_n(&page->data_tail, tail, __ATOMIC_RELEASE);
+}
+
+SamplingProfile SamplingProfiler::Collect(const std::filesystem::path& program, size_t max_functions) {
+    Drain();
+
+    std::error_code error;
+    std::string program_file = std::filesystem::canonical(program, error).string();
+    std::map<std::string, std::unique_ptr<SymbolTable>> symbol_tables;
+    auto resolve = [&](uint64_t address, uint32_t mapping_index) {
+        if (mapping_index == NO_MAPPING) {
+            return std::string("[unknown]");
+        }
+        const Mapping& mapping = mappings_[mapping_index];
+        std::unique_ptr<SymbolTable>& symbol_table = symbol_tables[mapping.file];
+        if (symbol_table == nullptr) {
+            symbol_table = std::make_unique<SymbolTable>(mapping.file);
+        }
+
+        std::string name = symbol_table->Find(address - mapping.address + mapping.offset);
+        if (mapping.file == program_file) {
+            return name.empty() ? "[" + std::filesystem::path(mapping.file).filename().string() + "]" : name;
+        }
+        std::string library = "[" + std::filesystem::path(mapping.file).filename().string() + "]";
+        return name.empty() ? library : name + " " + library;
+    };
+
+    std::unordered_map<std::string, HotFunction> functions;
+    std::unordered_set<std::string> seen;
+    uint32_t begin = 0;
+    for (uint32_t end : frame_ends_) {
+        seen.clear();
+        for (uint32_t frame = begin; frame < end; ++frame) {
+            uint64_t address = frames_[frame] - (frame == begin ? 0 : 1);
+            std::string name = resolve(address, frame_mappings_[frame]);
+            HotFunction& function = functions.try_emplace(name, HotFunction{name, 0, 0}).first->second;
+            if (frame == begin) {
+                ++function.self_samples;
+            }
+            if (seen.insert(name).second) {
+                ++function.total_samples;
+            }
+        }
+        begin = end;
+    }
+
+    SamplingProfile profile = {};
+    profile.sample_frequency_hz = sample_frequency_hz_;
+    profile.samples = static_cast<uint32_t>(frame_ends_.size());
+    profile.lost_samples = lost_samples_;
+    for (auto& [name, function] : functions) {
+        profile.hot_functions.push_back(std::move(function));
+    }
+    std::sort(profile.hot_functions.begin(), profile.hot_functions.end(), [](const HotFunction& lhs, const HotFunction& rhs) {
+        if (lhs.self_samples != rhs.self_samples) {
+            return lhs.self_samples > rhs.self_samples;
+        }
+        if (lhs.total_samples != rhs.total_samples) {
+            return lhs.total_samples > rhs.total_samples;
+        }
+        return lhs.name < rhs.name;
+    });
+    if (profile.hot_functions.size() > max_functions) {
+        profile.hot_functions.resize(max_functions);
+    }
+    return profile;
+}
+
+int SamplingProfiler::fd() const {
+    return fd_;
+}
+
+void SamplingProfiler::Parse(const char* record, size_t size) {
+    perf_event_header header;
+    memcpy(&header, record, sizeof(header));
+    std::string_view payload(record + sizeof(header), size - sizeof(header));
+
+    if (header.type == PERF_RECORD_COMM) {
+        if ((header.misc & PERF_RECORD_MISC_COMM_EXEC) != 0 && !is_exec_seen_) {
+            is_exec_seen_ = true;
+            mappings_.clear();
+        }
+    } else if (header.type == PERF_RECORD_MMAP2) {
+        uint64_t address;
+        uint64_t length;
+        uint64_t offset;
+        if (!is_exec_seen_ || !ReadAt(payload, 8, address) || !ReadAt(payload, 16, length) || !ReadAt(payload, 24, offset) || payload.size() <= 64) {
+            return;
+        }
+        std::string_view file = payload.substr(64);
+        mappings_.push_back({address, length, offset, std::string(file.substr(0, file.find('\0')))});
+    } else if (header.type == PERF_RECORD_LOST) {
+        uint64_t lost;
+        if (ReadAt(payload, 8, lost)) {
+            lost_samples_ += static_cast<uint32_t>(lost);
+        }
+    } else if (header.type == PERF_RECORD_SAMPLE) {
+        uint64_t ip;
+        uint64_t count;
+        if (!is_exec_seen_ || !ReadAt(payload, 0, ip) || !ReadAt(payload, 16, count) || count > (payload.size() - 24) / sizeof(uint64_t)) {
+            return;
+        }
+
+        size_t begin = frames_.size();
+        for (uint64_t i = 0; i < count; ++i) {
+            uint64_t address;
+            if (!ReadAt(payload, 24 + i * sizeof(uint64_t), address)) {
+                break;
+            }
+            if (address < PERF_CONTEXT_MAX) {
+                frames_.push_back(address);
+            }
+        }
+        if (frames_.size() == begin) {
+            frames_.push_back(ip);
+        }
+
+        for (size_t frame = begin; frame < frames_.size(); ++frame) {
+            uint32_t mapping_index = NO_MAPPING;
+            for (size_t i = mappings_.size(); i-- > 0;) {
+                if (frames_[frame] >= mappings_[i].address && frames_[frame] - mappings_[i].address < mappings_[i].size) {
+                    mapping_index = static_cast<uint32_t>(i);
+                    break;
+                }
+            }
+            frame_mappings_.push_back(mapping_index);
+        }
+        frame_ends_.push_back(static_cast<uint32_t>(frames_.size()));
+    }
+}
+
+}
@@ -0,0 +1,63 @@
+#ifndef SAMPLING_PROFILER_H
+#define SAMPLING_PROFILER_H
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+#include "execution_result.h"
+
+namespace oj {
+
+struct SamplingOptions {
+    int    sample_frequency_hz;
+    size_t max_functions;
+};
+
+class SamplingProfiler {
+public:
+    static constexpr size_t RING_PAGES = 64;
+    static constexpr size_t MAX_STACK_DEPTH = 64;
+
+    ~SamplingProfiler();
+    SamplingProfiler(pid_t pid, int sample_frequency_hz);
+    SamplingProfiler(const SamplingProfiler& other) = delete;
+    SamplingProfiler(SamplingProfiler&& other) = delete;
+
+    SamplingProfiler& operator=(const SamplingProfiler& other) = delete;
+    SamplingProfiler& operator=(SamplingProfiler&& other) = delete;
+
+    void            Drain();
+    SamplingProfile Collect(const std::filesystem::path& program, size_t max_functions);
+
+    int             fd() const;
+
+private:
+    struct Mapping {
+        uint64_t    address;
+        uint64_t    size;
+        uint64_t    offset;
+        std::string file;
+    };
+
+    void Parse(const char* record, size_t size);
+
+    int                   fd_;
+    int                   sample_frequency_hz_;
+    char*                 ring_;
+    size_t                ring_size_;
+    size_t                page_size_;
+    bool                  is_exec_seen_;
+    std::vector<Mapping>  mappings_;
+    std::vector<uint64_t> frames_;
+    std::vector<uint32_t> frame_ends_;
+    std::vector<uint32_t> frame_mappings_;
+    uint32_t              lost_samples_;
+};
+
+}
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace oj {
+
+enum class SchedulingLane {
+    CONTEST,
+    PRACTICE
+};
+
+struct SchedulerOptions {
+    double aging_rate = 1.0;
+    double practice_penalty_ms = 5000.0;
+};
+
+template <typename T>
+class Scheduler {
+public:
+    ~Scheduler() = default;
+    explicit Scheduler(size_t capacity, const SchedulerOptions& options = SchedulerOptions())
+        : options_(options), capacity_(capacity != 0 ? capacity : 1), size_(0), is_closed_(false) {}
+    Scheduler(const Scheduler& other) = delete;
+    Scheduler(Scheduler&& other) = delete;
+
+    Scheduler& operator=(const Scheduler& other) = delete;
+    Scheduler& operator=(Scheduler&& other) = delete;
+
+    void Push(const void* group, SchedulingLane lane, std::vector<std::pair<T, double>> items) {
+        if (items.empty()) {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this, group]() { return groups_.size() < capacity_ || groups_.count(group) != 0 || is_closed_; });
+        if (is_closed_) {
+            throw std::runtime_error("ERROR::Scheduler: Failed to push into a closed scheduler.");
+        }
+
+        Group& pending = groups_[group];
+        if (pending.entries.empty()) {
+            pending.lane = lane;
+            pending.remaining_ms = 0.0;
+            pending.enqueued = std::chrono::steady_clock::now();
+        }
+        for (std::pair<T, double>& item : items) {
+            pending.entries.push_back({std::move(item.first), item.second});
+            pending.remaining_ms += item.second;
+        }
+        size_ += items.size();
+        not_empty_.notify_all();
+    }
+
+    std::optional<T> Pop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this]() { return size_ != 0 || is_closed_; });
+        if (size_ == 0) {
+            return std::nullopt;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        auto next = groups_.end();
+        double next_score = 0.0;
+        for (auto group = groups_.begin(); group != groups_.end(); ++group) {
+            double score = GetScore(group->second, now);
+            if (next == groups_.end() || score < next_score || (score == next_score && group->second.enqueued < next->second.enqueued)) {
+                next = group;
+                next_score = score;
+            }
+        }
+
+        Group& pending = next->second;
+        T item = std::move(pending.entries.front().item);
+        pending.remaining_ms -= pending.entries.front().expected_ms;
+        pending.entries.pop_front();
+        if (pending.entries.empty()) {
+            groups_.erase(next);
+            not_full_.notify_one();
+        }
+        --size_;
+        return item;
+    }
+
+    void Close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        is_closed_ = true;
+        not_full_.notify_all();
+        not_empty_.notify_all();
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return size_;
+    }
+
+    size_t capacity() const {
+        return capacity_;
+    }
+
+private:
+    struct Entry {
+        T      item;
+        double expected_ms;
+    };
+
+    struct Group {
+        SchedulingLane                        lane;
+        double                                remaining_ms;
+        std::chrono::steady_clock::time_point enqueued;
+        std::deque<Entry>                     entries;
+    };
+
+    double GetScore(const Group& group, std::chrono::steady_clock::time_point now) const {
+        double waited_ms = std::chrono::duration<double, std::milli>(now - group.enqueued).count();
+        double penalty_ms = group.lane == SchedulingLane::PRACTICE ? options_.practice_penalty_ms : 0.0;
+        return group.remaining_ms + penalty_ms - options_.aging_rate * waited_ms;
+    }
+
+    SchedulerOptions                       options_;
+    size_t                                 capacity_;
+    size_t                                 size_;
+    bool                                   is_closed_;
+    mutable std::mutex                     mutex_;
+    std::condition_variable                not_full_;
+    std::condition_variable                not_empty_;
+    std::unordered_map<const void*, Group> groups_;
+};
+
+}
+
+#endif
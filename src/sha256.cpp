@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <cstring>
+
+#include "sha256.h"
+
+namespace oj {
+
+namespace {
+
+constexpr uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+uint32_t Rotate(uint32_t x, int n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+}
+
+Sha256::Sha256()
+    : state_{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19},
+      length_(0),
+      block_{},
+      block_size_(0) {}
+
+void Sha256::Update(const char* data, size_t size) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+    length_ += size;
+
+    if (block_size_ != 0) {
+        size_t chunk = std::min(size, BLOCK_SIZE - block_size_);
+        memcpy(block_.data() + block_size_, bytes, chunk);
+        block_size_ += chunk;
+        bytes += chunk;
+        size -= chunk;
+        if (block_size_ < BLOCK_SIZE) {
+            return;
+        }
+        Compress(block_.data());
+        block_size_ = 0;
+    }
+
+    for (; size >= BLOCK_SIZE; bytes += BLOCK_SIZE, size -= BLOCK_SIZE) {
+        Compress(bytes);
+    }
+
+    memcpy(block_.data(), bytes, size);
+    block_size_ = size;
+}
+
+void Sha256::Update(std::string_view s) {
+    Update(s.data(), s.size());
+}
+
+Sha256::Digest Sha256::Finish() {
+    uint64_t bit_length = length_ * 8;
+    block_[block_size_++] = 0x80;
+    if (block_size_ > BLOCK_SIZE - sizeof(bit_length)) {
+        memset(block_.data() + block_size_, 0, BLOCK_SIZE - block_size_);
+        Compress(block_.data());
+        block_size_ = 0;
+    }
+    memset(block_.data() + block_size_, 0, BLOCK_SIZE - sizeof(bit_length) - block_size_);
+    for (size_t i = 0; i < sizeof(bit_length); ++i) {
+        block_[BLOCK_SIZE - 1 - i] = static_cast<uint8_t>(bit_length >> (8 * i));
+    }
+    Compress(block_.data());
+
+    Digest digest;
+    for (size_t i = 0; i < 8; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            digest[4 * i + j] = static_cast<uint8_t>(state_[i] >> (24 - 8 * j));
+        }
+    }
+    return digest;
+}
+
+void Sha256::Compress(const uint8_t* block) {
+    uint32_t w[64];
+    for (size_t i = 0; i < 16; ++i) {
+        w[i] = static_cast<uint32_t>(block[4 * i]) << 24 | static_cast<uint32_t>(block[4 * i + 1]) << 16 |
+               static_cast<uint32_t>(block[4 * i + 2]) << 8 | static_cast<uint32_t>(block[4 * i + 3]);
+    }
+    for (size_t i = 16; i < 64; ++i) {
+        uint32_t s0 = Rotate(w[i - 15], 7) ^ Rotate(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = Rotate(w[i - 2], 17) ^ Rotate(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state_[0];
+    uint32_t b = state_[1];
+    uint32_t c = state_[2];
+    uint32_t d = state_[3];
+    uint32_t e = state_[4];
+    uint32_t f = state_[5];
+    uint32_t g = state_[6];
+    uint32_t h = state_[7];
+    for (size_t i = 0; i < 64; ++i) {
+        uint32_t t1 = h + (Rotate(e, 6) ^ Rotate(e, 11) ^ Rotate(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+        uint32_t t2 = (Rotate(a, 2) ^ Rotate(a, 13) ^ Rotate(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    state_[0] += a;
+    state_[1] += b;
+    state_[2] += c;
+    state_[3] += d;
+    state_[4] += e;
+    state_[5] += f;
+    state_[6] += g;
+    state_[7] += h;
+}
+
+Sha256::Digest HmacSha256(std::string_view key, std::string_view message) {
+    uint8_t padded_key[Sha256::BLOCK_SIZE] = {};
+    if (key.size() > Sha256::BLOCK_SIZE) {
+        Sha256 key_hasher;
+        key_hasher.Update(key);
+        Sha256::Digest key_digest = key_hasher.Finish();
+        memcpy(padded_key, key_digest.data(), key_digest.size());
+    } else {
+        memcpy(padded_key, key.data(), key.size());
+    }
+
+    char inner_pad[Sha256::BLOCK_SIZE];
+    char outer_pad[Sha256::BLOCK_SIZE];
+    for (size_t i = 0; i < Sha256::BLOCK_SIZE; ++i) {
+        inner_pad[i] = static_cast<char>(padded_key[i] ^ 0x36);
+        outer_pad[i] = static_cast<char>(padded_key[i] ^ 0x5c);
+    }
+
+    Sha256 inner;
+    inner.Update(inner_pad, sizeof(inner_pad));
+    inner.Update(message);
+    Sha256::Digest inner_digest = inner.Finish();
+
+    Sha256 outer;
+    outer.Update(outer_pad, sizeof(outer_pad));
+    outer.Update(reinterpret_cast<const char*>(inner_digest.data()), inner_digest.size());
+    return outer.Finish();
+}
+
+std::string Sha256Hex(std::string_view s) {
+    static constexpr char DIGITS[] = "0123456789abcdef";
+
+    Sha256 hasher;
+    hasher.Update(s);
+    Sha256::Digest digest = hasher.Finish();
+
+    std::string hex(2 * digest.size(), '0');
+    for (size_t i = 0; i < digest.size(); ++i) {
+        hex[2 * i] = DIGITS[digest[i] >> 4];
+        hex[2 * i + 1] = DIGITS[digest[i] & 0xf];
+    }
+    return hex;
+}
+
+bool IsSha256Hex(std::string_view s) {
+    return s.size() == 2 * Sha256::DIGEST_SIZE && s.find_first_not_of("0123456789abcdef") == std::string_view::npos;
+}
+
+bool IsDigestEqual(const Sha256::Digest& lhs, const Sha256::Digest& rhs) {
+    uint8_t difference = 0;
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        difference |= lhs[i] ^ rhs[i];
+    }
+    return difference == 0;
+}
+
+}
@@ -0,0 +1,40 @@
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace oj {
+
+class Sha256 {
+public:
+    static constexpr size_t DIGEST_SIZE = 32;
+    static constexpr size_t BLOCK_SIZE = 64;
+
+    using Digest = std::array<uint8_t, DIGEST_SIZE>;
+
+    Sha256();
+
+    void   Update(const char* data, size_t size);
+    void   Update(std::string_view s);
+    Digest Finish();
+
+private:
+    void Compress(const uint8_t* block);
+
+    uint32_t                        state_[8];
+    uint64_t                        length_;
+    std::array<uint8_t, BLOCK_SIZE> block_;
+    size_t                          block_size_;
+};
+
+Sha256::Digest HmacSha256(std::string_view key, std::string_view message);
+std::string    Sha256Hex(std::string_view s);
+bool           IsSha256Hex(std::string_view s);
+bool           IsDigestEqual(const Sha256::Digest& lhs, const Sha256::Digest& rhs);
+
+}
+
+#endif
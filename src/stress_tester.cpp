@@ -0,0 +1,386 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/wait.h>
+
+#include "file_descriptor.h"
+#include "line_diff.h"
+#include "process.h"
+#include "stress_tester.h"
+
+namespace oj {
+
+namespace {
+
+constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+void BlockSigpipe() {
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGPIPE);
+    int error = pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    if (error != 0) {
+        throw std::system_error(error, std::generic_category(), "ERROR::StressTester: Failed to block SIGPIPE.");
+    }
+}
+
+struct Pipe {
+    Pipe() : read_end(-1), write_end(-1) {
+        int pipefd[2];
+        if (pipe2(pipefd, O_CLOEXEC) == -1) {
+            throw std::system_error(errno, std::generic_category(), "ERROR::StressTester: Failed to open a pipe.");
+        }
+        read_end = FileDescriptor(pipefd[0], true);
+        write_end = FileDescriptor(pipefd[1], true);
+    }
+
+    FileDescriptor read_end;
+    FileDescriptor write_end;
+};
+
+void SetNonBlocking(const FileDescriptor& fd) {
+    int flags = fcntl(fd.fd(), F_GETFL);
+    if (flags == -1 || fcntl(fd.fd(), F_SETFL, flags | O_NONBLOCK) == -1) {
+        throw std::system_error(errno, std::generic_category(), "ERROR::StressTester: Failed to set a pipe non-blocking.");
+    }
+}
+
+bool Drain(FileDescriptor& fd, std::string& out) {
+    char buf[CHUNK_SIZE];
+    while (true) {
+        ssize_t bytes = read(fd.fd(), buf, sizeof(buf));
+        if (bytes > 0) {
+            out.append(buf, bytes);
+            continue;
+        }
+        if (bytes == 0) {
+            fd.Close();
+            return false;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN) {
+            return true;
+        }
+        throw std::system_error(errno, std::generic_category(), "ERROR::StressTester: Failed to read from a pipe.");
+    }
+}
+
+bool IsCleanExit(const Process& process) {
+    return process.is_exited() && WEXITSTATUS(process.status()) == EXIT_SUCCESS;
+}
+
+bool IsRunning(const Process& process) {
+    siginfo_t info;
+    info.si_pid = 0;
+    return waitid(P_PID, process.pid(), &info, WEXITED | WNOHANG | WNOWAIT) == 0 && info.si_pid == 0;
+}
+
+}
+
+StressTester::StressTester (
+    const std::filesystem::path& generator,
+    const std::filesystem::path& candidate,
+    const std::filesystem::path& reference,
+    int                          time_limit_ms,
+    size_t                       workers
+) : generator_(generator),
+    candidate_(candidate),
+    reference_(reference),
+    time_limit_ms_(time_limit_ms),
+    workers_(workers != 0 ? workers : std::max(1u, std::thread::hardware_concurrency())) {
+    for (const std::filesystem::path& program : {generator_, candidate_, reference_}) {
+        if (!std::filesystem::exists(program)) {
+            throw std::runtime_error("ERROR::StressTester: " + program.string() + " doesn't exist.");
+        }
+    }
+}
+
+StressReport StressTester::Run(uint64_t first_seed, uint64_t seed_count) const {
+    std::atomic<uint64_t>        next_seed(0);
+    std::atomic<uint64_t>        seeds_tested(0);
+    std::atomic<bool>            is_stopped(false);
+    std::mutex                   mutex;
+    std::optional<StressFailure> failure;
+    std::exception_ptr           exception;
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers_);
+    for (size_t i = 0; i < workers_; ++i) {
+        threads.emplace_back([&]() {
+            try {
+                BlockSigpipe();
+                while (!is_stopped.load(std::memory_order_relaxed)) {
+                    uint64_t index = next_seed.fetch_add(1, std::memory_order_relaxed);
+                    if (index >= seed_count) {
+                        return;
+                    }
+
+                    uint64_t seed = first_seed + index;
+                    StressFailure seed_failure;
+                    bool is_diverged = RunSeed(seed, seed_failure);
+                    seeds_tested.fetch_add(1, std::memory_order_relaxed);
+
+                    if (is_diverged) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (!failure.has_value() || seed < failure->seed) {
+                            failure = std::move(seed_failure);
+                        }
+                        is_stopped.store(true, std::memory_order_relaxed);
+                    }
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (exception == nullptr) {
+                    exception = std::current_exception();
+                }
+                is_stopped.store(true, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    if (exception != nullptr) {
+        std::rethrow_exception(exception);
+    }
+
+    StressReport report;
+    report.seeds_tested = seeds_tested.load();
+    report.elapsed_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    report.seeds_per_sec = report.elapsed_sec > 0.0 ? report.seeds_tested / report.elapsed_sec : 0.0;
+    report.failure = std::move(failure);
+    if (report.failure.has_value()) {
+        report.failure->input = GenerateInput(report.failure->seed);
+    }
+    return report;
+}
+
+std::string StressTester::GenerateInput(uint64_t seed) const {
+    Pipe output;
+    std::unique_ptr<Process> generator = Process::CreateProcess(
+        generator_, {generator_.string(), std::to_string(seed)}, FD_EMPTY, output.write_end);
+    output.write_end.Close();
+
+    std::string input;
+    char buf[CHUNK_SIZE];
+    ssize_t bytes;
+    while ((bytes = read(output.read_end.fd(), buf, sizeof(buf))) != 0) {
+        if (bytes == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "ERROR::StressTester: Failed to read from a pipe.");
+        }
+        input.append(buf, bytes);
+    }
+
+    generator->Wait();
+    return input;
+}
+
+bool StressTester::RunSeed(uint64_t seed, StressFailure& failure) const {
+    Pipe generator_output;
+    Pipe candidate_input;
+    Pipe candidate_output;
+    Pipe reference_input;
+    Pipe reference_output;
+
+    std::unique_ptr<Process> generator = Process::CreateProcess(
+        generator_, {generator_.string(), std::to_string(seed)}, FD_EMPTY, generator_output.write_end);
+    std::unique_ptr<Process> candidate = Process::CreateProcess(
+        candidate_, {candidate_.string()}, candidate_input.read_end, candidate_output.write_end);
+    std::unique_ptr<Process> reference = Process::CreateProcess(
+        reference_, {reference_.string()}, reference_input.read_end, reference_output.write_end);
+
+    generator_output.write_end.Close();
+    candidate_input.read_end.Close();
+    candidate_output.write_end.Close();
+    reference_input.read_end.Close();
+    reference_output.write_end.Close();
+
+    FileDescriptor& source = generator_output.read_end;
+    FileDescriptor& candidate_sink = candidate_input.write_end;
+    FileDescriptor& reference_sink = reference_input.write_end;
+    for (const FileDescriptor* fd : {&source, &candidate_sink, &reference_sink, &candidate_output.read_end, &reference_output.read_end}) {
+        SetNonBlocking(*fd);
+    }
+
+    failure.seed = seed;
+    failure.candidate_output.clear();
+    failure.reference_output.clear();
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(time_limit_ms_);
+    bool   is_source_exhausted = false;
+    size_t pending_bytes = 0;
+    int    blocked_sink = -1;
+    bool   is_timed_out = false;
+
+    while (true) {
+        bool is_input_done = is_source_exhausted && pending_bytes == 0;
+        if (is_input_done) {
+            candidate_sink.Close();
+            reference_sink.Close();
+        }
+        if (is_input_done && !candidate_output.read_end.is_opened() && !reference_output.read_end.is_opened()) {
+            break;
+        }
+
+        pollfd fds[3];
+        nfds_t nfds = 0;
+        if (!is_input_done) {
+            if (pending_bytes > 0 && reference_sink.is_opened()) {
+                fds[nfds++] = {reference_sink.fd(), POLLOUT, 0};
+            } else if (pending_bytes == 0 && blocked_sink != -1) {
+                fds[nfds++] = {blocked_sink, POLLOUT, 0};
+            } else if (pending_bytes == 0) {
+                fds[nfds++] = {source.fd(), POLLIN, 0};
+            }
+        }
+        for (FileDescriptor* output : {&candidate_output.read_end, &reference_output.read_end}) {
+            if (output->is_opened()) {
+                fds[nfds++] = {output->fd(), POLLIN, 0};
+            }
+        }
+
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0) {
+            is_timed_out = true;
+            break;
+        }
+        if (nfds > 0 && poll(fds, nfds, static_cast<int>(remaining)) == -1 && errno != EINTR) {
+            throw std::system_error(errno, std::generic_category(), "ERROR::StressTester: Failed to poll pipes.");
+        }
+
+        if (candidate_output.read_end.is_opened()) {
+            Drain(candidate_output.read_end, failure.candidate_output);
+        }
+        if (reference_output.read_end.is_opened()) {
+            Drain(reference_output.read_end, failure.reference_output);
+        }
+
+        if (is_input_done) {
+            continue;
+        }
+
+        if (pending_bytes > 0) {
+            if (!reference_sink.is_opened()) {
+                char buf[CHUNK_SIZE];
+                ssize_t bytes = read(source.fd(), buf, std::min(pending_bytes, sizeof(buf)));
+                if (bytes > 0) {
+                    pending_bytes -= bytes;
+                }
+                continue;
+            }
+
+            ssize_t bytes = splice(source.fd(), nullptr, reference_sink.fd(), nullptr, pending_bytes, SPLICE_F_NONBLOCK);
+            if (bytes > 0) {
+                pending_bytes -= bytes;
+            } else if (bytes == -1 && errno == EPIPE) {
+                reference_sink.Close();
+            } else if (bytes == -1 && errno != EAGAIN && errno != EINTR) {
+                throw std::system_error(errno, std::generic_category(), "ERROR::StressTester: Failed to splice input.");
+            }
+            continue;
+        }
+
+        ssize_t bytes;
+        FileDescriptor* sink = nullptr;
+        if (candidate_sink.is_opened() && reference_sink.is_opened()) {
+            sink = &candidate_sink;
+            bytes = tee(source.fd(), candidate_sink.fd(), CHUNK_SIZE, SPLICE_F_NONBLOCK);
+            if (bytes > 0) {
+                pending_bytes = bytes;
+            }
+        } else if (candidate_sink.is_opened() || reference_sink.is_opened()) {
+            sink = candidate_sink.is_opened() ? &candidate_sink : &reference_sink;
+            bytes = splice(source.fd(), nullptr, sink->fd(), nullptr, CHUNK_SIZE, SPLICE_F_NONBLOCK);
+        } else {
+            char buf[CHUNK_SIZE];
+            bytes = read(source.fd(), buf, sizeof(buf));
+        }
+
+        blocked_sink = -1;
+        if (bytes == 0) {
+            is_source_exhausted = true;
+        } else if (bytes == -1 && errno == EPIPE && sink != nullptr) {
+            sink->Close();
+        } else if (bytes == -1 && errno == EAGAIN && sink != nullptr) {
+            int available = 0;
+            if (ioctl(source.fd(), FIONREAD, &available) == 0 && available > 0) {
+                blocked_sink = sink->fd();
+            }
+        } else if (bytes == -1 && errno != EAGAIN && errno != EINTR) {
+            throw std::system_error(errno, std::generic_category(), "ERROR::StressTester: Failed to relay input.");
+        }
+    }
+
+    bool is_generator_late = false;
+    bool is_reference_late = false;
+    bool is_candidate_late = false;
+    if (is_timed_out) {
+        bool is_input_blocked = pending_bytes > 0 || blocked_sink != -1;
+        is_generator_late = !is_source_exhausted && !is_input_blocked && IsRunning(*generator);
+        is_reference_late = IsRunning(*reference);
+        is_candidate_late = IsRunning(*candidate);
+        if (candidate_sink.is_opened() && blocked_sink == candidate_sink.fd()) {
+            is_reference_late = false;
+            is_candidate_late = true;
+        }
+
+        generator->Kill();
+        candidate->Kill();
+        reference->Kill();
+    }
+    generator->Wait();
+    candidate->Wait();
+    reference->Wait();
+
+    if (is_generator_late) {
+        throw std::runtime_error("ERROR::StressTester: Generator " + generator_.string() + " exceeded the time limit on seed " + std::to_string(seed) + ".");
+    }
+    if (is_reference_late) {
+        throw std::runtime_error("ERROR::StressTester: Reference " + reference_.string() + " exceeded the time limit on seed " + std::to_string(seed) + ".");
+    }
+    if (is_candidate_late) {
+        failure.reason = "Time limit exceeded";
+        return true;
+    }
+    if (!IsCleanExit(*generator)) {
+        throw std::runtime_error("ERROR::StressTester: Generator " + generator_.string() + " failed on seed " + std::to_string(seed) + ".");
+    }
+    if (!IsCleanExit(*reference)) {
+        throw std::runtime_error("ERROR::StressTester: Reference " + reference_.string() + " failed on seed " + std::to_string(seed) + ".");
+    }
+    if (!IsCleanExit(*candidate)) {
+        failure.reason = "Candidate exited abnormally";
+        return true;
+    }
+
+    if (failure.candidate_output != failure.reference_output) {
+        std::vector<LineJudgeData> hunks = LineDiff(1).Diff(failure.candidate_output, failure.reference_output);
+        failure.reason = hunks.empty() ? "Wrong answer" : "Wrong answer on line " + std::to_string(hunks.front().user_line_begin + 1);
+        return true;
+    }
+    return false;
+}
+
+}
@@ -0,0 +1,57 @@
+#ifndef STRESS_TESTER_H
+#define STRESS_TESTER_H
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace oj {
+
+struct StressFailure {
+    uint64_t    seed;
+    std::string reason;
+    std::string input;
+    std::string candidate_output;
+    std::string reference_output;
+};
+
+struct StressReport {
+    uint64_t                     seeds_tested;
+    double                       elapsed_sec;
+    double                       seeds_per_sec;
+    std::optional<StressFailure> failure;
+};
+
+class StressTester {
+public:
+    ~StressTester() = default;
+    StressTester (
+        const std::filesystem::path& generator,
+        const std::filesystem::path& candidate,
+        const std::filesystem::path& reference,
+        int                          time_limit_ms = 2000,
+        size_t                       workers = 0
+    );
+    StressTester(const StressTester& other) = delete;
+    StressTester(StressTester&& other) = delete;
+
+    StressTester& operator=(const StressTester& other) = delete;
+    StressTester& operator=(StressTester&& other) = delete;
+
+    StressReport Run(uint64_t first_seed, uint64_t seed_count) const;
+    std::string  GenerateInput(uint64_t seed) const;
+
+private:
+    bool RunSeed(uint64_t seed, StressFailure& failure) const;
+
+    std::filesystem::path generator_;
+    std::filesystem::path candidate_;
+    std::filesystem::path reference_;
+    int                   time_limit_ms_;
+    size_t                workers_;
+};
+
+}
+
+#endif
@@ -25,7 +25,7 @@ int Subprocess::Wait() {
         return pid_;
     }
 
-    int pid = wait4(pid_, &status_, NULL, &usage_);
+    int pid = wait4(pid_, &status_, 0, &usage_);
     if (pid == -1) {
         throw std::system_error(errno, std::generic_category(), "ERROR::Process: Failed to wait a child process with error.");
     }
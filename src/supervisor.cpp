@@ -0,0 +1,525 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <system_error>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/timerfd.h>
+#include <sys/wait.h>
+
+#include "answer_index.h"
+#include "buffer_pool.h"
+#include "supervisor.h"
+
+namespace oj {
+
+namespace {
+
+constexpr size_t BUFFER_SIZE = 64 * 1024;
+
+void SetNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL);
+    if (flags == -1 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1) {
+        throw std::system_error(errno, std::generic_category(), "ERROR::Supervisor: Failed to set a file descriptor non-blocking.");
+    }
+}
+
+ssize_t WriteWithoutSigpipe(int fd, const char* data, size_t size) {
+    sigset_t sigpipe;
+    sigset_t old_mask;
+    sigemptyset(&sigpipe);
+    sigaddset(&sigpipe, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &sigpipe, &old_mask);
+
+    sigset_t pending;
+    sigpending(&pending);
+    bool was_pending = sigismember(&pending, SIGPIPE);
+
+    ssize_t bytes = write(fd, data, size);
+    int write_errno = errno;
+
+    if (bytes == -1 && write_errno == EPIPE && !was_pending) {
+        timespec zero = {0, 0};
+        while (sigtimedwait(&sigpipe, nullptr, &zero) == -1 && errno == EINTR) {}
+    }
+
+    pthread_sigmask(SIG_SETMASK, &old_mask, nullptr);
+    errno = write_errno;
+    return bytes;
+}
+
+ssize_t Capture(BufferPool& buffer_pool, int fd, Buffer& capture, size_t& captured, bool is_growable) {
+    ssize_t bytes;
+    while (true) {
+        if (captured == capture.size()) {
+            if (!is_growable) {
+                return 1;
+            }
+            capture = buffer_pool.Grow(capture, captured);
+        }
+        bytes = read(fd, capture.data() + captured, capture.size() - captured);
+        if (bytes <= 0) {
+            break;
+        }
+        captured += bytes;
+    }
+    return bytes;
+}
+
+long ParseStatusField(const char* status, const char* field) {
+    const char* line = strstr(status, field);
+    if (line == nullptr) {
+        return -1;
+    }
+    return strtol(line + strlen(field), nullptr, 10);
+}
+
+long long ReadGroupCpuTicks(pid_t pgid) {
+    DIR* proc = opendir("/proc");
+    if (proc == nullptr) {
+        return 0;
+    }
+
+    long long ticks = 0;
+    char path[288];
+    char stat[1024];
+    while (dirent* entry = readdir(proc)) {
+        if (entry->d_name[0] < '1' || entry->d_name[0] > '9') {
+            continue;
+        }
+        snprintf(path, sizeof(path), "/proc/%s/stat", entry->d_name);
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd == -1) {
+            continue;
+        }
+        ssize_t bytes = read(fd, stat, sizeof(stat) - 1);
+        close(fd);
+        if (bytes <= 0) {
+            continue;
+        }
+        stat[bytes] = '\0';
+
+        const char* fields = strrchr(stat, ')');
+        char state;
+        int ppid;
+        int pgrp;
+        unsigned long long utime;
+        unsigned long long stime;
+        if (fields != nullptr &&
+            sscanf(fields + 1, " %c %d %d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu", &state, &ppid, &pgrp, &utime, &stime) == 5 &&
+            pgrp == pgid) {
+            ticks += utime + stime;
+        }
+    }
+    closedir(proc);
+    return ticks;
+}
+
+}
+
+Supervisor::~Supervisor() {
+    if (!is_reaped_) {
+        kill(-pid_, SIGKILL);
+        kill(pid_, SIGKILL);
+        while (waitpid(pid_, nullptr, 0) == -1 && errno == EINTR) {}
+    }
+    for (int fd : {pidfd_, timerfd_, deadline_fd_, status_fd_}) {
+        if (fd != -1) {
+            close(fd);
+        }
+    }
+}
+
+Supervisor::Supervisor(pid_t pid, BufferPool& buffer_pool, int sample_interval_ms, size_t max_samples)
+    : pid_(pid),
+      buffer_pool_(buffer_pool),
+      sample_interval_ms_(sample_interval_ms),
+      max_samples_(std::max<size_t>(max_samples & ~static_cast<size_t>(1), 2)),
+      pidfd_(-1),
+      timerfd_(-1),
+      deadline_fd_(-1),
+      status_fd_(-1),
+      is_reaped_(false),
+      is_wall_time_limit_exceeded_(false),
+      status_(0),
+      start_(std::chrono::steady_clock::now()),
+      wall_time_usec_(0),
+      bucket_{},
+      bucket_size_(0),
+      stride_(1),
+      usage_{},
+      memory_profile_{},
+      is_hashing_(false),
+      is_output_matched_(false),
+      is_diverged_(false),
+      matched_bytes_(0),
+      expected_output_{},
+      sampling_profiler_(nullptr),
+      input_bytes_(0),
+      output_bytes_(0) {
+    memory_profile_.sample_interval_ms = sample_interval_ms_;
+
+    pidfd_ = static_cast<int>(syscall(SYS_pidfd_open, pid_, 0));
+
+    if (sample_interval_ms_ > 0) {
+        std::string status_path = "/proc/" + std::to_string(pid_) + "/status";
+        status_fd_ = open(status_path.c_str(), O_RDONLY | O_CLOEXEC);
+
+        timerfd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (timerfd_ == -1) {
+            throw std::system_error(errno, std::generic_category(), "ERROR::Supervisor: Failed to create a timer.");
+        }
+
+        itimerspec interval = {};
+        interval.it_interval.tv_sec = sample_interval_ms_ / 1000;
+        interval.it_interval.tv_nsec = sample_interval_ms_ % 1000 * 1000000L;
+        interval.it_value = interval.it_interval;
+        if (timerfd_settime(timerfd_, 0, &interval, nullptr) == -1) {
+            throw std::system_error(errno, std::generic_category(), "ERROR::Supervisor: Failed to arm a timer.");
+        }
+    }
+}
+
+void Supervisor::SetWallTimeLimit(int time_limit_sec, int time_limit_usec) {
+    if (time_limit_sec == 0 && time_limit_usec == 0) {
+        return;
+    }
+
+    if (deadline_fd_ == -1) {
+        deadline_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (deadline_fd_ == -1) {
+            throw std::system_error(errno, std::generic_category(), "ERROR::Supervisor: Failed to create a timer.");
+        }
+    }
+
+    long long deadline_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(start_.time_since_epoch()).count()
+                            + time_limit_sec * 1000000000LL + time_limit_usec * 1000LL;
+    itimerspec deadline = {};
+    deadline.it_value.tv_sec = deadline_nsec / 1000000000LL;
+    deadline.it_value.tv_nsec = deadline_nsec % 1000000000LL;
+    if (timerfd_settime(deadline_fd_, TFD_TIMER_ABSTIME, &deadline, nullptr) == -1) {
+        throw std::system_error(errno, std::generic_category(), "ERROR::Supervisor: Failed to arm a timer.");
+    }
+}
+
+void Supervisor::SetExpectedOutput(const ExpectedOutput& expected_output) {
+    is_hashing_ = true;
+    expected_output_ = expected_output;
+}
+
+void Supervisor::SetSamplingProfiler(SamplingProfiler& sampling_profiler) {
+    sampling_profiler_ = &sampling_profiler;
+}
+
+int Supervisor::Run(int input_fd, const std::string& input, int output_fd, std::string& output) {
+    SetNonBlocking(output_fd);
+    if (input.empty()) {
+        close(input_fd);
+        input_fd = -1;
+    } else {
+        SetNonBlocking(input_fd);
+    }
+
+    Sample();
+
+    Buffer capture = buffer_pool_.Acquire(BUFFER_SIZE);
+    size_t captured = 0;
+    size_t written = 0;
+    int profiler_fd = sampling_profiler_ != nullptr ? sampling_profiler_->fd() : -1;
+    bool is_exited = false;
+    while (!is_exited) {
+        pollfd fds[6];
+        nfds_t nfds = 0;
+        int pid_index = -1;
+        int timer_index = -1;
+        int deadline_index = -1;
+        int output_index = -1;
+        int input_index = -1;
+        int profiler_index = -1;
+        if (pidfd_ != -1) {
+            pid_index = nfds;
+            fds[nfds++] = {pidfd_, POLLIN, 0};
+        }
+        if (timerfd_ != -1) {
+            timer_index = nfds;
+            fds[nfds++] = {timerfd_, POLLIN, 0};
+        }
+        if (deadline_fd_ != -1 && !is_wall_time_limit_exceeded_) {
+            deadline_index = nfds;
+            fds[nfds++] = {deadline_fd_, POLLIN, 0};
+        }
+        if (output_fd != -1) {
+            output_index = nfds;
+            fds[nfds++] = {output_fd, POLLIN, 0};
+        }
+        if (input_fd != -1) {
+            input_index = nfds;
+            fds[nfds++] = {input_fd, POLLOUT, 0};
+        }
+        if (profiler_fd != -1) {
+            profiler_index = nfds;
+            fds[nfds++] = {profiler_fd, POLLIN, 0};
+        }
+
+        int timeout_ms = pidfd_ != -1 ? -1 : std::max(sample_interval_ms_, 1);
+        if (poll(fds, nfds, timeout_ms) == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "ERROR::Supervisor: Failed to poll.");
+        }
+
+        if (output_index != -1 && fds[output_index].revents != 0) {
+            ssize_t bytes = Drain(output_fd, capture, captured);
+            if (bytes == 0 || (errno != EAGAIN && errno != EINTR)) {
+                close(output_fd);
+                output_fd = -1;
+            }
+        }
+
+        if (input_index != -1 && fds[input_index].revents != 0) {
+            ssize_t bytes = WriteWithoutSigpipe(input_fd, input.data() + written, input.size() - written);
+            if (bytes > 0) {
+                written += bytes;
+            }
+            if (written == input.size() || (bytes == -1 && errno != EAGAIN && errno != EINTR)) {
+                close(input_fd);
+                input_fd = -1;
+            }
+        }
+
+        if (timer_index != -1 && (fds[timer_index].revents & POLLIN) != 0) {
+            uint64_t expirations;
+            if (read(timerfd_, &expirations, sizeof(expirations)) == sizeof(expirations)) {
+                Sample();
+            }
+        }
+
+        if (deadline_index != -1 && (fds[deadline_index].revents & POLLIN) != 0) {
+            KillOnDeadline();
+        }
+
+        if (profiler_index != -1 && fds[profiler_index].revents != 0) {
+            sampling_profiler_->Drain();
+            if ((fds[profiler_index].revents & POLLIN) == 0) {
+                profiler_fd = -1;
+            }
+        }
+
+        if (pid_index != -1) {
+            is_exited = (fds[pid_index].revents & POLLIN) != 0;
+        } else {
+            is_exited = HasExited();
+        }
+    }
+    wall_time_usec_ = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_).count();
+
+    if (input_fd != -1) {
+        close(input_fd);
+    }
+    if (output_fd != -1) {
+        Drain(output_fd, capture, captured);
+        close(output_fd);
+    }
+    Reap();
+
+    bool is_exited_normally = WIFEXITED(status_) && WEXITSTATUS(status_) == EXIT_SUCCESS && !is_wall_time_limit_exceeded_;
+    size_t size = matched_bytes_ + captured;
+    if (is_hashing_ && is_exited_normally) {
+        bool is_raw_matched = expected_output_.answer.data() != nullptr ? !is_diverged_ && size == expected_output_.size
+                                                                         : size == expected_output_.size && output_hasher_.raw_digest() == expected_output_.raw_hash;
+        is_output_matched_ = is_raw_matched;
+    }
+    input_bytes_ = written;
+    output_bytes_ = size;
+    output.clear();
+    if (!is_output_matched_) {
+        output.reserve(size);
+        output.append(expected_output_.answer.substr(0, matched_bytes_));
+        output.append(capture.data(), captured);
+    }
+    if (!is_output_matched_ && is_hashing_ && is_exited_normally && expected_output_.is_whitespace_insensitive &&
+        expected_output_.answer.data() != nullptr && output_hasher_.normalized_digest() == expected_output_.normalized_hash &&
+        AnswerIndex::IsTokenEqual(output, expected_output_.answer)) {
+        is_output_matched_ = true;
+        output.clear();
+    }
+    capture.Release();
+
+    if (bucket_size_ != 0) {
+        memory_profile_.timeline.push_back(bucket_);
+        bucket_size_ = 0;
+    }
+
+    memory_profile_.sample_interval_ms = sample_interval_ms_ * static_cast<int>(stride_);
+    memory_profile_.peak_rss_kb = std::max(memory_profile_.peak_rss_kb, usage_.ru_maxrss);
+    memory_profile_.minor_page_faults = usage_.ru_minflt;
+    memory_profile_.major_page_faults = usage_.ru_majflt;
+    memory_profile_.voluntary_context_switches = usage_.ru_nvcsw;
+    memory_profile_.involuntary_context_switches = usage_.ru_nivcsw;
+    return status_;
+}
+
+const rusage& Supervisor::usage() const {
+    return usage_;
+}
+
+const MemoryProfile& Supervisor::memory_profile() const {
+    return memory_profile_;
+}
+
+long long Supervisor::wall_time_usec() const {
+    return wall_time_usec_;
+}
+
+bool Supervisor::is_wall_time_limit_exceeded() const {
+    return is_wall_time_limit_exceeded_;
+}
+
+bool Supervisor::is_output_matched() const {
+    return is_output_matched_;
+}
+
+uint64_t Supervisor::output_hash() const {
+    return output_hasher_.raw_digest();
+}
+
+size_t Supervisor::input_bytes() const {
+    return input_bytes_;
+}
+
+size_t Supervisor::output_bytes() const {
+    return output_bytes_;
+}
+
+bool Supervisor::HasExited() const {
+    siginfo_t info = {};
+    if (waitid(P_PID, pid_, &info, WEXITED | WNOHANG | WNOWAIT) == -1) {
+        throw std::system_error(errno, std::generic_category(), "ERROR::Supervisor: Failed to wait a child process.");
+    }
+    return info.si_pid != 0;
+}
+
+void Supervisor::KillOnDeadline() {
+    is_wall_time_limit_exceeded_ = true;
+    kill(-pid_, SIGKILL);
+    if (pidfd_ != -1 && syscall(SYS_pidfd_send_signal, pidfd_, SIGKILL, nullptr, 0) == 0) {
+        return;
+    }
+    kill(pid_, SIGKILL);
+}
+
+void Supervisor::Sample() {
+    if (status_fd_ == -1) {
+        return;
+    }
+
+    char status[4096];
+    ssize_t bytes = pread(status_fd_, status, sizeof(status) - 1, 0);
+    if (bytes <= 0) {
+        return;
+    }
+    status[bytes] = '\0';
+
+    long rss_kb = ParseStatusField(status, "VmRSS:");
+    long vm_size_kb = ParseStatusField(status, "VmSize:");
+    if (rss_kb < 0 || vm_size_kb < 0) {
+        return;
+    }
+
+    memory_profile_.peak_rss_kb = std::max({memory_profile_.peak_rss_kb, rss_kb, ParseStatusField(status, "VmHWM:")});
+    memory_profile_.peak_vm_size_kb = std::max({memory_profile_.peak_vm_size_kb, vm_size_kb, ParseStatusField(status, "VmPeak:")});
+
+    MemorySample sample;
+    sample.time_ms = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_).count());
+    sample.rss_kb = static_cast<uint32_t>(rss_kb);
+    sample.vm_size_kb = static_cast<uint32_t>(vm_size_kb);
+    AppendSample(sample);
+}
+
+void Supervisor::AppendSample(const MemorySample& sample) {
+    if (bucket_size_ == 0) {
+        bucket_ = sample;
+    } else {
+        bucket_.rss_kb = std::max(bucket_.rss_kb, sample.rss_kb);
+        bucket_.vm_size_kb = std::max(bucket_.vm_size_kb, sample.vm_size_kb);
+    }
+    if (++bucket_size_ < stride_) {
+        return;
+    }
+
+    std::vector<MemorySample>& timeline = memory_profile_.timeline;
+    timeline.push_back(bucket_);
+    bucket_size_ = 0;
+
+    if (timeline.size() == max_samples_) {
+        for (size_t i = 0; i < timeline.size() / 2; ++i) {
+            MemorySample merged = timeline[2 * i];
+            merged.rss_kb = std::max(merged.rss_kb, timeline[2 * i + 1].rss_kb);
+            merged.vm_size_kb = std::max(merged.vm_size_kb, timeline[2 * i + 1].vm_size_kb);
+            timeline[i] = merged;
+        }
+        timeline.resize(timeline.size() / 2);
+        stride_ *= 2;
+    }
+}
+
+ssize_t Supervisor::Drain(int fd, Buffer& capture, size_t& captured) {
+    while (true) {
+        size_t begin = captured;
+        ssize_t bytes = Capture(buffer_pool_, fd, capture, captured, expected_output_.answer.data() == nullptr || is_diverged_);
+        Hash(capture.data() + begin, captured - begin);
+        Compare(captured, capture.data());
+        if (bytes <= 0) {
+            return bytes;
+        }
+    }
+}
+
+void Supervisor::Hash(const char* data, size_t size) {
+    if (is_hashing_ && size != 0) {
+        output_hasher_.Update(data, size);
+    }
+}
+
+void Supervisor::Compare(size_t& captured, const char* data) {
+    std::string_view answer = expected_output_.answer;
+    if (answer.data() == nullptr || is_diverged_ || captured == 0) {
+        return;
+    }
+    if (captured <= answer.size() - matched_bytes_ && memcmp(data, answer.data() + matched_bytes_, captured) == 0) {
+        matched_bytes_ += captured;
+        captured = 0;
+    } else {
+        is_diverged_ = true;
+    }
+}
+
+void Supervisor::Reap() {
+    while (wait4(pid_, &status_, 0, &usage_) == -1) {
+        if (errno != EINTR) {
+            is_reaped_ = true;
+            throw std::system_error(errno, std::generic_category(), "ERROR::Supervisor: Failed to wait a child process.");
+        }
+    }
+    is_reaped_ = true;
+
+    if (kill(-pid_, SIGSTOP) == -1) {
+        return;
+    }
+    long long cpu_time_usec = ReadGroupCpuTicks(pid_) * 1000000LL / sysconf(_SC_CLK_TCK);
+    kill(-pid_, SIGKILL);
+
+    cpu_time_usec += usage_.ru_utime.tv_sec * 1000000LL + usage_.ru_utime.tv_usec;
+    usage_.ru_utime.tv_sec = cpu_time_usec / 1000000;
+    usage_.ru_utime.tv_usec = cpu_time_usec % 1000000;
+}
+
+}
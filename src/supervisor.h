@@ -0,0 +1,92 @@
+#ifndef SUPERVISOR_H
+#define SUPERVISOR_H
+
+#include <chrono>
+#include <string>
+#include <string_view>
+
+#include <sys/resource.h>
+#include <sys/types.h>
+
+#include "buffer_pool.h"
+#include "hash.h"
+#include "sampling_profiler.h"
+
+#include "execution_result.h"
+
+namespace oj {
+
+struct ExpectedOutput {
+    size_t           size;
+    uint64_t         raw_hash;
+    uint64_t         normalized_hash;
+    bool             is_whitespace_insensitive;
+    std::string_view answer;
+};
+
+class Supervisor {
+public:
+    ~Supervisor();
+    Supervisor(pid_t pid, BufferPool& buffer_pool, int sample_interval_ms = 10, size_t max_samples = 256);
+    Supervisor(const Supervisor& other) = delete;
+    Supervisor(Supervisor&& other) = delete;
+
+    Supervisor& operator=(const Supervisor& other) = delete;
+    Supervisor& operator=(Supervisor&& other) = delete;
+
+    void                 SetWallTimeLimit(int time_limit_sec, int time_limit_usec);
+    void                 SetExpectedOutput(const ExpectedOutput& expected_output);
+    void                 SetSamplingProfiler(SamplingProfiler& sampling_profiler);
+    int                  Run(int input_fd, const std::string& input, int output_fd, std::string& output);
+
+    const rusage&        usage() const;
+    const MemoryProfile& memory_profile() const;
+    long long            wall_time_usec() const;
+    bool                 is_wall_time_limit_exceeded() const;
+    bool                 is_output_matched() const;
+    uint64_t             output_hash() const;
+    size_t               input_bytes() const;
+    size_t               output_bytes() const;
+
+private:
+    bool    HasExited() const;
+    void    KillOnDeadline();
+    void    Sample();
+    void    AppendSample(const MemorySample& sample);
+    void    Reap();
+    ssize_t Drain(int fd, Buffer& capture, size_t& captured);
+    void    Hash(const char* data, size_t size);
+    void    Compare(size_t& captured, const char* data);
+
+    pid_t                                 pid_;
+    BufferPool&                           buffer_pool_;
+    int                                   sample_interval_ms_;
+    size_t                                max_samples_;
+    int                                   pidfd_;
+    int                                   timerfd_;
+    int                                   deadline_fd_;
+    int                                   status_fd_;
+    bool                                  is_reaped_;
+    bool                                  is_wall_time_limit_exceeded_;
+    int                                   status_;
+    std::chrono::steady_clock::time_point start_;
+    long long                             wall_time_usec_;
+    MemorySample                          bucket_;
+    size_t                                bucket_size_;
+    size_t                                stride_;
+    rusage                                usage_;
+    MemoryProfile                         memory_profile_;
+    bool                                  is_hashing_;
+    bool                                  is_output_matched_;
+    bool                                  is_diverged_;
+    size_t                                matched_bytes_;
+    ExpectedOutput                        expected_output_;
+    OutputHasher                          output_hasher_;
+    SamplingProfiler*                     sampling_profiler_;
+    size_t                                input_bytes_;
+    size_t                                output_bytes_;
+};
+
+}
+
+#endif
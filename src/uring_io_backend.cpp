@@ -0,0 +1,253 @@
+#include "uring_io_backend.h"
+
+#ifdef OJ_HAVE_IO_URING
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <system_error>
+#include <utility>
+
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+namespace oj {
+
+UringIoBackend::~UringIoBackend() {
+    Close();
+}
+
+UringIoBackend::UringIoBackend(unsigned queue_depth)
+    : ring_fd_(-1),
+      params_{},
+      sq_ring_(nullptr),
+      sq_ring_size_(0),
+      cq_ring_(nullptr),
+      cq_ring_size_(0),
+      sqes_(nullptr),
+      sqes_size_(0),
+      to_submit_(0),
+      in_flight_(0),
+      syscalls_(0) {
+    ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, queue_depth, &params_));
+    if (ring_fd_ == -1) {
+        throw std::system_error(errno, std::generic_category(), "ERROR::UringIoBackend: Failed to set up an io_uring instance.");
+    }
+
+    sq_ring_size_ = params_.sq_off.array + params_.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params_.cq_off.cqes + params_.cq_entries * sizeof(io_uring_cqe);
+    if ((params_.features & IORING_FEAT_SINGLE_MMAP) != 0) {
+        sq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+        cq_ring_size_ = sq_ring_size_;
+    }
+
+    sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+    if (sq_ring_ == MAP_FAILED) {
+        int error = errno;
+        sq_ring_ = nullptr;
+        Close();
+        throw std::system_error(error, std::generic_category(), "ERROR::UringIoBackend: Failed to map a submission ring.");
+    }
+
+    if ((params_.features & IORING_FEAT_SINGLE_MMAP) != 0) {
+        cq_ring_ = sq_ring_;
+    } else {
+        cq_ring_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+        if (cq_ring_ == MAP_FAILED) {
+            int error = errno;
+            cq_ring_ = nullptr;
+            Close();
+            throw std::system_error(error, std::generic_category(), "ERROR::UringIoBackend: Failed to map a completion ring.");
+        }
+    }
+
+    sqes_size_ = params_.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        int error = errno;
+        Close();
+        throw std::system_error(error, std::generic_category(), "ERROR::UringIoBackend: Failed to map submission entries.");
+    }
+    sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+    char* sq_ring = static_cast<char*>(sq_ring_);
+    sq_head_ = reinterpret_cast<unsigned*>(sq_ring + params_.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned*>(sq_ring + params_.sq_off.tail);
+    sq_mask_ = reinterpret_cast<unsigned*>(sq_ring + params_.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned*>(sq_ring + params_.sq_off.array);
+
+    char* cq_ring = static_cast<char*>(cq_ring_);
+    cq_head_ = reinterpret_cast<unsigned*>(cq_ring + params_.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq_ring + params_.cq_off.tail);
+    cq_mask_ = reinterpret_cast<unsigned*>(cq_ring + params_.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(cq_ring + params_.cq_off.cqes);
+}
+
+void UringIoBackend::Submit(IoRequest request) {
+    while (in_flight_ >= params_.cq_entries) {
+        Poll(-1);
+    }
+    if (to_submit_ == params_.sq_entries) {
+        Enter(to_submit_, 0, 0);
+    }
+
+    uint32_t slot;
+    if (free_slots_.empty()) {
+        slot = static_cast<uint32_t>(slots_.size());
+        slots_.push_back(std::move(request));
+    } else {
+        slot = free_slots_.back();
+        free_slots_.pop_back();
+        slots_[slot] = std::move(request);
+    }
+    const IoRequest& submitted = slots_[slot];
+
+    unsigned tail = *sq_tail_;
+    unsigned index = tail & *sq_mask_;
+    io_uring_sqe* sqe = &sqes_[index];
+    *sqe = {};
+
+    int buffer_index = FindRegisteredBuffer(submitted.data, submitted.size);
+    bool is_read = submitted.operation == IoRequest::Operation::READ;
+    if (buffer_index != -1) {
+        sqe->opcode = is_read ? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+        sqe->buf_index = static_cast<uint16_t>(buffer_index);
+    } else {
+        sqe->opcode = is_read ? IORING_OP_READ : IORING_OP_WRITE;
+    }
+    sqe->fd = submitted.fd;
+    sqe->addr = reinterpret_cast<uint64_t>(submitted.data);
+    sqe->len = static_cast<uint32_t>(submitted.size);
+    sqe->off = static_cast<uint64_t>(submitted.offset);
+    sqe->user_data = slot;
+
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    ++to_submit_;
+    ++in_flight_;
+}
+
+size_t UringIoBackend::Poll(int timeout_ms) {
+    size_t completed = Reap();
+    unsigned min_complete = completed == 0 && in_flight_ != 0 && timeout_ms != 0 ? 1 : 0;
+    if (to_submit_ != 0 || min_complete != 0) {
+        Enter(to_submit_, min_complete, timeout_ms);
+    }
+    return completed + Reap();
+}
+
+void UringIoBackend::RegisterBuffers(const std::vector<iovec>& buffers) {
+    if (!registered_buffers_.empty()) {
+        ++syscalls_;
+        syscall(__NR_io_uring_register, ring_fd_, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+        registered_buffers_.clear();
+    }
+    if (buffers.empty()) {
+        return;
+    }
+
+    ++syscalls_;
+    if (syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_BUFFERS, buffers.data(), buffers.size()) == -1) {
+        throw std::system_error(errno, std::generic_category(), "ERROR::UringIoBackend: Failed to register buffers.");
+    }
+    registered_buffers_ = buffers;
+}
+
+size_t UringIoBackend::pending() const {
+    return in_flight_;
+}
+
+size_t UringIoBackend::syscalls() const {
+    return syscalls_;
+}
+
+const char* UringIoBackend::name() const {
+    return "io_uring";
+}
+
+void UringIoBackend::Close() {
+    if (sqes_ != nullptr) {
+        munmap(sqes_, sqes_size_);
+        sqes_ = nullptr;
+    }
+    if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+        munmap(cq_ring_, cq_ring_size_);
+    }
+    cq_ring_ = nullptr;
+    if (sq_ring_ != nullptr) {
+        munmap(sq_ring_, sq_ring_size_);
+        sq_ring_ = nullptr;
+    }
+    if (ring_fd_ != -1) {
+        close(ring_fd_);
+        ring_fd_ = -1;
+    }
+}
+
+int UringIoBackend::Enter(unsigned to_submit, unsigned min_complete, int timeout_ms) {
+    unsigned flags = min_complete != 0 ? IORING_ENTER_GETEVENTS : 0;
+    __kernel_timespec timeout = {};
+    io_uring_getevents_arg argument = {};
+    void* arg = nullptr;
+    size_t arg_size = _NSIG / 8;
+    if (min_complete != 0 && timeout_ms > 0 && (params_.features & IORING_FEAT_EXT_ARG) != 0) {
+        timeout.tv_sec = timeout_ms / 1000;
+        timeout.tv_nsec = timeout_ms % 1000 * 1000000L;
+        argument.ts = reinterpret_cast<uint64_t>(&timeout);
+        flags |= IORING_ENTER_EXT_ARG;
+        arg = &argument;
+        arg_size = sizeof(argument);
+    }
+
+    int submitted;
+    do {
+        ++syscalls_;
+        submitted = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_, to_submit, min_complete, flags, arg, arg_size));
+    } while (submitted == -1 && errno == EINTR);
+
+    if (submitted == -1) {
+        if (errno == ETIME || errno == EBUSY || errno == EAGAIN) {
+            return 0;
+        }
+        throw std::system_error(errno, std::generic_category(), "ERROR::UringIoBackend: Failed to enter an io_uring instance.");
+    }
+    to_submit_ -= static_cast<unsigned>(submitted);
+    return submitted;
+}
+
+size_t UringIoBackend::Reap() {
+    std::vector<std::pair<uint32_t, ssize_t>> completions;
+    unsigned head = *cq_head_;
+    unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    while (head != tail) {
+        const io_uring_cqe& cqe = cqes_[head & *cq_mask_];
+        completions.emplace_back(static_cast<uint32_t>(cqe.user_data), cqe.res);
+        ++head;
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+
+    for (const auto& [slot, result] : completions) {
+        std::function<void(ssize_t)> callback = std::move(slots_[slot].callback);
+        free_slots_.push_back(slot);
+        --in_flight_;
+        if (callback) {
+            callback(result);
+        }
+    }
+    return completions.size();
+}
+
+int UringIoBackend::FindRegisteredBuffer(const char* data, size_t size) const {
+    for (size_t i = 0; i < registered_buffers_.size(); ++i) {
+        const char* base = static_cast<const char*>(registered_buffers_[i].iov_base);
+        if (data >= base && data + size <= base + registered_buffers_[i].iov_len) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+}
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef URING_IO_BACKEND_H
+#define URING_IO_BACKEND_H
+
+#if __has_include(<linux/io_uring.h>)
+#define OJ_HAVE_IO_URING
+#endif
+
+#ifdef OJ_HAVE_IO_URING
+
+#include <cstdint>
+#include <vector>
+
+#include <linux/io_uring.h>
+
+#include "io_backend.h"
+
+namespace oj {
+
+class UringIoBackend : public IoBackend {
+public:
+    virtual ~UringIoBackend();
+    explicit UringIoBackend(unsigned queue_depth = 256);
+    UringIoBackend(const UringIoBackend& other) = delete;
+    UringIoBackend(UringIoBackend&& other) = delete;
+
+    UringIoBackend& operator=(const UringIoBackend& other) = delete;
+    UringIoBackend& operator=(UringIoBackend&& other) = delete;
+
+    virtual void        Submit(IoRequest request) override;
+    virtual size_t      Poll(int timeout_ms) override;
+    virtual void        RegisterBuffers(const std::vector<iovec>& buffers) override;
+
+    virtual size_t      pending() const override;
+    virtual size_t      syscalls() const override;
+    virtual const char* name() const override;
+
+private:
+    void                 Close();
+    int                  Enter(unsigned to_submit, unsigned min_complete, int timeout_ms);
+    size_t               Reap();
+    int                  FindRegisteredBuffer(const char* data, size_t size) const;
+
+    int                    ring_fd_;
+    io_uring_params        params_;
+    void*                  sq_ring_;
+    size_t                 sq_ring_size_;
+    void*                  cq_ring_;
+    size_t                 cq_ring_size_;
+    io_uring_sqe*          sqes_;
+    size_t                 sqes_size_;
+    unsigned*              sq_head_;
+    unsigned*              sq_tail_;
+    unsigned*              sq_mask_;
+    unsigned*              sq_array_;
+    unsigned*              cq_head_;
+    unsigned*              cq_tail_;
+    unsigned*              cq_mask_;
+    io_uring_cqe*          cqes_;
+    unsigned               to_submit_;
+    std::vector<IoRequest> slots_;
+    std::vector<uint32_t>  free_slots_;
+    std::vector<iovec>     registered_buffers_;
+    size_t                 in_flight_;
+    size_t                 syscalls_;
+};
+
+}
+
+#endif
+
+#endif
@@ -0,0 +1,267 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "verdict_store.h"
+
+namespace oj {
+
+namespace {
+
+constexpr char     MAGIC[8] = {'O', 'J', 'V', 'E', 'R', 'D', 'C', 'T'};
+constexpr uint32_t VERSION = 1;
+
+class FileLock {
+public:
+    explicit FileLock(int fd) : fd_(fd) {
+        while (flock(fd_, LOCK_EX) == -1) {
+            if (errno != EINTR) {
+                throw std::system_error(errno, std::generic_category(), "ERROR::VerdictStore: Failed to lock the store.");
+            }
+        }
+    }
+
+    ~FileLock() {
+        flock(fd_, LOCK_UN);
+    }
+
+private:
+    int fd_;
+};
+
+bool IsCommitted(const VerdictRecord& record) {
+    return __atomic_load_n(&record.committed, __ATOMIC_ACQUIRE) != 0;
+}
+
+}
+
+VerdictStore::~VerdictStore() {
+    if (data_ != nullptr) {
+        munmap(data_, HEADER_SIZE + max_records_ * sizeof(VerdictRecord));
+    }
+    if (fd_ != -1) {
+        close(fd_);
+    }
+}
+
+VerdictStore::VerdictStore(const std::filesystem::path& file, size_t max_records)
+    : file_(file),
+      fd_(-1),
+      max_records_(max_records),
+      data_(nullptr),
+      header_(nullptr),
+      records_(nullptr),
+      capacity_(0),
+      indexed_(0) {
+    fd_ = open(file_.string().c_str(), O_RDWR | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (fd_ == -1) {
+        throw std::system_error(errno, std::generic_category(), "ERROR::VerdictStore: Failed to open a file " + file_.string() + ".");
+    }
+
+    void* data = mmap(nullptr, HEADER_SIZE + max_records_ * sizeof(VerdictRecord), PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (data == MAP_FAILED) {
+        int error = errno;
+        close(fd_);
+        fd_ = -1;
+        throw std::system_error(error, std::generic_category(), "ERROR::VerdictStore: Failed to map a file " + file_.string() + ".");
+    }
+    data_ = static_cast<char*>(data);
+    header_ = reinterpret_cast<Header*>(data_);
+    records_ = reinterpret_cast<VerdictRecord*>(data_ + HEADER_SIZE);
+
+    try {
+        FileLock lock(fd_);
+        struct stat status;
+        if (fstat(fd_, &status) == -1) {
+            throw std::system_error(errno, std::generic_category(), "ERROR::VerdictStore: Failed to stat a file " + file_.string() + ".");
+        }
+
+        size_t size = static_cast<size_t>(status.st_size);
+        if (size < HEADER_SIZE) {
+            size = HEADER_SIZE + std::min(GROWTH_RECORDS, max_records_) * sizeof(VerdictRecord);
+            if (ftruncate(fd_, size) == -1) {
+                throw std::system_error(errno, std::generic_category(), "ERROR::VerdictStore: Failed to grow a file " + file_.string() + ".");
+            }
+            memcpy(header_->magic, MAGIC, sizeof(MAGIC));
+            header_->version = VERSION;
+            header_->record_size = sizeof(VerdictRecord);
+            header_->next.store(0);
+        } else if (memcmp(header_->magic, MAGIC, sizeof(MAGIC)) != 0 || header_->version != VERSION || header_->record_size != sizeof(VerdictRecord)) {
+            throw std::runtime_error("ERROR::VerdictStore: " + file_.string() + " isn't a verdict store.");
+        }
+        capacity_ = (size - HEADER_SIZE) / sizeof(VerdictRecord);
+    } catch (...) {
+        munmap(data_, HEADER_SIZE + max_records_ * sizeof(VerdictRecord));
+        close(fd_);
+        throw;
+    }
+
+    Refresh();
+}
+
+uint64_t VerdictStore::Append(VerdictRecord record) {
+    uint64_t sequence = header_->next.fetch_add(1);
+    if (sequence >= max_records_) {
+        throw std::runtime_error("ERROR::VerdictStore: " + file_.string() + " is full.");
+    }
+    Reserve(sequence);
+
+    if (record.timestamp_usec == 0) {
+        auto now = std::chrono::system_clock::now().time_since_epoch();
+        record.timestamp_usec = std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+    }
+    record.sequence = sequence;
+    record.committed = 0;
+
+    VerdictRecord& slot = records_[sequence];
+    memcpy(&slot, &record, sizeof(record));
+    __atomic_store_n(&slot.committed, 1, __ATOMIC_RELEASE);
+    return sequence;
+}
+
+uint64_t VerdictStore::Append (
+    uint64_t               submission_id,
+    uint64_t               problem_id,
+    uint32_t               test_index,
+    int                    status,
+    const ExecutionResult& result,
+    uint32_t               wall_time_usec
+) {
+    VerdictRecord record = {};
+    record.submission_id = submission_id;
+    record.problem_id = problem_id;
+    record.test_index = test_index;
+    record.status = status;
+    record.cpu_time_usec = static_cast<uint32_t>(result.elapsed_time_sec() * 1000000LL + result.elapsed_time_usec());
+    record.wall_time_usec = wall_time_usec;
+    record.memory_kb = static_cast<uint32_t>(result.memory_usage());
+    record.startup_time_usec = static_cast<uint32_t>(result.startup_time_usec());
+    return Append(record);
+}
+
+void VerdictStore::Flush() {
+    if (msync(data_, HEADER_SIZE + capacity_ * sizeof(VerdictRecord), MS_SYNC) == -1) {
+        throw std::system_error(errno, std::generic_category(), "ERROR::VerdictStore: Failed to flush " + file_.string() + ".");
+    }
+}
+
+std::optional<VerdictRecord> VerdictStore::Find(uint64_t submission_id, uint32_t test_index) {
+    Refresh();
+    std::shared_lock<std::shared_mutex> lock(index_mutex_);
+    auto sequences = by_submission_.find(submission_id);
+    if (sequences == by_submission_.end()) {
+        return std::nullopt;
+    }
+    for (auto sequence = sequences->second.rbegin(); sequence != sequences->second.rend(); ++sequence) {
+        if (records_[*sequence].test_index == test_index) {
+            return records_[*sequence];
+        }
+    }
+    return std::nullopt;
+}
+
+std::vector<VerdictRecord> VerdictStore::FindBySubmission(uint64_t submission_id) {
+    Refresh();
+    std::shared_lock<std::shared_mutex> lock(index_mutex_);
+    std::vector<VerdictRecord> records;
+    auto sequences = by_submission_.find(submission_id);
+    if (sequences != by_submission_.end()) {
+        for (uint64_t sequence : sequences->second) {
+            records.push_back(records_[sequence]);
+        }
+    }
+    return records;
+}
+
+std::vector<VerdictRecord> VerdictStore::FindByProblem(uint64_t problem_id) {
+    Refresh();
+    std::shared_lock<std::shared_mutex> lock(index_mutex_);
+    std::vector<VerdictRecord> records;
+    auto sequences = by_problem_.find(problem_id);
+    if (sequences != by_problem_.end()) {
+        for (uint64_t sequence : sequences->second) {
+            records.push_back(records_[sequence]);
+        }
+    }
+    return records;
+}
+
+size_t VerdictStore::size() const {
+    return std::min<uint64_t>(header_->next.load(), max_records_);
+}
+
+void VerdictStore::Reserve(uint64_t sequence) {
+    if (sequence < capacity_) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(grow_mutex_);
+    FileLock file_lock(fd_);
+    uint64_t capacity = ReadCapacity();
+    if (capacity <= sequence) {
+        capacity = std::min<uint64_t>((sequence / GROWTH_RECORDS + 1) * GROWTH_RECORDS, max_records_);
+        if (ftruncate(fd_, HEADER_SIZE + capacity * sizeof(VerdictRecord)) == -1) {
+            throw std::system_error(errno, std::generic_category(), "ERROR::VerdictStore: Failed to grow a file " + file_.string() + ".");
+        }
+    }
+    capacity_ = capacity;
+}
+
+uint64_t VerdictStore::ReadCapacity() const {
+    struct stat status;
+    if (fstat(fd_, &status) == -1) {
+        throw std::system_error(errno, std::generic_category(), "ERROR::VerdictStore: Failed to stat a file " + file_.string() + ".");
+    }
+    return std::min<uint64_t>((static_cast<size_t>(status.st_size) - HEADER_SIZE) / sizeof(VerdictRecord), max_records_);
+}
+
+void VerdictStore::Refresh() {
+    uint64_t next = std::min<uint64_t>(header_->next.load(), max_records_);
+    if (next > capacity_) {
+        std::lock_guard<std::mutex> lock(grow_mutex_);
+        uint64_t capacity = ReadCapacity();
+        if (capacity > capacity_) {
+            capacity_ = capacity;
+        }
+    }
+    {
+        std::shared_lock<std::shared_mutex> lock(index_mutex_);
+        if (indexed_ == next && pending_.empty()) {
+            return;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(index_mutex_);
+    std::vector<uint64_t> pending;
+    for (uint64_t sequence : pending_) {
+        if (IsCommitted(records_[sequence])) {
+            Index(sequence);
+        } else {
+            pending.push_back(sequence);
+        }
+    }
+    for (; indexed_ < next && indexed_ < capacity_; ++indexed_) {
+        if (IsCommitted(records_[indexed_])) {
+            Index(indexed_);
+        } else {
+            pending.push_back(indexed_);
+        }
+    }
+    pending_ = std::move(pending);
+}
+
+void VerdictStore::Index(uint64_t sequence) {
+    const VerdictRecord& record = records_[sequence];
+    by_submission_[record.submission_id].push_back(sequence);
+    by_problem_[record.problem_id].push_back(sequence);
+}
+
+}
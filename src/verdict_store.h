@@ -0,0 +1,96 @@
+#ifndef VERDICT_STORE_H
+#define VERDICT_STORE_H
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "execution_result.h"
+
+namespace oj {
+
+struct VerdictRecord {
+    static constexpr uint32_t SUBMISSION = 0xFFFFFFFF;
+
+    uint64_t submission_id;
+    uint64_t problem_id;
+    uint64_t timestamp_usec;
+    uint64_t sequence;
+    uint32_t test_index;
+    int32_t  status;
+    uint32_t cpu_time_usec;
+    uint32_t wall_time_usec;
+    uint32_t memory_kb;
+    uint32_t startup_time_usec;
+    uint32_t reserved;
+    uint32_t committed;
+};
+
+static_assert(sizeof(VerdictRecord) == 64, "VerdictRecord must stay 64 bytes.");
+
+class VerdictStore {
+public:
+    static constexpr size_t HEADER_SIZE = 4096;
+    static constexpr size_t GROWTH_RECORDS = 65536;
+
+    ~VerdictStore();
+    explicit VerdictStore(const std::filesystem::path& file, size_t max_records = 1UL << 28);
+    VerdictStore(const VerdictStore& other) = delete;
+    VerdictStore(VerdictStore&& other) = delete;
+
+    VerdictStore& operator=(const VerdictStore& other) = delete;
+    VerdictStore& operator=(VerdictStore&& other) = delete;
+
+    uint64_t                     Append(VerdictRecord record);
+    uint64_t                     Append (
+        uint64_t               submission_id,
+        uint64_t               problem_id,
+        uint32_t               test_index,
+        int                    status,
+        const ExecutionResult& result,
+        uint32_t               wall_time_usec = 0
+    );
+    void                         Flush();
+
+    std::optional<VerdictRecord> Find(uint64_t submission_id, uint32_t test_index);
+    std::vector<VerdictRecord>   FindBySubmission(uint64_t submission_id);
+    std::vector<VerdictRecord>   FindByProblem(uint64_t problem_id);
+
+    size_t                       size() const;
+
+private:
+    struct Header {
+        char                  magic[8];
+        uint32_t              version;
+        uint32_t              record_size;
+        std::atomic<uint64_t> next;
+    };
+
+    void     Reserve(uint64_t sequence);
+    uint64_t ReadCapacity() const;
+    void     Refresh();
+    void     Index(uint64_t sequence);
+
+    std::filesystem::path                               file_;
+    int                                                 fd_;
+    size_t                                              max_records_;
+    char*                                               data_;
+    Header*                                             header_;
+    VerdictRecord*                                      records_;
+    std::atomic<uint64_t>                               capacity_;
+    std::mutex                                          grow_mutex_;
+    std::shared_mutex                                   index_mutex_;
+    uint64_t                                            indexed_;
+    std::vector<uint64_t>                               pending_;
+    std::unordered_map<uint64_t, std::vector<uint64_t>> by_submission_;
+    std::unordered_map<uint64_t, std::vector<uint64_t>> by_problem_;
+};
+
+}
+
+#endif
@@ -0,0 +1,252 @@
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+
+#include "zygote.h"
+
+namespace oj {
+
+namespace {
+
+constexpr int ZYGOTE_FD = 3;
+
+constexpr const char* PYTHON_ZYGOTE = R"(
+import ctypes, os, resource, runpy, socket, sys, traceback
+
+for name in sys.argv[2].split(','):
+    try:
+        __import__(name)
+    except ImportError:
+        pass
+
+libc = ctypes.CDLL(None, use_errno=True)
+clone_flags = ctypes.c_long(0x00008000 | 17)
+sock = socket.socket(fileno=3)
+
+def run(program, time_limit_sec, time_limit_usec, memory_limit_mb, fds):
+    code = 1
+    try:
+        sock.close()
+        os.setpgid(0, 0)
+        if time_limit_sec or time_limit_usec:
+            soft = time_limit_sec + (1 if time_limit_usec > 0 else 0)
+            resource.setrlimit(resource.RLIMIT_CPU, (soft, soft + 1))
+        if memory_limit_mb:
+            resource.setrlimit(resource.RLIMIT_AS, (memory_limit_mb << 20, memory_limit_mb << 20))
+        os.dup2(fds[0], 0)
+        os.dup2(fds[1], 1)
+        for fd in fds:
+            if fd > 2:
+                os.close(fd)
+        if 'random' in sys.modules:
+            sys.modules['random'].seed()
+        sys.argv = [program]
+        sys.path[0] = os.path.dirname(os.path.abspath(program))
+        runpy.run_path(program, run_name='__main__')
+        code = 0
+    except SystemExit as e:
+        if e.code is None or isinstance(e.code, int):
+            code = e.code or 0
+        else:
+            print(e.code, file=sys.stderr)
+    except BaseException:
+        traceback.print_exc()
+    try:
+        sys.stdout.flush()
+    except BaseException:
+        code = code or 1
+    os._exit(code)
+
+sock.send(b'ready')
+while True:
+    msg, ancdata, _, _ = sock.recvmsg(4096, socket.CMSG_SPACE(2 * 4))
+    if not msg:
+        break
+    fds = []
+    for level, kind, data in ancdata:
+        if level == socket.SOL_SOCKET and kind == socket.SCM_RIGHTS:
+            fds += [int.from_bytes(data[i:i + 4], sys.byteorder) for i in range(0, len(data) - len(data) % 4, 4)]
+    program, time_limit_sec, time_limit_usec, memory_limit_mb = msg.decode().split('\0')
+    pid = libc.syscall(ctypes.c_long(int(sys.argv[1])), clone_flags, ctypes.c_long(0), ctypes.c_long(0), ctypes.c_long(0), ctypes.c_long(0))
+    if pid == 0:
+        run(program, int(time_limit_sec), int(time_limit_usec), int(memory_limit_mb), fds)
+    error = ctypes.get_errno()
+    for fd in fds:
+        os.close(fd)
+    sock.send(str(pid if pid > 0 else -error).encode())
+)";
+
+}
+
+const std::vector<std::string> Zygote::PYTHON_PRELOAD_MODULES = {
+    "array", "bisect", "collections", "copy", "decimal", "fractions", "functools", "heapq",
+    "io", "itertools", "math", "operator", "random", "re", "statistics", "string", "typing"
+};
+
+std::shared_ptr<Zygote> Zygote::CreatePython(const std::string& interpreter, const std::vector<std::string>& preload_modules) {
+    std::string modules;
+    for (const std::string& module : preload_modules) {
+        modules += (modules.empty() ? "" : ",") + module;
+    }
+    return std::make_shared<Zygote>(std::vector<std::string>{interpreter, "-c", PYTHON_ZYGOTE, std::to_string(SYS_clone), modules});
+}
+
+Zygote::~Zygote() {
+    Stop();
+}
+
+Zygote::Zygote(const std::vector<std::string>& command) : command_(command), pid_(-1), socket_(-1), boot_time_usec_(0) {
+    if (command_.empty()) {
+        throw std::invalid_argument("ERROR::Zygote: Command must not be empty.");
+    }
+    Start();
+}
+
+pid_t Zygote::Spawn (
+    const std::filesystem::path& program,
+    int                          time_limit_sec,
+    int                          time_limit_usec,
+    int                          memory_limit_mb,
+    int                          input_fd,
+    int                          output_fd
+) {
+    std::string request = std::filesystem::absolute(program).string();
+    for (int value : {time_limit_sec, time_limit_usec, memory_limit_mb}) {
+        request += '\0';
+        request += std::to_string(value);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    pid_t pid = Request(request, input_fd, output_fd);
+    if (pid == 0) {
+        Stop();
+        Start();
+        pid = Request(request, input_fd, output_fd);
+    }
+    if (pid == 0) {
+        throw std::runtime_error("ERROR::Zygote: Zygote exited while spawning " + program.string() + ".");
+    }
+    if (pid < 0) {
+        throw std::system_error(-pid, std::generic_category(), "ERROR::Zygote: Failed to spawn " + program.string() + ".");
+    }
+    return pid;
+}
+
+pid_t Zygote::pid() const {
+    return pid_;
+}
+
+long Zygote::boot_time_usec() const {
+    return boot_time_usec_;
+}
+
+const std::vector<std::string>& Zygote::command() const {
+    return command_;
+}
+
+void Zygote::Start() {
+    int sockets[2];
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sockets) == -1) {
+        throw std::system_error(errno, std::generic_category(), "ERROR::Zygote: Failed to open a socket pair.");
+    }
+
+    std::vector<char*> argv;
+    for (std::string& arg : command_) {
+        argv.push_back(arg.data());
+    }
+    argv.push_back(nullptr);
+
+    auto start = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid < 0) {
+        int error = errno;
+        close(sockets[0]);
+        close(sockets[1]);
+        throw std::system_error(error, std::generic_category(), "ERROR::Zygote: Failed to fork " + command_[0] + ".");
+    }
+    if (pid == 0) {
+        int null_fd = open("/dev/null", O_RDWR);
+        if (null_fd == -1 || dup2(null_fd, STDIN_FILENO) == -1 || dup2(null_fd, STDOUT_FILENO) == -1) {
+            _exit(EXIT_FAILURE);
+        }
+        if (sockets[1] == ZYGOTE_FD) {
+            fcntl(ZYGOTE_FD, F_SETFD, 0);
+        } else if (dup2(sockets[1], ZYGOTE_FD) == -1) {
+            _exit(EXIT_FAILURE);
+        }
+        execvp(argv[0], argv.data());
+        _exit(EXIT_FAILURE);
+    }
+
+    close(sockets[1]);
+    pid_ = pid;
+    socket_ = sockets[0];
+
+    char ready[8];
+    ssize_t bytes;
+    while ((bytes = recv(socket_, ready, sizeof(ready), 0)) == -1 && errno == EINTR) {}
+    if (bytes != 5 || memcmp(ready, "ready", 5) != 0) {
+        Stop();
+        throw std::runtime_error("ERROR::Zygote: Failed to start " + command_[0] + ".");
+    }
+    boot_time_usec_ = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void Zygote::Stop() {
+    if (socket_ != -1) {
+        close(socket_);
+        socket_ = -1;
+    }
+    if (pid_ != -1) {
+        kill(pid_, SIGKILL);
+        while (waitpid(pid_, nullptr, 0) == -1 && errno == EINTR) {}
+        pid_ = -1;
+    }
+}
+
+pid_t Zygote::Request(const std::string& request, int input_fd, int output_fd) {
+    iovec iov = {const_cast<char*>(request.data()), request.size()};
+
+    alignas(cmsghdr) char control[CMSG_SPACE(2 * sizeof(int))] = {};
+    msghdr message = {};
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    cmsghdr* header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_SOCKET;
+    header->cmsg_type = SCM_RIGHTS;
+    header->cmsg_len = CMSG_LEN(2 * sizeof(int));
+    int fds[2] = {input_fd, output_fd};
+    memcpy(CMSG_DATA(header), fds, sizeof(fds));
+
+    ssize_t bytes;
+    while ((bytes = sendmsg(socket_, &message, MSG_NOSIGNAL)) == -1 && errno == EINTR) {}
+    if (bytes == -1) {
+        if (errno == EPIPE || errno == ECONNRESET) {
+            return 0;
+        }
+        throw std::system_error(errno, std::generic_category(), "ERROR::Zygote: Failed to send a spawn request.");
+    }
+
+    char reply[32];
+    while ((bytes = recv(socket_, reply, sizeof(reply) - 1, 0)) == -1 && errno == EINTR) {}
+    if (bytes <= 0) {
+        return 0;
+    }
+    reply[bytes] = '\0';
+    return static_cast<pid_t>(strtol(reply, nullptr, 10));
+}
+
+}
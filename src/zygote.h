@@ -0,0 +1,58 @@
+#ifndef ZYGOTE_H
+#define ZYGOTE_H
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace oj {
+
+class Zygote {
+public:
+    static const std::vector<std::string> PYTHON_PRELOAD_MODULES;
+
+    static std::shared_ptr<Zygote> CreatePython (
+        const std::string&              interpreter = "python3",
+        const std::vector<std::string>& preload_modules = PYTHON_PRELOAD_MODULES
+    );
+
+    ~Zygote();
+    explicit Zygote(const std::vector<std::string>& command);
+    Zygote(const Zygote& other) = delete;
+    Zygote(Zygote&& other) = delete;
+
+    Zygote& operator=(const Zygote& other) = delete;
+    Zygote& operator=(Zygote&& other) = delete;
+
+    pid_t Spawn (
+        const std::filesystem::path& program,
+        int                          time_limit_sec,
+        int                          time_limit_usec,
+        int                          memory_limit_mb,
+        int                          input_fd,
+        int                          output_fd
+    );
+
+    pid_t                           pid() const;
+    long                            boot_time_usec() const;
+    const std::vector<std::string>& command() const;
+
+private:
+    void  Start();
+    void  Stop();
+    pid_t Request(const std::string& request, int input_fd, int output_fd);
+
+    std::vector<std::string> command_;
+    std::mutex               mutex_;
+    pid_t                    pid_;
+    int                      socket_;
+    long                     boot_time_usec_;
+};
+
+}
+
+#endif